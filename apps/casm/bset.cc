@@ -7,6 +7,58 @@
 
 namespace CASM {
 
+  /// \brief Generate the orbitree and basis functions from bspecs.json
+  SiteOrbitree make_bset(Structure &prim, const DirectoryStructure &dir, const ProjectSettings &set) {
+
+    SiteOrbitree tree(prim.lattice());
+
+    try {
+      jsonParser bspecs_json;
+      bspecs_json.read(dir.bspecs(set.bset()));
+      std::string basis_functions = bspecs_json["basis_functions"]["site_basis_functions"].get<std::string>();
+
+      std::cout << "Using " << basis_functions << " site basis functions." << std::endl << std::endl;
+      prim.fill_occupant_bases(basis_functions[0]);
+
+      std::cout << "Generating orbitree: \n";
+      tree = make_orbitree(prim, bspecs_json);
+      std::cout << "  DONE.\n\n";
+
+      tree.collect_basis_info(prim);
+      tree.generate_clust_bases();
+    }
+    catch(std::exception &e) {
+      std::cerr << "\n\nError reading: " << dir.bspecs(set.bset()) << std::endl
+                << "               " << e.what() << std::endl;
+      throw;
+    }
+
+    return tree;
+  }
+
+  /// \brief Source files and compiled libraries of the Clexulators with ECI folded in, printed by
+  ///        'casm bset --eci' for the current basis set
+  std::vector<fs::path> eci_clexulator_files(const DirectoryStructure &dir, const ProjectSettings &set) {
+
+    std::vector<fs::path> files;
+    for(const std::string &clex : dir.all_clex()) {
+      for(const std::string &calctype : dir.all_calctype()) {
+        for(const std::string &ref : dir.all_ref(calctype)) {
+          for(const std::string &eci : dir.all_eci(clex, calctype, ref, set.bset())) {
+            fs::path src = dir.eci_clexulator_src(set.name(), clex, calctype, ref, set.bset(), eci);
+            for(const std::string &ext : {".cc", ".o", ".so", ".so.hash"}) {
+              fs::path p = src.parent_path() / (set.eci_clexulator(clex) + ext);
+              if(fs::exists(p)) {
+                files.push_back(p);
+              }
+            }
+          }
+        }
+      }
+    }
+    return files;
+  }
+
 
   // ///////////////////////////////////////
   // 'clusters' function for casm
@@ -15,6 +67,7 @@ namespace CASM {
   int bset_command(int argc, char *argv[]) {
 
     po::variables_map vm;
+    std::string clex_name;
 
     /// Set command line options using boost program_options
     po::options_description desc("'casm bset' usage");
@@ -23,6 +76,7 @@ namespace CASM {
     ("update,u", "Update basis set")
     ("orbits", "Pretty-print orbit prototypes")
     ("clusters", "Pretty-print all clusters")
+    ("eci", po::value<std::string>(&clex_name), "Write a Clexulator with the current ECI of a cluster expansion folded in. Ex: --eci formation_energy")
     ("force,f", "Force overwrite");
 
     try {
@@ -38,7 +92,10 @@ namespace CASM {
         std::cout << "DESCRIPTION" << std::endl;
         std::cout << "    Generate and inspect cluster basis functions. A bspecs.json file should be available at\n"
                   << "        $ROOT/basis_set/$current_bset/bspecs.json\n"
-                  << "    Run 'casm format --bspecs' for an example file.\n\n" ;
+                  << "    Run 'casm format --bspecs' for an example file.\n\n"
+                  << "    With --eci, the basis set is regenerated and a Clexulator with fused kernels\n"
+                  << "    that use the ECI from the current eci.out is written next to eci.out. It is\n"
+                  << "    used to evaluate 'clex(...)' queries while it matches eci.out.\n\n";
 
         return 0;
       }
@@ -100,6 +157,12 @@ namespace CASM {
       lambda(dir.clexulator_so(set.name(), set.bset()));
       lambda(dir.prim_nlist(set.bset()));
 
+      // Clexulators with ECI folded in were printed with the old basis set
+      std::vector<fs::path> eci_clexulators = eci_clexulator_files(dir, set);
+      for(const fs::path &p : eci_clexulators) {
+        lambda(p);
+      }
+
       std::cout << "\n";
 
       if(any_existing_files) {
@@ -108,6 +171,9 @@ namespace CASM {
           fs::remove(dir.clexulator_src(set.name(), set.bset()));
           fs::remove(dir.clexulator_o(set.name(), set.bset()));
           fs::remove(dir.clexulator_so(set.name(), set.bset()));
+          for(const fs::path &p : eci_clexulators) {
+            fs::remove(p);
+          }
           
           std::cout << "\n***************************\n" << std::endl;
 
@@ -118,28 +184,7 @@ namespace CASM {
         }
       }
 
-      SiteOrbitree tree(prim.lattice());
-
-      try {
-        jsonParser bspecs_json;
-        bspecs_json.read(dir.bspecs(set.bset()));
-        std::string basis_functions = bspecs_json["basis_functions"]["site_basis_functions"].get<std::string>();
-
-        std::cout << "Using " << basis_functions << " site basis functions." << std::endl << std::endl;
-        prim.fill_occupant_bases(basis_functions[0]);
-
-        std::cout << "Generating orbitree: \n";
-        tree = make_orbitree(prim, bspecs_json);
-        std::cout << "  DONE.\n\n";
-
-        tree.collect_basis_info(prim);
-        tree.generate_clust_bases();
-      }
-      catch(std::exception &e) {
-        std::cerr << "\n\nError reading: " << dir.bspecs(set.bset()) << std::endl
-                  << "               " << e.what() << std::endl;
-        throw;
-      }
+      SiteOrbitree tree = make_bset(prim, dir, set);
 
       // -- write eci.in ----------------
       tree.write_eci_in(dir.eci_in(set.bset()).string());
@@ -173,6 +218,45 @@ namespace CASM {
       // -- clear correlations for all configurations
 
     }
+    else if(vm.count("eci")) {
+
+      DirectoryStructure dir(root);
+      ProjectSettings set(root);
+      Structure prim(read_prim(dir.prim()));
+
+      fs::path eci_out = dir.eci_out(clex_name, set.calctype(), set.ref(), set.bset(), set.eci());
+      if(!fs::exists(eci_out)) {
+        std::cerr << "ERROR: No 'eci.out' file found at: " << eci_out << std::endl;
+        return 1;
+      }
+      if(!fs::is_regular_file(dir.bspecs(set.bset()))) {
+        std::cout << "Error in 'casm bset': No basis set specifications file found at: " << dir.bspecs(set.bset()) << std::endl;
+        return 1;
+      }
+
+      std::cout << "\n***************************\n" << std::endl;
+
+      SiteOrbitree tree = make_bset(prim, dir, set);
+
+      Array<UnitCellCoord> nlist;
+      expand_nlist(prim, tree, nlist);
+
+      // supercell neighbor lists are constructed from prim_nlist.json, so it must not have changed
+      if(!fs::exists(dir.prim_nlist(set.bset())) || !(read_prim_nlist(dir.prim_nlist(set.bset())) == nlist)) {
+        std::cerr << "ERROR: The basis set does not match " << dir.prim_nlist(set.bset()) << ".\n"
+                  << "       Make sure to update your basis set with 'casm bset -u'.\n";
+        return 1;
+      }
+
+      // -- write Clexulator with ECI folded in
+      fs::path src = dir.eci_clexulator_src(set.name(), clex_name, set.calctype(), set.ref(), set.bset(), set.eci());
+      fs::ofstream outfile;
+      outfile.open(src);
+      print_clexulator(prim, tree, nlist, set.eci_clexulator(clex_name), ECIContainer(eci_out), outfile);
+      outfile.close();
+
+      std::cout << "Wrote: " << src << "\n\n";
+    }
     else if(vm.count("orbits") || vm.count("clusters")) {
       
       DirectoryStructure dir(root);
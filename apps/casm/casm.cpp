@@ -16,6 +16,7 @@
 #include "casm/core"
 
 #include "casm/app/DirectoryStructure.hh"
+#include "casm/system/TaskScheduler.hh"
 
 // include new casm tool header files here:
 #include "casm_functions.hh"
@@ -42,7 +43,7 @@ using namespace CASM;
 int print_casm_help(std::ostream &out) {
   out << "\n*** casm usage ***" << std::endl << std::endl;
 
-  out << "casm [--version] <command> [options] [args]" << std::endl << std::endl;
+  out << "casm [--version] [--threads N] <command> [options] [args]" << std::endl << std::endl;
   out << "available commands:" << std::endl;
   std::vector<std::string> subcom = {
     "  status",
@@ -82,6 +83,21 @@ int print_casm_help(std::ostream &out) {
 
 int main(int argc, char *argv[]) {
 
+  // Global options: '--threads N' sets the number of threads used by parallel algorithms,
+  //   overriding $CASM_NUM_THREADS. It is removed before the command parses its arguments.
+  if(argc > 2 && std::string(argv[1]) == "--threads") {
+    try {
+      set_num_threads(std::stol(argv[2]));
+    }
+    catch(std::exception &e) {
+      std::cerr << "ERROR: invalid argument for --threads: " << argv[2] << std::endl;
+      return 1;
+    }
+    argv[2] = argv[0];
+    argv += 2;
+    argc -= 2;
+  }
+
   // Collect command line arguments
   Array<std::string> args;
   bool help = false;
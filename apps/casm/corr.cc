@@ -7,6 +7,7 @@
 #include "casm_functions.hh"
 #include "casm/app/DirectoryStructure.hh"
 #include "casm/app/ProjectSettings.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
 
@@ -17,6 +18,7 @@ namespace CASM {
     po::variables_map vm;
     std::string outfile, cspecsfile;
     bool force;
+    Index num_threads;
 
     try {
 
@@ -26,7 +28,8 @@ namespace CASM {
       ("help,h", "Print help message")
       ("config,c", po::value<std::vector<fs::path> >(&config_path)->multitoken()->required(), "List of config_list files containing configurations for which to calculate correlations")
       ("output,o", po::value<std::string>(&outfile), "Name for output file")
-      ("force,f", po::value(&force)->zero_tokens(), "Overwrite output file");
+      ("force,f", po::value(&force)->zero_tokens(), "Overwrite output file")
+      ("threads", po::value<Index>(&num_threads), "Number of threads used to calculate correlations (default: 'casm --threads', $CASM_NUM_THREADS, or number of cores)");
 
       try {
         po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
@@ -140,14 +143,19 @@ namespace CASM {
     std::cout << "Calculate global scalar correlations using the orbitree in  " << dir.FCLUST(set.bset()) << std::endl << std::endl;
     //std::ofstream outstream(outfile.c_str());
     //primclex.generate_global_scalar_correlations();
+    std::vector<Configuration *> selected_config;
     PrimClex::config_iterator it = primclex.config_begin();
     for(; it != primclex.config_end(); ++it) {
       if(it->selected()) {
-        it->set_correlations(clexulator);
+        selected_config.push_back(&(*it));
       }
       // for(int i = 0; i < scel_index.size(); i++) {
       //   primclex.populate_global_correlations(scel_index[i], config_index[i]);
     }
+    if(vm.count("threads")) {
+      set_num_threads(num_threads);
+    }
+    set_correlations(selected_config, clexulator, global_scheduler());
     std::cout << "  DONE." << std::endl << std::endl;
 
     std::cout << "Update Configuration files..." << std::endl << std::endl;
@@ -116,7 +116,7 @@ namespace CASM {
     std::cout << "Make sure the hull gets generated and generate JSON object..." << std::endl << std::endl;
     jsonParser hulljson;
     ConfigSelection<false> config_select(primclex);
-    hulljson = update_hull_props(primclex, config_select.begin(), config_select.end());
+    hulljson = update_hull_props(primclex, config_select.begin(), config_select.end(), "ALL");
     std::cout << "  DONE." << std::endl << std::endl;
 
     std::cout << "Update Configuration files..." << std::endl << std::endl;
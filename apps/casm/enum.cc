@@ -4,6 +4,8 @@
 
 #include "casm_functions.hh"
 #include "casm/CASM_classes.hh"
+#include "casm/clex/ConfigEnumShards.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
 
@@ -19,6 +21,8 @@ namespace CASM {
 
     int min_vol = 1, max_vol;
     std::vector<std::string> scellname_list;
+    std::vector<Index> part;
+    Index num_threads;
     //double tol;
     COORD_TYPE coordtype = CASM::CART;
     po::variables_map vm;
@@ -33,7 +37,10 @@ namespace CASM {
     ("scellname,n", po::value<std::vector<std::string> >(&scellname_list)->multitoken(), "Enumerate configs for given supercells")
     ("all,a", "Enumerate configurations for all supercells")
     ("supercells,s", "Enumerate supercells")
-    ("configs,c", "Enumerate configurations");
+    ("configs,c", "Enumerate configurations")
+    ("checkpoint", "Enumerate configurations in parallel shards, saving completed shards so that an interrupted enumeration resumes where it stopped")
+    ("part", po::value<std::vector<Index> >(&part)->multitoken(), "With --checkpoint, 'I N': only enumerate part I of N of the shards, for running several processes")
+    ("threads", po::value<Index>(&num_threads), "Number of threads used with --checkpoint (default: 'casm --threads', $CASM_NUM_THREADS, or number of cores)");
 
     // currently unused...
     //("tol", po::value<double>(&tol)->default_value(CASM::TOL), "Tolerance used for checking symmetry")
@@ -53,6 +60,11 @@ namespace CASM {
         std::cout << "    Enumerate supercells and configurations\n";
         std::cout << "    - expects a PRIM file in the project root directory \n";
         std::cout << "    - if --min is given, then --max must be given \n";
+        std::cout << "    - with --checkpoint, progress is saved in .casm/enum. If 'casm enum' is  \n";
+        std::cout << "      interrupted, run it again with the same options to resume.           \n";
+        std::cout << "    - with --part I N, the configurations are not added until 'casm enum'    \n";
+        std::cout << "      is run again with --checkpoint but without --part, after all parts   \n";
+        std::cout << "      are finished.                                                        \n";
 
 
         return 0;
@@ -76,6 +88,11 @@ namespace CASM {
         std::cerr << "Error in 'casm enum'. If --supercells is given, --max must be given." << std::endl;
         return 1;
       }
+      if(vm.count("part") && (!vm.count("checkpoint") || part.size() != 2 || part[0] < 0 || part[0] >= part[1])) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm enum'. --part requires --checkpoint and 'I N', with 0 <= I < N." << std::endl;
+        return 1;
+      }
     }
     catch(po::error &e) {
       std::cerr << desc << std::endl;
@@ -106,6 +123,42 @@ namespace CASM {
     PrimClex primclex(root, std::cout);
     std::cout << "  DONE." << std::endl << std::endl;
 
+    if(vm.count("threads")) {
+      set_num_threads(num_threads);
+    }
+    if(!vm.count("part")) {
+      part = std::vector<Index>({0, 1});
+    }
+
+    // checkpoints to remove once the config list is written
+    std::vector<fs::path> merged;
+
+    // enumerate all occupations of 'scel', and print the number of configurations
+    auto enumerate = [&](Supercell & scel) {
+      std::cout << "  Enumerate configurations for " << scel.get_name() << " ... " << std::flush;
+      if(!vm.count("checkpoint")) {
+        scel.enumerate_all_occupation_configurations();
+        std::cout << scel.get_config_list().size() << " configs." << std::endl;
+        return;
+      }
+
+      fs::path checkpoint = primclex.dir().enum_checkpoint_dir(scel.get_name());
+      ConfigEnumShards shards(scel, checkpoint);
+      if(shards.num_complete()) {
+        std::cout << "resume with " << shards.num_complete() << " of " << shards.size() << " shards complete ... " << std::flush;
+      }
+      shards.enumerate(global_scheduler(), part[0], part[1]);
+
+      if(part[1] == 1) {
+        shards.merge();
+        merged.push_back(checkpoint);
+        std::cout << scel.get_config_list().size() << " configs." << std::endl;
+      }
+      else {
+        std::cout << shards.num_complete() << " of " << shards.size() << " shards complete." << std::endl;
+      }
+    };
+
     if(vm.count("supercells")) {
       std::cout << "\n***************************\n" << std::endl;
 
@@ -123,9 +176,7 @@ namespace CASM {
 
         std::cout << "Enumerate all configurations" << std::endl << std::endl;
         for(int j = 0; j < primclex.get_supercell_list().size(); j++) {
-          std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-          primclex.get_supercell(j).enumerate_all_occupation_configurations();
-          std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
+          enumerate(primclex.get_supercell(j));
         }
         std::cout << "  DONE." << std::endl << std::endl;
 
@@ -139,9 +190,7 @@ namespace CASM {
             if(primclex.get_supercell(j).volume() >= min_vol && primclex.get_supercell(j).volume() <= max_vol) {
               found_any = true;
 
-              std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-              primclex.get_supercell(j).enumerate_all_occupation_configurations();
-              std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
+              enumerate(primclex.get_supercell(j));
             }
           }
         }
@@ -157,9 +206,7 @@ namespace CASM {
 
             found_any = true;
 
-            std::cout << "  Enumerate configurations for " << primclex.get_supercell(index).get_name() << " ... " << std::flush;
-            primclex.get_supercell(index).enumerate_all_occupation_configurations();
-            std::cout << primclex.get_supercell(index).get_config_list().size() << " configs." << std::endl;
+            enumerate(primclex.get_supercell(index));
           }
         }
 
@@ -178,9 +225,19 @@ namespace CASM {
       //primclex.print_enum_info(enumfile.get_ostream());
       //std::cout << "Write ENUM" << std::endl;
 
-      std::cout << "Writing config_list..." << std::endl;
-      primclex.write_config_list();
-      std::cout << "  DONE" << std::endl;
+      // with --part, several processes may be running, and no configurations were added
+      if(part[1] == 1) {
+        std::cout << "Writing config_list..." << std::endl;
+        primclex.write_config_list();
+        std::cout << "  DONE" << std::endl;
+      }
+
+      for(const fs::path &checkpoint : merged) {
+        fs::remove_all(checkpoint);
+        if(fs::is_empty(checkpoint.parent_path())) {
+          fs::remove(checkpoint.parent_path());
+        }
+      }
     }
 
     std::cout << std::endl;
@@ -4,6 +4,7 @@
 
 #include "casm_functions.hh"
 #include "casm/CASM_classes.hh"
+#include "casm/casm_io/BinaryCorrelation.hh"
 
 namespace CASM {
 
@@ -21,7 +22,8 @@ namespace CASM {
       desc.add_options()
       ("help,h", "Print help message")
       ("config,c", po::value<fs::path>(&selection), "Selected configurations are used as training data for ECI fitting. If not specified, or 'MASTER' given, uses master list selection.")
-      ("force,f", "Overrwrite output file");
+      ("force,f", "Overrwrite output file")
+      ("binary", "Write the correlation matrix as a binary 'corr.in.bin' file, which eci_search memory-maps instead of parsing, rather than as text 'corr.in'");
 
       try {
         po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
@@ -72,6 +74,9 @@ namespace CASM {
     fs::path energy_file = dir.energy(set.clex(), set.calctype(), set.ref(), set.bset(), set.eci());
     fs::path eci_in_file = dir.eci_in(set.clex(), set.calctype(), set.ref(), set.bset(), set.eci());
     fs::path corr_in_file = dir.corr_in(set.clex(), set.calctype(), set.ref(), set.bset(), set.eci());
+    if(vm.count("binary")) {
+      corr_in_file = corr_in_file.string() + ".bin";
+    }
 
     if(!vm.count("force")) {
       if(fs::exists(energy_file)) {
@@ -141,7 +146,8 @@ namespace CASM {
 
     std::cout << "Calculating convex hull for selected configurations..." << std::endl << std::endl;
     jsonParser hulljson;
-    hulljson = update_hull_props(primclex, config_select.selected_config_begin(), config_select.selected_config_end());
+    std::string selection_name = (!vm.count("config") || selection == "MASTER") ? "MASTER" : fs::absolute(selection).string();
+    hulljson = update_hull_props(primclex, config_select.selected_config_begin(), config_select.selected_config_end(), selection_name);
     std::cout << "  DONE." << std::endl << std::endl;
 
     // -- write 'energy' file ----
@@ -161,7 +167,28 @@ namespace CASM {
     }
 
     // -- write 'corr.in' file ----
-    {
+    if(vm.count("binary")) {
+      Eigen::MatrixXd corr_matrix(N_values, N_corr);
+      Index i = 0;
+      for(auto it = config_select.selected_config_cbegin(); it != config_select.selected_config_cend(); ++it, ++i) {
+        Correlation corr = correlations(*it, clexulator);
+        for(Index j = 0; j < N_corr; j++) {
+          corr_matrix(i, j) = corr[j];
+        }
+      }
+
+      fs::ofstream sout;
+      sout.open(corr_in_file, std::ios::binary);
+      BinaryCorrelation::write(sout, N_values, N_corr, corr_matrix.data());
+      sout.close();
+      if(sout.fail()) {
+        std::cerr << "Error in 'casm fit': could not write " << corr_in_file << std::endl;
+        return 1;
+      }
+
+      std::cout << "Wrote: " << corr_in_file << "\n\n";
+    }
+    else {
       DataFormatter<Configuration> formatter;
       formatter.push_back(ConfigIO::corr(clexulator));
 
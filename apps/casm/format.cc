@@ -75,7 +75,8 @@ namespace CASM {
       std::cout << "                                                                    \n";
       std::cout << "    $ROOT/.casm                                                     \n";
       std::cout << "      project_settings.json                                         \n";
-      std::cout << "      config_list.json                                              \n";
+      std::cout << "      config_list.bin                                               \n";
+      std::cout << "      config_list.journal                                           \n";
       std::cout << "    $ROOT/                                                          \n";
       std::cout << "      prim.json                                                     \n";
       std::cout << "      (PRIM)                                                        \n";
@@ -255,6 +256,11 @@ Direct\n\
       std::cout << "project level once 'casm enum' has been used to generate            \n";
       std::cout << "configurations.                                                     \n";
       std::cout << "                                                                    \n";
+      std::cout << "The master list of configurations is now stored in the binary files \n";
+      std::cout << "$ROOT/.casm/config_list.bin and $ROOT/.casm/config_list.journal,     \n";
+      std::cout << "which hold the same data. An existing config_list.json is converted \n";
+      std::cout << "the first time the project is opened, and is no longer updated.     \n";
+      std::cout << "                                                                    \n";
       std::cout << "Contains basic information describing the configuration:            \n\n" <<
 
                 "supercells:supercell_name:configid:                                   \n" <<
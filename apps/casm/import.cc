@@ -5,6 +5,7 @@
 #include "casm_functions.hh"
 #include "casm/clex/ConfigMapping.hh"
 #include "casm/casm_io/FileSystemInterface.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
 
@@ -23,6 +24,7 @@ namespace CASM {
     COORD_TYPE coordtype = FRAC;
     double vol_tol(0.25);
     double lattice_weight(0.5);
+    Index num_threads;
     std::vector<fs::path> pos_paths;
     fs::path dft_path, batch_path;
     bool same_dir(false), no_import(true);
@@ -40,7 +42,8 @@ namespace CASM {
     ("rotate,r", "Rotate structure to be consistent with setting of PRIM")
     ("ideal,i", "Assume imported structures are unstrained (ideal) for faster importing. Can be slower if used on deformed structures, in which case more robust methods will be used")
     //("strict,s", "Request that symmetrically equivalent configurations be treated as distinct.")
-    ("data,d", "Attempt to extract calculation data from the enclosing directory of the structure files.");
+    ("data,d", "Attempt to extract calculation data from the enclosing directory of the structure files.")
+    ("threads", po::value<Index>(&num_threads), "Number of threads used to map structures (default: 'casm --threads', $CASM_NUM_THREADS, or number of cores)");
 
     try {
 
@@ -55,6 +58,7 @@ namespace CASM {
         std::cout << "DESCRIPTION" << std::endl;
         std::cout << "    Import structure specified by --pos. If it doesn't exist make a directory for it and copy data over" << std::endl;
         std::cout << "    If a *.json file is specified, it will be interpreted as a 'calc.properties.json' file." << std::endl;
+        std::cout << "    Structures are mapped in parallel, then imported in the order given." << std::endl;
         return 0;
       }
 
@@ -132,23 +136,18 @@ namespace CASM {
     PrimClex primclex(root, std::cout);
     std::cout << "  DONE." << std::endl << std::endl;
 
-    // import_map keeps track of mapping collisions -- only used if vm.count("data")
-    // import_map[config_name] gives a list all the configuration paths that mapped onto configuration 'config_name' :  import_map[config_name][i].first
-    //                         along with a list of the mapping properties {lattice_deformation, basis_deformation}  :  import_map[config_name][i].second
-    std::map<std::string, std::vector<std::pair<std::string, std::vector<double> > > > import_map;
-    std::vector<std::string > error_log;
-    Index n_unique(0);
-    // iterate over structure files
-    std::cout << "  Beginning import of " << pos_paths.size() << " configuration" << (pos_paths.size() > 1 ? "s" : "") << "...\n" << std::endl;
-    for(auto it = pos_paths.begin(); it != pos_paths.end(); ++it) {
-      if(it != pos_paths.begin())
-        std::cout << "\n***************************\n" << std::endl;
+    if(vm.count("threads")) {
+      set_num_threads(num_threads);
+    }
 
-      fs::path pos_path, import_path;
-
-      pos_path = fs::absolute(*it);
-      std::string imported_name;
-      BasicStructure<Site> import_struc;
+    // Read all structures first, so that they can be mapped in parallel.
+    //   read_error[i] is set if structure 'i' could not be read, otherwise it is mapped_index[i] in 'strucs'
+    std::vector<fs::path> full_paths(pos_paths.size());
+    std::vector<std::string> read_error(pos_paths.size());
+    std::vector<Index> mapped_index(pos_paths.size(), -1);
+    std::vector<BasicStructure<Site> > strucs;
+    for(Index i = 0; i < pos_paths.size(); i++) {
+      fs::path pos_path = fs::absolute(pos_paths[i]);
 
       // If user requested data import, try to get structural data from properties.calc.json, instead of POS, etc.
       // Since properties.calc.json would be used during 'casm update' to validate relaxation
@@ -167,13 +166,10 @@ namespace CASM {
         if(!dft_path.empty())
           pos_path = dft_path;
       }
+      full_paths[i] = pos_path;
 
-
-      //Import structure and make note of path
-      bool new_import = false;
-      jsonParser relax_data;
       try {
-
+        BasicStructure<Site> import_struc;
         if(pos_path.extension() == ".json" || pos_path.extension() == ".JSON") {
           from_json(simple_json(import_struc, "relaxed_"), jsonParser(pos_path));
         }
@@ -181,9 +177,51 @@ namespace CASM {
           fs::ifstream struc_stream(pos_path);
           import_struc.read(struc_stream);
         }
+        mapped_index[i] = strucs.size();
+        strucs.push_back(import_struc);
+      }
+      catch(std::exception &e) {
+        read_error[i] = e.what();
+      }
+    }
 
+    // Candidate supercells are shared by all structures, so each is only enumerated once
+    std::cout << "  Mapping " << strucs.size() << " structure" << (strucs.size() != 1 ? "s" : "") << "..." << std::endl;
+    MappingCandidates candidates(primclex, max(tol, 1e-12));
+    std::vector<ConfigMapping::MappedStructure> mapped = map_structures(strucs, candidates, !vm.count("ideal"), vm.count("rotate"), tol, lattice_weight, vol_tol);
+    std::cout << "  DONE." << std::endl << std::endl;
+
+    // import_map keeps track of mapping collisions -- only used if vm.count("data")
+    // import_map[config_name] gives a list all the configuration paths that mapped onto configuration 'config_name' :  import_map[config_name][i].first
+    //                         along with a list of the mapping properties {lattice_deformation, basis_deformation}  :  import_map[config_name][i].second
+    std::map<std::string, std::vector<std::pair<std::string, std::vector<double> > > > import_map;
+    std::vector<std::string > error_log;
+    Index n_unique(0);
+    // iterate over structure files, in order, adding the mapped configurations
+    std::cout << "  Beginning import of " << pos_paths.size() << " configuration" << (pos_paths.size() > 1 ? "s" : "") << "...\n" << std::endl;
+    for(auto it = pos_paths.begin(); it != pos_paths.end(); ++it) {
+      if(it != pos_paths.begin())
+        std::cout << "\n***************************\n" << std::endl;
+
+      Index i = it - pos_paths.begin();
+      fs::path pos_path = full_paths[i], import_path;
+      std::string imported_name;
+
+      //Import structure and make note of path
+      bool new_import = false;
+      jsonParser relax_data;
+      try {
+
+        if(!read_error[i].empty()) {
+          throw std::runtime_error(read_error[i]);
+        }
+
+        const ConfigMapping::MappedStructure &result(mapped[mapped_index[i]]);
+        if(!result.valid) {
+          throw std::runtime_error(result.error.empty() ? "Structure is incompatible with PRIM." : result.error);
+        }
 
-        if(import_structure_occupation(import_struc, primclex, imported_name, relax_data, !vm.count("ideal"), vm.count("rotate"), vm.count("strict"), tol, lattice_weight, vol_tol)) {
+        if(import_mapped_occupation(strucs[mapped_index[i]], result.configdof, result.lat, nullptr, primclex, imported_name, relax_data, vm.count("strict"), tol)) {
           std::cout << "  " << pos_path << "\nwas imported successfully as " << imported_name << std::endl << std::endl;
           n_unique++;
           new_import = true;
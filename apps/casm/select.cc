@@ -235,6 +235,9 @@ namespace CASM {
 
       std::cout << "Set selection: " << criteria << std::endl << std::endl;
 
+      // construct the evaluator for each 'clex(clex_name)' once, not for each configuration
+      ClexEvaluatorCache clex_cache;
+
       /// Prepare for calculating correlations. Maybe this should get put into Clexulator.
       if(fs::exists(dir.clexulator_src(set.name(), set.bset()))) {
         primclex.read_global_orbitree(dir.clust(set.bset()));
@@ -247,7 +250,7 @@ namespace CASM {
 
         if(!vm.count("output")) {
           for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it) {
-            it->set_selected(get_selection(criteria, *it, it->selected()));
+            it->set_selected(get_selection(criteria, *it, it->selected(), clex_cache));
           }
 
           std::cout << "  DONE." << std::endl << std::endl;
@@ -260,7 +263,7 @@ namespace CASM {
         else {
           ConfigSelection<true> config_select(primclex);
           for(auto it = config_select.config_begin(); it != config_select.config_end(); ++it) {
-            it.set_selected(get_selection(criteria, *it, it.selected()));
+            it.set_selected(get_selection(criteria, *it, it.selected(), clex_cache));
           }
 
           std::cout << "  DONE." << std::endl << std::endl;
@@ -272,7 +275,7 @@ namespace CASM {
       else {
         ConfigSelection<true> config_select(primclex, selection[0]);
         for(auto it = config_select.config_begin(); it != config_select.config_end(); ++it) {
-          it.set_selected(get_selection(criteria, *it, it.selected()));
+          it.set_selected(get_selection(criteria, *it, it.selected(), clex_cache));
         }
 
         bool force = vm.count("force");
@@ -100,12 +100,12 @@ namespace CASM {
   (units: number of primitive cells).                                  \n\
 - Execute: 'casm enum --configs --scellname NAME' to enumerate         \n\
   configurations for a particular supercell.                           \n\
-- Generated configurations are listed in the 'config_list.json' file.  \n\
-  This file should not usually be edited manually.                     \n\n";
+- Generated configurations are listed in the 'config_list.bin' and    \n\
+  'config_list.journal' files. These files should not be edited.       \n\n";
 
     std::cout <<
               "- See 'casm format' for a description and location of   \n\
-   the 'config_list.json' file.                                        \n\
+   the 'config_list.bin' and 'config_list.journal' files.              \n\
  - See 'casm format' for a description and location of                 \n\
    the data files related to a particular configuration.\n\n";
 
@@ -125,8 +125,9 @@ Instructions for volume relaxed VASP energies:                         \n\n\
 - Select which configurations to calculate properties for using the    \n\
   'casm select' command. Use 'casm select --set on' to select all      \n\
   configurations. By default, the 'is selected?' state of each         \n\
-  configuration is stored by CASM in the master config_list.json file, \n\
-  located in the hidden '.casm' directory. You can also save additional\n\
+  configuration is stored by CASM in the master config list files,     \n\
+  'config_list.bin' and 'config_list.journal', located in the hidden   \n\
+  '.casm' directory. You can also save additional                      \n\
   selection using the 'casm select -o' option to write a selection to a\n\
   file. Selections may be operated on to create new selections that    \n\
   are subsets, unions, or intersections of existing selections.        \n\
@@ -227,7 +227,7 @@ namespace CASM {
     else {
       std::cout <<  "Analyzed new data for " << num_updated << " configurations." << std::endl << std::endl;
       std::cout << "Generating references... " << std::endl << std::endl;
-      /// This also re-writes the config_list.json
+      /// This also updates the configuration database
       primclex.generate_references();
       std::cout << "  DONE" << std::endl << std::endl;
       if(bad_config_report.size() > 0) {
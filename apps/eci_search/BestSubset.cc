@@ -0,0 +1,371 @@
+/*
+ *  BestSubset.cc
+ */
+
+#ifndef BestSubset_CC
+#define BestSubset_CC
+
+#include <algorithm>
+#include <future>
+#include "BestSubset.hh"
+#include "Correlation.hh"
+#include "EnergySet.hh"
+
+// same as ECISet::check_if_singular, a set is singular if any singular value of A is < this
+const double BestSubset_singular_tol = 1.0e-4;	// CONSTANT
+
+// a cluster is treated as linearly dependent, in the root factorization, if its Cholesky pivot
+//   squared is less than this fraction of its diagonal Gram matrix element
+const double BestSubset_dependent_tol = 1.0e-12;	// CONSTANT
+
+BestSubset::BestSubset(const std::shared_ptr<const GramMatrix> &_gram):
+  gram(_gram), A(gram->get_A()), E(gram->get_E()), G(gram->get_G()), V(gram->get_V()), EtE(gram->get_EtE()),
+  N(0), K(0), Nnode(0), Nleaf(0) {
+
+  set_order();
+}
+
+//*******************************************************************************************
+
+void BestSubset::search(int _N, int _K, CASM::TaskScheduler &scheduler) {
+
+  N = _N;
+  K = _K;
+  best = std::priority_queue<Subset>();
+  result.clear();
+  Nnode = 0;
+  Nleaf = 0;
+
+  int M = order.size();
+  if(N < 1 || N > M || K < 1)
+    return;
+
+  // search the subtree of each first cluster as a separate task, with the same bounds as branch
+  Node node = root();
+  Nnode++;
+
+  std::vector<double> bound(M);
+  double rss = node.rss;
+  for(int k = 0; k < M; k++) {
+    rss -= node.z(k) * node.z(k);
+    bound[k] = std::max(rss, 0.0);
+  }
+
+  std::vector<std::future<void> > task;
+  for(int k = M - 1; k >= N - 1; k--) {
+    task.push_back(scheduler.submit([&, k]() {
+      if(prune(bound[k]))
+        return;
+      Node next;
+      if(N == 1) {
+        if(leaf_child(node, node.col[k], next))
+          leaf(next);
+      }
+      else if(child(node, k, next)) {
+        branch(next);
+      }
+    }));
+  }
+  for(int k = 0; k < task.size(); k++) {
+    task[k].get();
+  }
+
+  while(!best.empty()) {
+    result.push_back(best.top());
+    best.pop();
+  }
+  std::reverse(result.begin(), result.end());
+}
+
+//*******************************************************************************************
+
+int BestSubset::size() const {
+  return result.size();
+}
+
+const BestSubset::Subset &BestSubset::get(int i) const {
+  return result[i];
+}
+
+long int BestSubset::get_Nnode() const {
+  return Nnode;
+}
+
+long int BestSubset::get_Nleaf() const {
+  return Nleaf;
+}
+
+//*******************************************************************************************
+
+void BestSubset::set_order() {
+
+  // repeatedly choose the cluster that most reduces the rss, using the Schur complement of the
+  //   Gram matrix for the clusters already chosen
+  int M = G.cols();
+  Eigen::MatrixXd G_res = G;
+  Eigen::VectorXd V_res = V;
+  std::vector<bool> chosen(M, false);
+
+  order.clear();
+  while(true) {
+    int c = -1;
+    double max_reduction = 0.0;
+    for(int j = 0; j < M; j++) {
+      if(chosen[j] || G_res(j, j) <= BestSubset_dependent_tol * G(j, j))
+        continue;
+      double reduction = V_res(j) * V_res(j) / G_res(j, j);
+      if(c == -1 || reduction > max_reduction) {
+        c = j;
+        max_reduction = reduction;
+      }
+    }
+    if(c == -1)
+      break;
+
+    chosen[c] = true;
+    order.push_back(c);
+
+    Eigen::VectorXd l = G_res.col(c) / sqrt(G_res(c, c));
+    double z = V_res(c) / sqrt(G_res(c, c));
+    G_res -= l * l.transpose();
+    V_res -= l * z;
+  }
+
+  // linearly dependent clusters go last
+  for(int j = 0; j < M; j++) {
+    if(!chosen[j])
+      order.push_back(j);
+  }
+}
+
+//*******************************************************************************************
+
+BestSubset::Node BestSubset::root() const {
+
+  // Cholesky factor the Gram matrix of all clusters in reverse search order, as R^T*R
+  int M = order.size();
+  Node node;
+  node.m = 0;
+  node.rss = EtE;
+  node.R = Eigen::MatrixXd::Zero(M, M);
+  node.z = Eigen::VectorXd::Zero(M);
+  for(int k = 0; k < M; k++) {
+    node.col.push_back(order[M - 1 - k]);
+  }
+
+  for(int k = 0; k < M; k++) {
+    int c = node.col[k];
+
+    // forward substitution for R.col(k), skipping the zero rows of dependent clusters
+    double d2 = G(c, c);
+    double zk = V(c);
+    for(int i = 0; i < k; i++) {
+      if(node.R(i, i) == 0.0)
+        continue;
+      double sum = G(node.col[i], c);
+      for(int l = 0; l < i; l++) {
+        sum -= node.R(l, i) * node.R(l, k);
+      }
+      node.R(i, k) = sum / node.R(i, i);
+      d2 -= node.R(i, k) * node.R(i, k);
+      zk -= node.R(i, k) * node.z(i);
+    }
+
+    // a linearly dependent cluster does not reduce the rss
+    if(d2 > BestSubset_dependent_tol * G(c, c)) {
+      node.R(k, k) = sqrt(d2);
+      node.z(k) = zk / node.R(k, k);
+    }
+  }
+
+  return node;
+}
+
+//*******************************************************************************************
+
+void BestSubset::branch(const Node &node) {
+
+  Nnode++;
+
+  int n = node.col.size();
+  int m = node.m;
+  int need = N - m;
+
+  // bound[k] is the rss of S + node.col[m..k], which increases as k decreases
+  std::vector<double> bound(n);
+  double rss = node.rss;
+  for(int k = m; k < n; k++) {
+    rss -= node.z(k) * node.z(k);
+    bound[k] = std::max(rss, 0.0);
+  }
+
+  // the first cluster in search order is last in node.col, and once one child is pruned the
+  //   rest are too
+  Node next;
+  for(int k = n - 1; k >= m + need - 1; k--) {
+    if(prune(bound[k]))
+      return;
+    if(need == 1) {
+      if(leaf_child(node, node.col[k], next))
+        leaf(next);
+    }
+    else if(child(node, k, next)) {
+      branch(next);
+    }
+  }
+}
+
+//*******************************************************************************************
+
+bool BestSubset::child(const Node &node, int k, Node &result) const {
+
+  // move column k to position m, dropping the columns after k
+  int m = node.m;
+  int n = k + 1;
+
+  result.col.resize(n);
+  for(int i = 0; i < m; i++) {
+    result.col[i] = node.col[i];
+  }
+  result.col[m] = node.col[k];
+  for(int i = m; i < k; i++) {
+    result.col[i + 1] = node.col[i];
+  }
+
+  Eigen::MatrixXd &R = result.R;
+  R.resize(n, n);
+  R.leftCols(m) = node.R.topLeftCorner(n, m);
+  R.col(m) = node.R.col(k).head(n);
+  R.rightCols(k - m) = node.R.block(0, m, n, k - m);
+  result.z = node.z.head(n);
+
+  // zero R.col(m) below the diagonal, from the bottom up
+  for(int i = k - 1; i >= m; i--) {
+    double a = R(i, m);
+    double b = R(i + 1, m);
+    if(b == 0.0)
+      continue;
+    double r = sqrt(a * a + b * b);
+    double c = a / r;
+    double s = b / r;
+    for(int l = m; l < n; l++) {
+      double x = R(i, l);
+      double y = R(i + 1, l);
+      R(i, l) = c * x + s * y;
+      R(i + 1, l) = -s * x + c * y;
+    }
+    double x = result.z(i);
+    double y = result.z(i + 1);
+    result.z(i) = c * x + s * y;
+    result.z(i + 1) = -s * x + c * y;
+    R(i + 1, m) = 0.0;
+  }
+
+  // the smallest singular value of A is <= each diagonal element of R
+  if(fabs(R(m, m)) < BestSubset_singular_tol)
+    return false;
+
+  result.m = m + 1;
+  result.rss = node.rss - result.z(m) * result.z(m);
+  return true;
+}
+
+//*******************************************************************************************
+
+bool BestSubset::leaf_child(const Node &node, int clust, Node &result) const {
+
+  int m = node.m;
+  Eigen::VectorXd g(m);
+  for(int i = 0; i < m; i++) {
+    g(i) = G(node.col[i], clust);
+  }
+  Eigen::VectorXd r = node.R.topLeftCorner(m, m).transpose().triangularView<Eigen::Lower>().solve(g);
+  double d2 = G(clust, clust) - r.squaredNorm();
+
+  // the smallest singular value of A is <= each diagonal element of R
+  if(!(d2 > 0.0) || sqrt(d2) < BestSubset_singular_tol)
+    return false;
+
+  result.col.assign(node.col.begin(), node.col.begin() + m);
+  result.col.push_back(clust);
+  result.m = m + 1;
+  result.R = Eigen::MatrixXd::Zero(m + 1, m + 1);
+  result.R.topLeftCorner(m, m) = node.R.topLeftCorner(m, m);
+  result.R.col(m).head(m) = r;
+  result.R(m, m) = sqrt(d2);
+  result.z.resize(m + 1);
+  result.z.head(m) = node.z.head(m);
+  result.z(m) = (V(clust) - r.dot(node.z.head(m))) / result.R(m, m);
+  result.rss = node.rss - result.z(m) * result.z(m);
+  return true;
+}
+
+//*******************************************************************************************
+
+void BestSubset::leaf(const Node &node) {
+
+  if(prune(node.rss))
+    return;
+
+  Nleaf++;
+
+  int Nstruct = E.size();
+  int m = node.m;
+  const Eigen::MatrixXd &R = node.R;
+
+  // same criteria as IncrementalFit::check_if_singular
+  for(int k = 0; k < m; k++)
+    if(fabs(R(k, k)) < BestSubset_singular_tol)
+      return;
+  Eigen::MatrixXd Rinv = R.triangularView<Eigen::Upper>().solve(Eigen::MatrixXd::Identity(m, m));
+  if(1.0 / Rinv.norm() < BestSubset_singular_tol) {
+    Eigen::VectorXd S = Eigen::JacobiSVD<Eigen::MatrixXd>(R).singularValues();
+    for(int k = 0; k < S.size(); k++)
+      if(fabs(S(k)) < BestSubset_singular_tol)
+        return;
+  }
+
+  Eigen::MatrixXd AS(Nstruct, m);
+  for(int k = 0; k < m; k++) {
+    AS.col(k) = A.col(node.col[k]);
+  }
+
+  // ECI = R^-1*z, and X_i*((X^T*X)^-1)*X_i^T = |R^-T*X_i^T|^2
+  Eigen::VectorXd ECI = R.triangularView<Eigen::Upper>().solve(node.z);
+  Eigen::VectorXd Err = AS * ECI - E;
+  Eigen::MatrixXd W = Rinv.transpose() * AS.transpose();
+
+  Subset subset;
+  double rms = 0.0;
+  double cv = 0.0;
+  for(int i = 0; i < Nstruct; i++) {
+    rms += Err(i) * Err(i);
+    cv += BP::sqr(Err(i) / (1.0 - W.col(i).squaredNorm()));
+  }
+  subset.rms = sqrt(rms / Nstruct);
+  subset.cv = sqrt(cv / Nstruct);
+  subset.clust = node.col;
+  std::sort(subset.clust.begin(), subset.clust.end());
+
+  std::lock_guard<std::mutex> lock(best_mutex);
+  if(best.size() < K) {
+    best.push(subset);
+  }
+  else if(subset.cv < best.top().cv) {
+    best.pop();
+    best.push(subset);
+  }
+}
+
+//*******************************************************************************************
+
+bool BestSubset::prune(double rss) const {
+  std::lock_guard<std::mutex> lock(best_mutex);
+  if(best.size() < K)
+    return false;
+
+  // cv >= rms >= sqrt(rss/Nstruct), allowing for round-off in rss
+  return sqrt(std::max(rss, 0.0) / E.size()) * (1.0 - 1.0e-8) >= best.top().cv;
+}
+
+#endif // BestSubset_CC
@@ -0,0 +1,138 @@
+/*
+ *  BestSubset.hh
+ */
+
+#ifndef BestSubset_HH
+#define BestSubset_HH
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "casm/external/Eigen/Dense"
+#include "casm/system/TaskScheduler.hh"
+#include "GramMatrix.hh"
+
+// This class finds the K ECISets with N eci that have the lowest cv score, exactly, without
+//   fitting every combination, using a leaps-and-bounds style branch-and-bound search.
+//
+//   The search tree is over clusters in a fixed order: a node is a set S of clusters that are
+//   on, and its subtree contains every set S + (N - |S| clusters that come after the last
+//   cluster of S). Because
+//
+//     cv >= rms,  since the LOOCV residual e_i/(1 - h_i) has 0 <= h_i <= 1, and
+//     rms(subset) >= rms(any superset),
+//
+//   rms(S + all clusters after S) is a lower bound on the cv score of every set in the
+//   subtree, and the subtree is skipped if that is not better than the K-th best cv found
+//   so far.
+//
+//   Each node keeps the triangular factor R, and z = Q^T*E, of its clusters followed by the
+//   remaining clusters in reverse order, so the bounds for all of its children are partial
+//   sums of z^2. The factor of a child is the factor of its parent, truncated after the child's
+//   new cluster, with that column moved forward to follow S using Givens rotations, which
+//   costs O(n^2) rather than the O(n^3) of a new factorization. The factor for the root is
+//   found from the Cholesky factorization of the Gram matrix A^T*A, from a GramMatrix that may
+//   be shared with other fitters, so only the leaves that survive the bound touch the
+//   correlation matrix, to calculate the cv score.
+//
+//   Clusters are ordered by greedy forward selection, so that the most important clusters
+//   come first and good sets are found early. A set is singular by the same criteria as
+//   ECISet::fit, and since adding clusters can only decrease the smallest singular value,
+//   subtrees below a singular set are skipped.
+//
+//   The subtrees of the first cluster are searched in parallel, sharing the top-K list.
+//
+class BestSubset {
+
+public:
+
+  class Subset {
+  public:
+    // cluster indices, sorted
+    std::vector<int> clust;
+    double cv;
+    double rms;
+
+    bool operator<(const Subset &RHS) const {
+      return cv < RHS.cv;
+    }
+  };
+
+  BestSubset(const std::shared_ptr<const GramMatrix> &_gram);
+
+  // find the K best sets of N clusters, using 'scheduler' to search subtrees in parallel
+  void search(int N, int K, CASM::TaskScheduler &scheduler);
+
+  // results, sorted by increasing cv
+  int size() const;
+  const Subset &get(int i) const;
+
+  // number of nodes visited and leaves fit in the last search
+  long int get_Nnode() const;
+  long int get_Nleaf() const;
+
+private:
+
+  // a node of the search tree: its clusters col[0..m), followed by the clusters that may still be
+  //   added, in reverse order, with R and z such that A.col(col[i]) = Q*R.col(i) and z = Q^T*E,
+  //   and rss = |E|^2 - |z.head(m)|^2. Rows of R for linearly dependent clusters are zero.
+  class Node {
+  public:
+    std::vector<int> col;
+    int m;
+    Eigen::MatrixXd R;
+    Eigen::VectorXd z;
+    double rss;
+  };
+
+  std::shared_ptr<const GramMatrix> gram;
+
+  // weighted correlation matrix, only rows with non-zero weight, and weighted energy
+  const Eigen::MatrixXd &A;
+  const Eigen::VectorXd &E;
+
+  // Gram matrix, A^T*E, and E^T*E
+  const Eigen::MatrixXd &G;
+  const Eigen::VectorXd &V;
+  double EtE;
+
+  // search order of the clusters
+  std::vector<int> order;
+
+  int N;
+  int K;
+
+  // top-K results, largest cv on top
+  std::priority_queue<Subset> best;
+  std::vector<Subset> result;
+  mutable std::mutex best_mutex;
+
+  std::atomic<long int> Nnode;
+  std::atomic<long int> Nleaf;
+
+  // set 'order' by greedy forward selection
+  void set_order();
+
+  // the root node, with no clusters
+  Node root() const;
+
+  // search the subtree below 'node'
+  void branch(const Node &node);
+
+  // the child of 'node' that adds the cluster at node.col[k], return false if it is singular
+  bool child(const Node &node, int k, Node &result) const;
+
+  // the leaf that adds cluster 'clust' to 'node', only R and z for its N clusters
+  bool leaf_child(const Node &node, int clust, Node &result) const;
+
+  // fit a leaf and add it to the top-K list if it is good enough
+  void leaf(const Node &node);
+
+  // true if a subtree with rss lower bound 'rss' can not improve the top-K list
+  bool prune(double rss) const;
+
+};
+
+#endif // BestSubset_HH
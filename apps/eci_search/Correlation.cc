@@ -5,15 +5,19 @@
 #ifndef Correlation_CC
 #define Correlation_CC
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include "BP_Parse.hh"
 #include "Correlation.hh"
 #include "ECISet.hh"
 #include "EnergySet.hh"
 #include "Functions.hh"
+#include "casm/casm_io/BinaryCorrelation.hh"
 
 // Construct from 'corr' file
-Correlation::Correlation(std::string corr_in_filename) {
+Correlation::Correlation(std::string corr_in_filename) :
+  m_Nconfig(0), m_Nclust(0) {
 
   m_format = get_format_from_ext(corr_in_filename);
 
@@ -24,6 +28,7 @@ Correlation::Correlation(std::string corr_in_filename) {
     int Ncon;
     std::string s1;
     BP::BP_Vec<double> list;
+    BP::BP_Vec< BP::BP_Vec<double> > tmp;
 
     s1 = file.getline();
     Nclust = BP::next_int(s1);
@@ -38,34 +43,40 @@ Correlation::Correlation(std::string corr_in_filename) {
     s1 = file.getline();
 
     // data
+    tmp.capacity(Ncon);
     do {
       list = file.getline_double();
       if(list.size() != 0)
-        add(list);
+        tmp.add(list);
     }
     while(file.eof() == false);
 
     //std::cout << "val.size: " << val.size() << std::endl;
-    if(size() != Ncon) {
-      std::cout << "Error reading '" << corr_in_filename << "': stated #configurations == " << Ncon << ", but found #configurations == " << size() << std::endl;
+    if(tmp.size() != Ncon) {
+      std::cout << "Error reading '" << corr_in_filename << "': stated #configurations == " << Ncon << ", but found #configurations == " << tmp.size() << std::endl;
       exit(1);
     }
 
-    for(int i = 0; i < size(); i++) {
+    for(int i = 0; i < tmp.size(); i++) {
       //std::cout << "val[i].size(): " << val[i].size() << std::endl;
-      if((*this)[i].size() != Nclust) {
-        std::cout << "Error: the eci.in file stated #clusters == " << Nclust << ", but reading '" << corr_in_filename << "' found #clusters == " << (*this)[i].size() << " for configuration " << i << std::endl;
+      if(tmp[i].size() != Nclust) {
+        std::cout << "Error: the eci.in file stated #clusters == " << Nclust << ", but reading '" << corr_in_filename << "' found #clusters == " << tmp[i].size() << " for configuration " << i << std::endl;
         exit(1);
       }
     }
+
+    set_rows(tmp);
   }
   else if(m_format == "json") {
     CASM::jsonParser json(corr_in_filename);
     from_json(*this, json);
   }
+  else if(m_format == "binary") {
+    map_binary(corr_in_filename);
+  }
   else {
     std::cout << "Unexpected format option for Correlation constructor" << std::endl;
-    std::cout << "  Expected 'text' or 'json', but received: " << m_format << std::endl;
+    std::cout << "  Expected 'text', 'json', or 'binary', but received: " << m_format << std::endl;
     exit(1);
   }
 
@@ -76,21 +87,66 @@ std::string Correlation::format() const {
   return m_format;
 }
 
-// reduce this to only including the subset of clusters indicated by their indices in 'index_list'
-void Correlation::cluster_subset(BP::BP_Vec<int> &index_list) {
-  unsigned long int i, j;
+unsigned long int Correlation::size() const {
+  return m_Nconfig;
+}
 
-  BP::BP_Vec< BP::BP_Vec< double> > tmp = (*this);
+unsigned long int Correlation::get_Nclust() const {
+  return m_Nclust;
+}
 
-  for(i = 0; i < (*this).size(); i++)
-    (*this)[i].clear();
+Correlation::Row Correlation::operator[](unsigned long int i) const {
+  return Row(m_data.get() + i, m_Nconfig, m_Nclust);
+}
+
+Eigen::Map<const Eigen::MatrixXd> Correlation::matrix() const {
+  return Eigen::Map<const Eigen::MatrixXd>(m_data.get(), m_Nconfig, m_Nclust);
+}
 
-  for(i = 0; i < tmp.size(); i++) {
-    for(j = 0; j < index_list.size(); j++) {
-      (*this)[i].add(tmp[i][ index_list[j]]);
+void Correlation::select(Eigen::MatrixXd &A, const EnergySet &nrg_set, const std::vector<int> &clust) const {
+  unsigned long int i, j, in_i;
+
+  std::vector<unsigned long int> row;
+  std::vector<double> weight;
+  for(i = 0; i < nrg_set.size(); i++) {
+    if(nrg_set.get_weight(i) != 0) {
+      row.push_back(i);
+      weight.push_back(nrg_set.get_weight(i));
     }
   }
 
+  // gather each column, which is contiguous in the correlation matrix
+  A.resize(row.size(), clust.size());
+  for(j = 0; j < clust.size(); j++) {
+    const double *col = m_data.get() + clust[j] * m_Nconfig;
+    double *A_col = A.data() + j * A.rows();
+    for(in_i = 0; in_i < row.size(); in_i++) {
+      A_col[in_i] = weight[in_i] * col[row[in_i]];
+    }
+  }
+}
+
+void Correlation::select(Eigen::MatrixXd &A, const EnergySet &nrg_set) const {
+  std::vector<int> clust(m_Nclust);
+  for(unsigned long int j = 0; j < m_Nclust; j++)
+    clust[j] = j;
+  select(A, nrg_set, clust);
+}
+
+// reduce this to only including the subset of clusters indicated by their indices in 'index_list'
+void Correlation::cluster_subset(BP::BP_Vec<int> &index_list) {
+  unsigned long int j;
+
+  double *tmp = new double[m_Nconfig * index_list.size()];
+  for(j = 0; j < index_list.size(); j++) {
+    std::memcpy(tmp + j * m_Nconfig, m_data.get() + index_list[j] * m_Nconfig, m_Nconfig * sizeof(double));
+  }
+
+  m_data.reset(tmp, [](const double * p) {
+    delete [] p;
+  });
+  m_Nclust = index_list.size();
+
 }
 
 // write a 'corr' file
@@ -101,14 +157,14 @@ void Correlation::write(const std::string &filename, std::string format) const {
 
   if(format == "text") {
     unsigned long int i, j;
-    BP::BP_Write file(rm_json_ext(filename));
+    BP::BP_Write file(rm_bin_ext(rm_json_ext(filename)));
     file.newfile();
 
-    file << (*this)[0].size() << " # number of clusters" << std::endl;
-    file << (*this).size() << " # number of configurations" << std::endl;
+    file << m_Nclust << " # number of clusters" << std::endl;
+    file << m_Nconfig << " # number of configurations" << std::endl;
     file << "clusters" << std::endl;
     for(i = 0; i < size(); i++) {
-      for(j = 0; j < (*this)[i].size(); j++) {
+      for(j = 0; j < m_Nclust; j++) {
         file << "   " << (*this)[i][j] ;
       }
       file << "\n";
@@ -116,11 +172,21 @@ void Correlation::write(const std::string &filename, std::string format) const {
   }
   else if(format == "json") {
     CASM::jsonParser json;
-    to_json(*this, json).write(json_ext(filename));
+    to_json(*this, json).write(json_ext(rm_bin_ext(filename)));
+  }
+  else if(format == "binary") {
+    std::string bin_filename = bin_ext(rm_json_ext(filename));
+    std::ofstream file(bin_filename.c_str(), std::ios::binary);
+    CASM::BinaryCorrelation::write(file, m_Nconfig, m_Nclust, m_data.get());
+    file.close();
+    if(file.fail()) {
+      std::cout << "Error writing '" << bin_filename << "'" << std::endl;
+      exit(1);
+    }
   }
   else {
     std::cout << "Unexpected format option for Correlation constructor" << std::endl;
-    std::cout << "  Expected 'text' or 'json', but received: " << format << std::endl;
+    std::cout << "  Expected 'text', 'json', or 'binary', but received: " << format << std::endl;
     exit(1);
   }
 }
@@ -187,12 +253,63 @@ void Correlation::write_covar(const ECISet &eci_in, const EnergySet &nrg_set, co
 
 }
 
+BP::BP_Vec< BP::BP_Vec< double> > Correlation::rows() const {
+  BP::BP_Vec< BP::BP_Vec< double> > result(m_Nconfig, BP::BP_Vec<double>(m_Nclust, 0.0));
+  for(unsigned long int i = 0; i < m_Nconfig; i++) {
+    for(unsigned long int j = 0; j < m_Nclust; j++) {
+      result[i][j] = (*this)[i][j];
+    }
+  }
+  return result;
+}
+
+// private:
+
+void Correlation::map_binary(const std::string &corr_in_filename) {
+
+  std::uint64_t Nconfig, Nclust;
+  try {
+    m_data = CASM::BinaryCorrelation::map(corr_in_filename, Nconfig, Nclust);
+  }
+  catch(std::runtime_error &e) {
+    std::cout << "Error reading '" << corr_in_filename << "': " << e.what() << std::endl;
+    exit(1);
+  }
+
+  m_Nconfig = Nconfig;
+  m_Nclust = Nclust;
+}
+
+void Correlation::set_rows(const BP::BP_Vec< BP::BP_Vec< double> > &rows) {
+  unsigned long int i, j;
+
+  m_Nconfig = rows.size();
+  m_Nclust = (rows.size() == 0) ? 0 : rows[0].size();
+
+  double *tmp = new double[m_Nconfig * m_Nclust];
+  for(i = 0; i < m_Nconfig; i++) {
+    if(rows[i].size() != m_Nclust) {
+      std::cout << "Error in Correlation: found #clusters == " << rows[i].size() << " for configuration " << i << ", but #clusters == " << m_Nclust << " for configuration 0" << std::endl;
+      exit(1);
+    }
+    for(j = 0; j < m_Nclust; j++) {
+      tmp[i + j * m_Nconfig] = rows[i][j];
+    }
+  }
+
+  m_data.reset(tmp, [](const double * p) {
+    delete [] p;
+  });
+}
+
 CASM::jsonParser &to_json(const Correlation &corr, CASM::jsonParser &json) {
-  return to_json((BP::BP_Vec< BP::BP_Vec< double> > &) corr, json);
+  return to_json(corr.rows(), json);
 }
 
 void from_json(Correlation &corr, const CASM::jsonParser &json) {
-  from_json((BP::BP_Vec< BP::BP_Vec< double> > &) corr, json);
+  BP::BP_Vec< BP::BP_Vec< double> > tmp;
+  from_json(tmp, json);
+  corr.set_rows(tmp);
 }
 
 #endif // Correlation_CC
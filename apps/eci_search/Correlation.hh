@@ -5,7 +5,9 @@
 #ifndef Correlation_HH
 #define Correlation_HH
 
+#include <memory>
 #include <string>
+#include <vector>
 #include "jsonParser.hh"
 #include "BP_Vec.hh"
 #include "casm/external/Eigen/Dense"
@@ -13,13 +15,47 @@
 class ECISet;
 class EnergySet;
 
-class Correlation : public BP::BP_Vec< BP::BP_Vec< double> > {
-
-  /// detected input file format: "text" or "json"
+// The Nconfig x Nclust correlation matrix, stored as a single column-major array.
+//
+//   A "binary" file, as written by 'casm fit --binary' (see casm/casm_io/BinaryCorrelation.hh),
+//   is memory-mapped and used in place, so it is not parsed and only the pages that are used
+//   are read. "text" and "json" files are read into an array with the same layout.
+//
+//   The array is never modified, so copies share it. Fits get their weighted correlation matrix
+//   with 'select', which gathers the rows and columns being fit directly from the array.
+//
+class Correlation {
+
+  /// detected input file format: "text", "json", or "binary"
   std::string m_format;
 
+  // column-major correlation matrix, mapped or owned
+  std::shared_ptr<const double> m_data;
+  unsigned long int m_Nconfig;
+  unsigned long int m_Nclust;
+
 public:
 
+  // a row of the correlation matrix, so that corr[i][j] is the correlation of cluster j for
+  //   configuration i
+  class Row {
+    const double *m_ptr;
+    unsigned long int m_stride;
+    unsigned long int m_size;
+
+  public:
+    Row(const double *_ptr, unsigned long int _stride, unsigned long int _size) :
+      m_ptr(_ptr), m_stride(_stride), m_size(_size) {}
+
+    double operator[](unsigned long int j) const {
+      return m_ptr[j * m_stride];
+    }
+
+    unsigned long int size() const {
+      return m_size;
+    }
+  };
+
   //Correlation() {}
 
   // Construct from 'corr' file
@@ -27,6 +63,24 @@ public:
 
   std::string format() const;
 
+  // number of configurations
+  unsigned long int size() const;
+
+  // number of clusters
+  unsigned long int get_Nclust() const;
+
+  Row operator[](unsigned long int i) const;
+
+  // the whole correlation matrix, without copying
+  Eigen::Map<const Eigen::MatrixXd> matrix() const;
+
+  // set A to the correlation matrix for the configurations with non-zero weight in 'nrg_set',
+  //   with rows multiplied by their weight, and the clusters in 'clust', in that order
+  void select(Eigen::MatrixXd &A, const EnergySet &nrg_set, const std::vector<int> &clust) const;
+
+  // same, for all clusters
+  void select(Eigen::MatrixXd &A, const EnergySet &nrg_set) const;
+
   // reduce this to only including the subset of clusters indicated by their indices in 'index_list'
   void cluster_subset(BP::BP_Vec<int> &index_list);
 
@@ -38,6 +92,19 @@ public:
 
   // return a vector of 'a' values used for calculating LOOCV score
   BP::BP_Vec<double> cv_a(const Eigen::MatrixXd &C, const EnergySet &nrg_set) const;
+
+  // the correlation matrix as a list of rows
+  BP::BP_Vec< BP::BP_Vec< double> > rows() const;
+
+private:
+
+  // memory-map a binary file
+  void map_binary(const std::string &corr_in_filename);
+
+  // set from a list of rows, which must all have the same size
+  void set_rows(const BP::BP_Vec< BP::BP_Vec< double> > &rows);
+
+  friend void from_json(Correlation &corr, const CASM::jsonParser &json);
 };
 
 CASM::jsonParser &to_json(const Correlation &corr, CASM::jsonParser &json);
@@ -7,6 +7,7 @@
 
 #include "ECISet.hh"
 #include "Functions.hh"
+#include "IncrementalFit.hh"
 
 ECI::ECI(const CASM::jsonParser &json) {
   from_json(*this, json);
@@ -697,6 +698,12 @@ void ECISet::fit(const Correlation &_corr, const EnergySet &nrg_set, bool &_sing
   return;
 }
 
+void ECISet::fit(IncrementalFit &fitter, bool &_singular) {
+  // Same as fit(corr, nrg_set, _singular), but updates the factorization cached in 'fitter'
+  //   instead of refactoring, which is much faster when toggling clusters one at a time
+  fitter.fit(*this, _singular);
+}
+
 void ECISet::check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool &_singular) {
   fit(_corr, _nrg_set, _singular);
   double fitted_cv = cv;
@@ -740,32 +747,16 @@ void ECISet::check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool
   std::cout << "wLOOCV: " << sqrt(wsqr_sum / nrg_data.size()) << "  fitted_cv: " << fitted_cv << std::endl;
 }
 
-void *ECISet::fit_threaded(void *arg) {
-  ((ECISet *) arg)->fit();
-  return NULL;
-}
-
 void ECISet::set_correlation_matrix(Eigen::MatrixXd &A, const Correlation &_corr, const EnergySet &nrg_set) const {
   // set A to be the correlation matrix, including weights, and only the rows and columns being fit
-  // assumes A is already the right size
-
-  int i, j, in_i, in_j;
 
-  in_i = 0;
-  for(i = 0; i < nrg_set.size(); i++) {
-    if(nrg_set.get_weight(i) != 0) {
-      in_j = 0;
-      for(j = 0; j < _corr[i].size(); j++) {
-        if(this->get_weight(j) != 0) {
-          A(in_i, in_j) = nrg_set.get_weight(i) * _corr[i][j];
-          in_j++;
-        }
-      }
-      in_i++;
+  std::vector<int> clust;
+  for(int j = 0; j < _corr.get_Nclust(); j++) {
+    if(this->get_weight(j) != 0) {
+      clust.push_back(j);
     }
   }
-
-  //std::cout << " in_i: " << in_i << " in_j: " << in_j << std::endl;
+  _corr.select(A, nrg_set, clust);
 }
 
 // private:
@@ -13,6 +13,8 @@
 
 double UK = 1e20;
 
+class IncrementalFit;
+
 class ECI {
 public:
   int orbit;
@@ -218,9 +220,9 @@ public:
 
   void fit(const Correlation &_corr, const EnergySet &nrg_set, bool &_singular);
 
-  void check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool &_singular);
+  void fit(IncrementalFit &fitter, bool &_singular);
 
-  static void *fit_threaded(void *arg);
+  void check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool &_singular);
 
   void set_correlation_matrix(Eigen::MatrixXd &A, const Correlation &_corr, const EnergySet &nrg_set) const;
 
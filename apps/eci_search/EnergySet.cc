@@ -6,6 +6,7 @@
 #define EnergySet_CC
 
 #include "EnergySet.hh"
+#include "Correlation.hh"
 #include "Functions.hh"
 
 Energy::Energy(BP::BP_Vec<string> s_list) {
@@ -141,9 +142,15 @@ void EnergySet::calc_clex(const Correlation &corr, const ECISet &eci) {
   unsigned long int i, j;
   for(i = 0; i < size(); i++) {
     (*this)[i].Ef = 0;
-    for(j = 0; j < corr[i].size(); j++) {
-      (*this)[i].Ef += corr[i][j] * eci.get_value(j);
-      (*this)[i].dist_from_hull = 0.0;
+    (*this)[i].dist_from_hull = 0.0;
+  }
+
+  // the correlations for each cluster are contiguous, so loop over clusters first
+  Eigen::Map<const Eigen::MatrixXd> C = corr.matrix();
+  for(j = 0; j < C.cols(); j++) {
+    double value = eci.get_value(j);
+    for(i = 0; i < size(); i++) {
+      (*this)[i].Ef += C(i, j) * value;
     }
   }
 }
@@ -0,0 +1,79 @@
+/*
+ *  FitCache.cc
+ */
+
+#ifndef FitCache_CC
+#define FitCache_CC
+
+#include "FitCache.hh"
+#include "IncrementalFit.hh"
+
+FitCache::FitCache():
+  Nhit(0), Nmiss(0) {
+}
+
+//*******************************************************************************************
+
+bool FitCache::find(ECISet &eci, bool &singular) const {
+  std::string bit_string = eci.get_bit_string();
+  int i = shard_index(bit_string);
+
+  std::lock_guard<std::mutex> lock(shard_mutex[i]);
+  std::unordered_map<std::string, Entry>::const_iterator it = shard[i].find(bit_string);
+  if(it == shard[i].end()) {
+    Nmiss++;
+    return false;
+  }
+  Nhit++;
+  eci.set_state(it->second.state);
+  singular = it->second.singular;
+  return true;
+}
+
+//*******************************************************************************************
+
+void FitCache::insert(const ECISet &eci, bool singular) {
+  Entry entry;
+  entry.state = eci.get_state();
+  entry.singular = singular;
+  int i = shard_index(entry.state.bit_string);
+
+  std::lock_guard<std::mutex> lock(shard_mutex[i]);
+  shard[i][entry.state.bit_string] = entry;
+}
+
+//*******************************************************************************************
+
+void FitCache::fit(ECISet &eci, IncrementalFit &fitter, bool &singular) {
+  if(find(eci, singular))
+    return;
+  eci.fit(fitter, singular);
+  insert(eci, singular);
+}
+
+//*******************************************************************************************
+
+long int FitCache::size() const {
+  long int result = 0;
+  for(int i = 0; i < Nshard; i++) {
+    std::lock_guard<std::mutex> lock(shard_mutex[i]);
+    result += shard[i].size();
+  }
+  return result;
+}
+
+long int FitCache::get_Nhit() const {
+  return Nhit;
+}
+
+long int FitCache::get_Nmiss() const {
+  return Nmiss;
+}
+
+//*******************************************************************************************
+
+int FitCache::shard_index(const std::string &bit_string) const {
+  return std::hash<std::string>()(bit_string) % Nshard;
+}
+
+#endif // FitCache_CC
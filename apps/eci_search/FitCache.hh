@@ -0,0 +1,65 @@
+/*
+ *  FitCache.hh
+ */
+
+#ifndef FitCache_HH
+#define FitCache_HH
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "ECISet.hh"
+
+class IncrementalFit;
+
+// This class stores the results of fits, ECISetState and whether the fit was singular, by
+//   bit_string, so that an ECISet that was already fit does not need to be fit again.
+//
+//   It is shared by all the threads of a Population and kept for its lifetime, so GA children,
+//   direct and dfs minimization steps, and later searches on the same Population all reuse
+//   each other's fits. The ECI values are not stored, so an ECISet found in the cache has its
+//   cv, rms, and bit_string set, but not its ECI values.
+//
+//   The table is split into shards, each with its own mutex, so that threads rarely wait.
+//
+class FitCache {
+
+  class Entry {
+  public:
+    ECISetState state;
+    bool singular;
+  };
+
+  static const int Nshard = 64;	// CONSTANT
+
+  std::unordered_map<std::string, Entry> shard[Nshard];
+  mutable std::mutex shard_mutex[Nshard];
+
+  mutable std::atomic<long int> Nhit;
+  mutable std::atomic<long int> Nmiss;
+
+public:
+
+  FitCache();
+
+  // if 'eci' has already been fit, set its state and return true
+  bool find(ECISet &eci, bool &singular) const;
+
+  // store the current state of 'eci'
+  void insert(const ECISet &eci, bool singular);
+
+  // fit 'eci' using 'fitter', unless it is already in the cache
+  void fit(ECISet &eci, IncrementalFit &fitter, bool &singular);
+
+  long int size() const;
+  long int get_Nhit() const;
+  long int get_Nmiss() const;
+
+private:
+
+  int shard_index(const std::string &bit_string) const;
+
+};
+
+#endif // FitCache_HH
@@ -10,6 +10,9 @@
 #include "BP_Dir.hh"
 #include "Functions.hh"
 #include "Correlation.hh"
+#include "IncrementalFit.hh"
+#include "L1Path.hh"
+#include "BestSubset.hh"
 #include "ECISet.hh"
 #include "EnergySet.hh"
 #include "GeneticAlgorithm.hh"
@@ -185,6 +188,45 @@ void calc_cs_eci(std::string energy_filename, std::string eci_in_filename, std::
     std::cout << std::endl << eci_CS.get_bit_string() << "    mu: " << mu[i] << "  Nclust: " << eci_CS.get_Nclust_on() << " rms: " << eci_CS.get_rms() << std::endl;
   }
 
+  write_cs_results(eci_CS, energy_filename, DFT_nrg, corr, hulltol);
+
+}
+
+void calc_cs_path_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, double mu_min, int Nmu, int Nfold, double hulltol) {
+  // solve the compressive sensing problem along a path of decreasing mu, from the smallest mu
+  //   that turns all ECI off down to mu_min, and keep the ECI for the mu with the lowest cv score
+
+  Correlation corr(corr_in_filename);
+  EnergySet DFT_nrg(energy_filename);
+  ECISet eci_in(eci_in_filename);
+  ECISet eci_CS = eci_in;
+
+  double prec_ECI = 1e-6;
+
+  L1Path path(corr, DFT_nrg, Nfold);
+  CASM::TaskScheduler scheduler(PTHREADS);
+  path.solve(path.mu_sequence(mu_min, Nmu), prec_ECI, scheduler);
+
+  for(int i = 0; i < path.size(); i++) {
+    eci_CS.set_values_and_weights(path.get_ECI(i));
+    std::cout << eci_CS.get_bit_string() << "    mu: " << path.get_mu(i) << "  Nclust: " << path.get_Nclust_on(i) << " rms: " << path.get_rms(i) << " cv: " << path.get_cv(i) << std::endl;
+  }
+
+  int best = path.get_best_index();
+  eci_CS.set_values_and_weights(path.get_ECI(best));
+  eci_CS.set_cv(path.get_cv(best));
+  eci_CS.set_rms(path.get_rms(best));
+
+  std::cout << std::endl << "Best: " << std::endl;
+  std::cout << eci_CS.get_bit_string() << "    mu: " << path.get_mu(best) << "  Nclust: " << eci_CS.get_Nclust_on() << " rms: " << eci_CS.get_rms() << " cv: " << eci_CS.get_cv() << std::endl << std::endl;
+
+  write_cs_results(eci_CS, energy_filename, DFT_nrg, corr, hulltol);
+
+}
+
+void write_cs_results(ECISet &eci_CS, std::string energy_filename, EnergySet &DFT_nrg, const Correlation &corr, double hulltol) {
+  // write eci.in, eci.out, the hulls, energy.clex, and plots, for the compressive sensing result 'eci_CS'
+
   // write eci.in
   eci_CS.write_ECIin("eci.in", "default");
   std::cout << "Wrote 'eci.in'" << std::endl;
@@ -350,56 +392,40 @@ void calc_ecistats(std::string energy_filename, std::string eci_in_filename, std
 
 }
 
-void calc_all_eci(int N, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename) {
+void calc_all_eci(int N, int K, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename) {
 
   Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
   ECISet eci_in(eci_in_filename);
-  ECISet eci_min_B = eci_in;
   bool singular;
-  int bestsofar = 0;
-
-  MTRand mtrand;
 
   BP::BP_Comb combs(eci_in.size(), N);
 
   std::cout << "This calculates all ecisets with " << N << " eci." << std::endl;
   std::cout << "   For N = " << N << " and eci.in size = " << eci_in.size() << " that will be " << combs.total_combs() << " ecisets." << std::endl << std::endl;
 
-  //for( int i=0; i<10; i++)
-  //	combs.fix( i, 1);
-
-  int count = 0;
+  // branch-and-bound, only fitting the ecisets that could be among the K best
+  BestSubset search(std::make_shared<GramMatrix>(corr, DFT_nrg));
+  CASM::TaskScheduler scheduler(PTHREADS);
+  search.search(N, K, scheduler);
 
-  do {
-    eci_in = combs;
-
-    eci_in.fit(corr, DFT_nrg, singular);
+  std::cout << "   Searched " << search.get_Nnode() << " nodes and fit " << search.get_Nleaf() << " ecisets." << std::endl << std::endl;
 
-    if(eci_min_B.get_cv() == UK || eci_in.get_cv() < eci_min_B.get_cv()) {
-      eci_min_B = eci_in;
-      bestsofar = combs.get_count();
-    }
+  if(search.size() == 0) {
+    std::cout << "error, singular" << std::endl;
+    return;
+  }
 
-    if(!singular) {
-      std::cout << eci_in.get_bit_string() << "   i: " << combs.get_count() << "\t Nclust: " << eci_in.get_Nclust_on() << " cv: " << eci_in.get_cv() << " rms: " << eci_in.get_rms() << std::endl;
-      //std::cout << "i: " << combs.get_count() << " Nclust: " << eci_in.get_Nclust_on() << " cv: " << cv_score << " rms: " << rms_score << " bit_string: " << combs.get_bit_string() << std::endl;
-      //std::cout << "   eci: " ;
-      //for( int i=0; i<eci_in.size(); i++)
-      //	if( eci_in[i].weight != 0)
-      //		std::cout << eci_in[i].value << " " ;
-      //std::cout << std::endl;
-    }
-    else {
-      std::cout << "error, singular" << std::endl;
-    }
+  // print the K best, best last
+  for(int i = search.size() - 1; i >= 0; i--) {
+    eci_in.clear_weights();
+    for(int j = 0; j < search.get(i).clust.size(); j++)
+      eci_in.set_clust_on(search.get(i).clust[j]);
 
-    combs.increment();
+    eci_in.fit(corr, DFT_nrg, singular);
 
+    std::cout << eci_in.get_bit_string() << "   rank: " << i << "\t Nclust: " << eci_in.get_Nclust_on() << " cv: " << eci_in.get_cv() << " rms: " << eci_in.get_rms() << std::endl;
   }
-  while(combs.complete() == false);
-
-  std::cout << eci_min_B.get_bit_string() << "       BestSoFar: " << bestsofar << " Nclust: " << eci_min_B.get_Nclust_on() << " cv: " << eci_min_B.get_cv() << " rms: " << eci_min_B.get_rms() << std::endl;
 
 }
 
@@ -825,7 +851,8 @@ ECISet direct_min(int Nmin, int Nmax, const ECISet &eci_start, Correlation &corr
   double last_cv;
   int last_flip;
   // make sure eci_min_A cv score is known
-  eci_min_A.fit(corr, nrg_set, singular);
+  IncrementalFit fitter(corr, nrg_set);
+  eci_min_A.fit(fitter, singular);
 
   // minimize
   int j_count = 1;
@@ -845,7 +872,7 @@ ECISet direct_min(int Nmin, int Nmax, const ECISet &eci_start, Correlation &corr
       if(eci_in.fix_ok())
         if(eci_in.get_Nclust_on() >= Nmin && eci_in.get_Nclust_on() <= Nmax) {
           // find fit/cv score
-          eci_in.fit(corr, nrg_set, singular);
+          eci_in.fit(fitter, singular);
 
           if(eci_in.get_cv() < last_cv) {
             Nchoice++;
@@ -891,7 +918,8 @@ ECISet dfs_min(long int Nstop, int Nmin, int Nmax, const ECISet &eci_start, Corr
   BP::BP_GVec_Member<ECISet> *s_member;
 
   // make sure eci_min_A cv score is known
-  eci_min_A.fit(corr, nrg_set, singular);
+  IncrementalFit fitter(corr, nrg_set);
+  eci_min_A.fit(fitter, singular);
   eci_min_B = eci_min_A;
 
   // depth-first search
@@ -910,7 +938,7 @@ ECISet dfs_min(long int Nstop, int Nmin, int Nmax, const ECISet &eci_start, Corr
         if(eci_in.get_Nclust_on() >= Nmin && eci_in.get_Nclust_on() <= Nmax) {
           //std::cout << "toggle i: " << i << "\n";
           if(add_once(bit_string_list, eci_in.get_bit_string())) {
-            eci_in.fit(corr, nrg_set, singular);
+            eci_in.fit(fitter, singular);
 
             if(eci_in.get_cv() < eci_min_A.get_cv()) {
               Nchoice++;
@@ -999,16 +1027,10 @@ ECISet calc_FPC_eci(double mu, double prec_shrink, double prec_ECI, const ECISet
 
   // set Correlation matrix
   //std::cout << "set C" << std::endl;
-  ii = 0;
-  for(i = 0; i < nrg_set.size(); i++)
-    if(nrg_set.get_weight(i) != 0) {
-      jj = 0;
-      for(j = 0; j < eci_set.size(); j++) {
-        C(ii, jj) = nrg_set.get_weight(i) * corr[i][j];		// include weight!?
-        jj++;
-      }
-      ii++;
-    }
+  std::vector<int> clust(Neci);
+  for(j = 0; j < Neci; j++)
+    clust[j] = j;
+  corr.select(C, nrg_set, clust);		// include weight!?
 
   // set Energy vector
   //std::cout << "set E" << std::endl;
@@ -1102,16 +1124,10 @@ ECISet calc_BI_eci(double mu, double prec_shrink, double prec_ECI, const ECISet
 
   // set Correlation matrix
   //std::cout << "set C" << std::endl;
-  ii = 0;
-  for(i = 0; i < nrg_set.size(); i++)
-    if(nrg_set.get_weight(i) != 0) {
-      jj = 0;
-      for(j = 0; j < eci_set.size(); j++) {
-        C(ii, jj) = nrg_set.get_weight(i) * corr[i][j];		// include weight!?
-        jj++;
-      }
-      ii++;
-    }
+  std::vector<int> clust(Neci);
+  for(j = 0; j < Neci; j++)
+    clust[j] = j;
+  corr.select(C, nrg_set, clust);		// include weight!?
 
   // set Energy vector
   //std::cout << "set E" << std::endl;
@@ -1507,7 +1523,23 @@ std::string rm_json_ext(std::string filename) {
   return filename;
 }
 
+std::string bin_ext(std::string filename) {
+  if(filename.size() <= 4 || filename.compare(filename.size() - 4, 4, ".bin") != 0) {
+    return filename + ".bin";
+  }
+  return filename;
+}
+
+std::string rm_bin_ext(std::string filename) {
+  if(filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0) {
+    return filename.substr(0, filename.size() - 4);
+  }
+  return filename;
+}
+
 std::string get_format_from_ext(std::string filename) {
+  if(rm_bin_ext(filename) != filename)
+    return "binary";
   if(rm_json_ext(filename) == filename)
     return "text";
   return "json";
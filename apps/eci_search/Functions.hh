@@ -27,7 +27,9 @@ class GeneticAlgorithm;
 /// Function declarations
 void calc_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population, double hulltol = 1.0e1 - 4);
 void calc_cs_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, const BP::BP_Vec<double> &mu, int alg, double hulltol = 1.0e1 - 4);
-void calc_all_eci(int N, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename);
+void calc_cs_path_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, double mu_min, int Nmu, int Nfold, double hulltol = 1.0e1 - 4);
+void write_cs_results(ECISet &eci_CS, std::string energy_filename, EnergySet &DFT_nrg, const Correlation &corr, double hulltol);
+void calc_all_eci(int N, int K, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename);
 void calc_directmin_eci(int Nrand, int Nmin, int Nmax, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population);
 void calc_dfsmin_eci(int Nrand, int Nstop, int Nmin, int Nmax, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population);
 void calc_ga_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmutations, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename);
@@ -54,6 +56,8 @@ BP::BP_GVec_Member<ECISet> *get_best_member(BP::BP_GVec<ECISet> &population);
 std::string unique(std::string filename);
 std::string json_ext(std::string filename);
 std::string rm_json_ext(std::string filename);
+std::string bin_ext(std::string filename);
+std::string rm_bin_ext(std::string filename);
 std::string get_format_from_ext(std::string filename);
 
 #endif // Functions_HH
@@ -0,0 +1,82 @@
+/*
+ *  GramMatrix.cc
+ */
+
+#ifndef GramMatrix_CC
+#define GramMatrix_CC
+
+#include "GramMatrix.hh"
+#include "Correlation.hh"
+#include "EnergySet.hh"
+
+GramMatrix::GramMatrix(const Correlation &corr, const EnergySet &nrg_set) {
+
+  if(!nrg_set.E_vec_is_ready()) {
+    std::cout << "Error in GramMatrix::GramMatrix.  nrg_set.E_vec is not ready." << std::endl;
+    exit(1);
+  }
+
+  // same as ECISet::set_correlation_matrix, but for all clusters
+  corr.select(A, nrg_set);
+  E = nrg_set.get_E_vec();
+
+  // only the lower triangle is computed, then copied
+  int Nclust = A.cols();
+  G = Eigen::MatrixXd::Zero(Nclust, Nclust);
+  G.selfadjointView<Eigen::Lower>().rankUpdate(A.transpose());
+  G.triangularView<Eigen::StrictlyUpper>() = G.transpose();
+
+  V = A.transpose() * E;
+  EtE = E.squaredNorm();
+}
+
+//*******************************************************************************************
+
+int GramMatrix::get_Nstruct() const {
+  return A.rows();
+}
+
+int GramMatrix::get_Nclust() const {
+  return A.cols();
+}
+
+const Eigen::MatrixXd &GramMatrix::get_A() const {
+  return A;
+}
+
+const Eigen::VectorXd &GramMatrix::get_E() const {
+  return E;
+}
+
+const Eigen::MatrixXd &GramMatrix::get_G() const {
+  return G;
+}
+
+const Eigen::VectorXd &GramMatrix::get_V() const {
+  return V;
+}
+
+double GramMatrix::get_EtE() const {
+  return EtE;
+}
+
+//*******************************************************************************************
+
+bool GramMatrix::cholesky(const std::vector<int> &clust, Eigen::MatrixXd &R) const {
+  int Nclust = clust.size();
+  Eigen::MatrixXd G_S(Nclust, Nclust);
+  for(int j = 0; j < Nclust; j++) {
+    for(int i = 0; i < Nclust; i++) {
+      G_S(i, j) = G(clust[i], clust[j]);
+    }
+  }
+
+  Eigen::LLT<Eigen::MatrixXd> llt(G_S);
+  if(llt.info() != Eigen::Success)
+    return false;
+
+  R = llt.matrixU();
+  return true;
+}
+
+#endif // GramMatrix_CC
@@ -0,0 +1,72 @@
+/*
+ *  GramMatrix.hh
+ */
+
+#ifndef GramMatrix_HH
+#define GramMatrix_HH
+
+#include <vector>
+#include "casm/external/Eigen/Dense"
+
+class Correlation;
+class EnergySet;
+
+// This class holds the weighted correlation matrix A, for all clusters and the structures with
+//   non-zero weight, the weighted energy vector E, and
+//
+//     G = A^T*A,  V = A^T*E,  and E^T*E
+//
+//   It is built once for a Correlation and an EnergySet weighting, costing O(Nstruct*Nclust^2),
+//   and is read-only afterwards, so one instance can be shared by every fitter and thread in a
+//   run. The structure weights must not change afterwards.
+//
+//   For any set S of clusters, the Cholesky factorization of the principal submatrix of G,
+//   G_S = R^T*R, gives the triangular factor of A_S = Q*R without touching A, so whether S is
+//   singular, and the ECI and rms, cost O(Nclust^3), independent of Nstruct:
+//
+//     z = R^-T*V_S,  ECI = R^-1*z,  and  rms^2 = (E^T*E - |z|^2)/Nstruct
+//
+//   The LOOCV hat matrix diagonal, a_i = X_i*((X^T*X)^-1)*X_i^T = |Q_i|^2, does depend on each
+//   structure. Q = A_S*R^-1 is found with one blocked triangular solve on the contiguous
+//   columns of A_S, costing O(Nstruct*Nclust^2) without the SVD or QR of A_S.
+//
+class GramMatrix {
+
+  Eigen::MatrixXd A;
+  Eigen::VectorXd E;
+
+  Eigen::MatrixXd G;
+  Eigen::VectorXd V;
+  double EtE;
+
+public:
+
+  GramMatrix(const Correlation &corr, const EnergySet &nrg_set);
+
+  int get_Nstruct() const;
+  int get_Nclust() const;
+
+  const Eigen::MatrixXd &get_A() const;
+  const Eigen::VectorXd &get_E() const;
+  const Eigen::MatrixXd &get_G() const;
+  const Eigen::VectorXd &get_V() const;
+  double get_EtE() const;
+
+  // set R, the upper triangular Cholesky factor of the principal submatrix of G for the clusters
+  //   in 'clust', in that order, return false if it is not numerically positive definite
+  bool cholesky(const std::vector<int> &clust, Eigen::MatrixXd &R) const;
+
+  // set Q = A_S*R^-1, for the clusters in 'clust', with R from 'cholesky'
+  template<typename QType>
+  void solve_Q(const std::vector<int> &clust, const Eigen::MatrixXd &R, QType &Q) const;
+
+};
+
+template<typename QType>
+void GramMatrix::solve_Q(const std::vector<int> &clust, const Eigen::MatrixXd &R, QType &Q) const {
+  for(int k = 0; k < clust.size(); k++)
+    Q.col(k) = A.col(clust[k]);
+  R.triangularView<Eigen::Upper>().template solveInPlace<Eigen::OnTheRight>(Q);
+}
+
+#endif // GramMatrix_HH
@@ -0,0 +1,285 @@
+/*
+ *  IncrementalFit.cc
+ */
+
+#ifndef IncrementalFit_CC
+#define IncrementalFit_CC
+
+#include "IncrementalFit.hh"
+#include "Correlation.hh"
+#include "EnergySet.hh"
+#include "ECISet.hh"
+
+IncrementalFit::IncrementalFit(const Correlation &_corr, const EnergySet &_nrg):
+  IncrementalFit(_corr, _nrg, std::make_shared<GramMatrix>(_corr, _nrg)) {}
+
+IncrementalFit::IncrementalFit(const Correlation &_corr, const EnergySet &_nrg, const std::shared_ptr<const GramMatrix> &_gram):
+  corr(&_corr), nrg(&_nrg), gram(_gram), valid(false), Nupdate(0) {
+
+  int Nstruct = gram->get_Nstruct();
+  int Nclust = gram->get_Nclust();
+
+  Q.resize(Nstruct, Nclust);
+  R.resize(Nclust, Nclust);
+}
+
+//*******************************************************************************************
+
+void IncrementalFit::fit(ECISet &eci, bool &singular) {
+
+  // refactor after this many updates to limit accumulated round-off
+  const int max_Nupdate = 128;	// CONSTANT
+
+  unsigned long int i, k;
+  const Eigen::VectorXd &E = gram->get_E();
+  int Nstruct = E.size();
+  std::vector<int> target;
+  for(i = 0; i < eci.size(); i++)
+    if(eci.get_weight(i) != 0)
+      target.push_back(i);
+  int Nclust = target.size();
+
+  // underdetermined or empty fits are left to the SVD
+  if(Nclust == 0 || Nclust > Nstruct) {
+    eci.fit(*corr, *nrg, singular);
+    return;
+  }
+
+  eci.set_Nstruct(Nstruct);
+
+  // find the clusters to turn on and off relative to the cached factorization
+  bool factored = false;
+  if(valid) {
+    std::vector<bool> on(gram->get_Nclust(), false), cached(gram->get_Nclust(), false);
+    for(i = 0; i < target.size(); i++)
+      on[target[i]] = true;
+
+    std::vector<int> remove_list, add_list;
+    for(k = 0; k < col.size(); k++) {
+      cached[col[k]] = true;
+      if(!on[col[k]])
+        remove_list.push_back(k);
+    }
+    for(i = 0; i < target.size(); i++)
+      if(!cached[target[i]])
+        add_list.push_back(target[i]);
+
+    int Nchange = remove_list.size() + add_list.size();
+
+    // an update costs O(Nstruct*Nclust), a refactorization O(Nstruct*Nclust^2)
+    if(Nupdate + Nchange > max_Nupdate || 2 * Nchange > Nclust) {
+      factored = true;
+      singular = !refactor(target);
+    }
+    else {
+      // remove from the back so the remaining indices stay valid
+      for(k = remove_list.size(); k > 0; k--)
+        remove_col(remove_list[k - 1]);
+
+      for(i = 0; i < add_list.size(); i++) {
+        if(!add_col(add_list[i])) {
+          factored = true;
+          singular = !refactor(target);
+          break;
+        }
+      }
+    }
+  }
+  else {
+    factored = true;
+    singular = !refactor(target);
+  }
+
+  // refactor has already checked
+  if(!factored)
+    singular = check_if_singular();
+  if(singular) {
+    eci.set_cv(UK);
+    eci.set_rms(UK);
+    return;
+  }
+
+  // least squares solution, in column order
+  Eigen::VectorXd QtE = Q.leftCols(Nclust).transpose() * E;
+  Eigen::VectorXd x = R.topLeftCorner(Nclust, Nclust).triangularView<Eigen::Upper>().solve(QtE);
+
+  // residuals: A*ECI - E = Q*Q^T*E - E
+  Eigen::VectorXd Err = Q.leftCols(Nclust) * QtE - E;
+
+  // LOOCV = (1.0/Nnrg)*sum_i{ (e_i / 1 - X_i*((X^T*X)^-1)*X_i^T)^2 }
+  //   with X_i*((X^T*X)^-1)*X_i^T = |Q_i|^2, summed over the contiguous columns of Q
+  Eigen::VectorXd a = Q.leftCols(Nclust).cwiseAbs2().rowwise().sum();
+  double rms = 0.0;
+  double cv = 0.0;
+  for(i = 0; i < Nstruct; i++) {
+    rms += Err(i) * Err(i);
+    cv += BP::sqr(Err(i) / (1.0 - a(i)));
+  }
+  eci.set_rms(sqrt(rms / Nstruct));
+  eci.set_cv(sqrt(cv / Nstruct));
+
+  // reorder to match ECISet::set_values
+  Eigen::VectorXd all_ECI = Eigen::VectorXd::Zero(gram->get_Nclust());
+  for(k = 0; k < col.size(); k++)
+    all_ECI(col[k]) = x(k);
+
+  Eigen::VectorXd ECI(Nclust);
+  for(i = 0; i < target.size(); i++)
+    ECI(i) = all_ECI(target[i]);
+
+  eci.set_values(ECI);
+}
+
+//*******************************************************************************************
+
+void IncrementalFit::reset() {
+  valid = false;
+}
+
+//*******************************************************************************************
+
+int IncrementalFit::get_Nupdate() const {
+  return Nupdate;
+}
+
+// private:
+
+//*******************************************************************************************
+
+bool IncrementalFit::refactor(const std::vector<int> &target) {
+
+  // use Householder QR if Q = A*R^-1 would not be orthogonal to about this precision,
+  //   since |Q^T*Q - I| ~ eps*cond(R)^2
+  const double max_cond = 1.0e3;	// CONSTANT
+
+  int Nclust = target.size();
+
+  valid = false;
+  if(!gram->cholesky(target, R))
+    return false;
+  R.conservativeResize(gram->get_Nclust(), gram->get_Nclust());
+  col = target;
+
+  if(check_if_singular())
+    return false;
+
+  Eigen::MatrixXd Rc = R.topLeftCorner(Nclust, Nclust);
+  Eigen::MatrixXd Rinv = Rc.triangularView<Eigen::Upper>().solve(Eigen::MatrixXd::Identity(Nclust, Nclust));
+  if(Rc.norm() * Rinv.norm() > max_cond) {
+    householder_refactor(target);
+    return true;
+  }
+
+  Eigen::Block<Eigen::MatrixXd, Eigen::Dynamic, Eigen::Dynamic, true> Qc = Q.leftCols(Nclust);
+  gram->solve_Q(target, Rc, Qc);
+
+  valid = true;
+  Nupdate = 0;
+  return true;
+}
+
+//*******************************************************************************************
+
+void IncrementalFit::householder_refactor(const std::vector<int> &target) {
+  const Eigen::MatrixXd &A = gram->get_A();
+  int Nstruct = A.rows();
+  int Nclust = target.size();
+
+  Eigen::MatrixXd C(Nstruct, Nclust);
+  for(int k = 0; k < Nclust; k++)
+    C.col(k) = A.col(target[k]);
+
+  Eigen::HouseholderQR<Eigen::MatrixXd> qr(C);
+  Q.leftCols(Nclust) = qr.householderQ() * Eigen::MatrixXd::Identity(Nstruct, Nclust);
+  R.topLeftCorner(Nclust, Nclust) = qr.matrixQR().topLeftCorner(Nclust, Nclust).triangularView<Eigen::Upper>();
+
+  col = target;
+  valid = true;
+  Nupdate = 0;
+}
+
+//*******************************************************************************************
+
+bool IncrementalFit::add_col(int clust) {
+  // Gram-Schmidt with one reorthogonalization step
+  //   returns false if the new column is too close to the span of the current columns
+  //   to be orthogonalized accurately, in which case the caller should refactor
+
+  int Ncol = col.size();
+  Eigen::VectorXd w = gram->get_A().col(clust);
+  double w_norm = w.norm();
+
+  Eigen::VectorXd r = Q.leftCols(Ncol).transpose() * w;
+  w -= Q.leftCols(Ncol) * r;
+
+  Eigen::VectorXd dr = Q.leftCols(Ncol).transpose() * w;
+  w -= Q.leftCols(Ncol) * dr;
+  r += dr;
+
+  double rho = w.norm();
+  if(rho <= 1.0e-8 * w_norm) {	// CONSTANT
+    valid = false;
+    return false;
+  }
+
+  Q.col(Ncol) = w / rho;
+  R.col(Ncol).head(Ncol) = r;
+  R.row(Ncol).head(Ncol).setZero();
+  R(Ncol, Ncol) = rho;
+
+  col.push_back(clust);
+  Nupdate++;
+  return true;
+}
+
+//*******************************************************************************************
+
+void IncrementalFit::remove_col(int index) {
+  // delete column 'index' of R, then zero the resulting subdiagonal with Givens rotations,
+  //   applying the same rotations to the columns of Q
+
+  int Ncol = col.size();
+
+  if(index < Ncol - 1)
+    R.block(0, index, Ncol, Ncol - 1 - index) = R.block(0, index + 1, Ncol, Ncol - 1 - index).eval();
+
+  for(int j = index; j < Ncol - 1; j++) {
+    Eigen::JacobiRotation<double> G;
+    G.makeGivens(R(j, j), R(j + 1, j));
+    R.block(0, 0, Ncol, Ncol - 1).applyOnTheLeft(j, j + 1, G.adjoint());
+    Q.leftCols(Ncol).applyOnTheRight(j, j + 1, G);
+    R(j + 1, j) = 0.0;
+  }
+
+  col.erase(col.begin() + index);
+  Nupdate++;
+}
+
+//*******************************************************************************************
+
+bool IncrementalFit::check_if_singular() const {
+  // same criteria as ECISet::check_if_singular, any singular value of A (equivalently R) < tol,
+  //   using bounds on the smallest singular value to avoid the SVD when possible
+
+  double tol = 1.0e-4;	// CONSTANT
+  int Nclust = col.size();
+  Eigen::MatrixXd Rc = R.topLeftCorner(Nclust, Nclust);
+
+  // the smallest singular value of a triangular matrix is <= min |R_kk|
+  for(int k = 0; k < Nclust; k++)
+    if(fabs(Rc(k, k)) < tol)
+      return true;
+
+  // and >= 1/|R^-1|_F
+  Eigen::MatrixXd Rinv = Rc.triangularView<Eigen::Upper>().solve(Eigen::MatrixXd::Identity(Nclust, Nclust));
+  if(1.0 / Rinv.norm() >= tol)
+    return false;
+
+  Eigen::VectorXd S = Eigen::JacobiSVD<Eigen::MatrixXd>(Rc).singularValues();
+  for(int k = 0; k < S.size(); k++)
+    if(fabs(S(k)) < tol)
+      return true;
+  return false;
+}
+
+#endif // IncrementalFit_CC
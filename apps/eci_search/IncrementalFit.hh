@@ -0,0 +1,93 @@
+/*
+ *  IncrementalFit.hh
+ */
+
+#ifndef IncrementalFit_HH
+#define IncrementalFit_HH
+
+#include <memory>
+#include <vector>
+#include "casm/external/Eigen/Dense"
+
+#include "GramMatrix.hh"
+
+class Correlation;
+class EnergySet;
+class ECISet;
+
+// This class fits ECISets using a cached thin QR factorization, A = Q*R, of the
+//   weighted correlation matrix restricted to the clusters that are on.
+//
+//   When the next ECISet differs from the cached one by only a few clusters, the
+//   factorization is updated rather than recomputed:
+//     cluster on:  column appended using Gram-Schmidt with reorthogonalization
+//     cluster off: column deleted and R restored to triangular form with Givens rotations
+//
+//   From Q and R:
+//     ECI = R^-1 * Q^T * E
+//     LOOCV hat matrix diagonal, a_i = X_i*((X^T*X)^-1)*X_i^T = |Q_i|^2
+//
+//   so a fit costs O(Nstruct*Nclust) instead of O(Nstruct*Nclust^2). The factorization
+//   is recomputed from scratch when an update is ill-conditioned, when many clusters
+//   change at once, or periodically to limit accumulated round-off.
+//
+//   A new factorization starts from the Cholesky factorization of the Gram matrix, so
+//   singular sets are rejected without touching the correlation matrix, and otherwise
+//   Q = A*R^-1 (see GramMatrix). If the condition number of R is too large for Q to be
+//   accurately orthogonal this way, Householder QR is used instead.
+//
+//   The GramMatrix is shared by copies, and can be shared by all fitters for the same
+//   Correlation and EnergySet, so that it is only computed once. Give each thread its
+//   own copy.
+//
+class IncrementalFit {
+
+  const Correlation *corr;
+  const EnergySet *nrg;
+
+  // weighted correlation matrix for all clusters, only rows with non-zero weight,
+  //   weighted energy vector, and Gram matrix
+  std::shared_ptr<const GramMatrix> gram;
+
+  // Q is Nstruct x Ncol, R is Ncol x Ncol, with storage for all clusters
+  Eigen::MatrixXd Q;
+  Eigen::MatrixXd R;
+
+  // cluster index of each column of Q and R
+  std::vector<int> col;
+
+  bool valid;
+  int Nupdate;
+
+public:
+
+  IncrementalFit(const Correlation &_corr, const EnergySet &_nrg);
+
+  // use a GramMatrix already computed for '_corr' and '_nrg'
+  IncrementalFit(const Correlation &_corr, const EnergySet &_nrg, const std::shared_ptr<const GramMatrix> &_gram);
+
+  // fit 'eci', setting ECI values, cv, rms, and Nstruct, as ECISet::fit does
+  void fit(ECISet &eci, bool &singular);
+
+  // discard the cached factorization
+  void reset();
+
+  int get_Nupdate() const;
+
+private:
+
+  // factor the clusters in 'target' from scratch, return false if they are singular, in
+  //   which case Q is not computed and the cached factorization is discarded
+  bool refactor(const std::vector<int> &target);
+
+  void householder_refactor(const std::vector<int> &target);
+
+  bool add_col(int clust);
+
+  void remove_col(int index);
+
+  bool check_if_singular() const;
+
+};
+
+#endif // IncrementalFit_HH
@@ -0,0 +1,263 @@
+/*
+ *  L1Path.cc
+ */
+
+#ifndef L1Path_CC
+#define L1Path_CC
+
+#include <algorithm>
+#include <future>
+#include "L1Path.hh"
+#include "Correlation.hh"
+#include "EnergySet.hh"
+
+L1Path::L1Path(const Correlation &corr, const EnergySet &nrg_set, int _Nfold):
+  Nfold(_Nfold) {
+
+  unsigned long int i, ii;
+  unsigned long int Nnrg = nrg_set.get_Nstruct_on();
+
+  // same as calc_FPC_eci
+  Eigen::MatrixXd C;
+  Eigen::VectorXd E(Nnrg);
+  corr.select(C, nrg_set);
+  ii = 0;
+  for(i = 0; i < nrg_set.size(); i++)
+    if(nrg_set.get_weight(i) != 0) {
+      E(ii) = nrg_set.get_weight(i) * nrg_set.get_Ef(i);
+      ii++;
+    }
+
+  // normalize C and E, so that largest eigenvalue of C.transpose*C is <= 1
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver(C.transpose() * C, Eigen::EigenvaluesOnly);
+  if(eigensolver.info() != Eigen::Success) {
+    std::cout << "SelfAdjointEigenSolver failed!" << std::endl;
+    exit(1);
+  };
+  a1 = sqrt(1.1 * eigensolver.eigenvalues().maxCoeff());
+
+  Cn = C / a1;
+  En = E / a1;
+
+  if(Nfold > Nnrg)
+    Nfold = Nnrg;
+}
+
+//*******************************************************************************************
+
+double L1Path::get_mu_max() const {
+  if(Cn.cols() == 0)
+    return 0.0;
+  return (Cn.transpose() * En).cwiseAbs().maxCoeff();
+}
+
+//*******************************************************************************************
+
+std::vector<double> L1Path::mu_sequence(double mu_min, int Nmu) const {
+  double mu_max = get_mu_max();
+  std::vector<double> result;
+  if(Nmu == 1 || mu_min >= mu_max) {
+    result.push_back(mu_min);
+    return result;
+  }
+  for(int i = 0; i < Nmu; i++) {
+    result.push_back(mu_max * pow(mu_min / mu_max, (1.0 * i) / (Nmu - 1)));
+  }
+  return result;
+}
+
+//*******************************************************************************************
+
+void L1Path::solve(const std::vector<double> &_mu, double prec_ECI, CASM::TaskScheduler &scheduler) {
+
+  mu = _mu;
+  int Nnrg = Cn.rows();
+  int Neci = Cn.cols();
+
+  // converge when no step changes the fitted energies by more than this
+  double tol = prec_ECI * std::max(En.norm(), 1e-300);
+
+  // task 0 solves the full set, task k solves the training set without fold k-1
+  int Ncv = (Nfold > 1) ? Nfold : 0;
+  std::vector<std::vector<Eigen::VectorXd> > path(Ncv + 1);
+  std::vector<std::future<void> > result;
+
+  for(int k = 0; k <= Ncv; k++) {
+    result.push_back(scheduler.submit([&, k]() {
+      if(k == 0) {
+        path[k] = solve_path(Cn.transpose() * Cn, Cn.transpose() * En, tol);
+        return;
+      }
+
+      int fold = k - 1;
+      int Ntrain = Nnrg - (Nnrg - fold + Nfold - 1) / Nfold;
+      Eigen::MatrixXd C_train(Ntrain, Neci);
+      Eigen::VectorXd E_train(Ntrain);
+      int in_i = 0;
+      for(int i = 0; i < Nnrg; i++) {
+        if(i % Nfold != fold) {
+          C_train.row(in_i) = Cn.row(i);
+          E_train(in_i) = En(i);
+          in_i++;
+        }
+      }
+      path[k] = solve_path(C_train.transpose() * C_train, C_train.transpose() * E_train, tol);
+    }));
+  }
+  for(int k = 0; k < result.size(); k++) {
+    result[k].get();
+  }
+
+  ECI = path[0];
+  rms.assign(mu.size(), 0.0);
+  cv.assign(mu.size(), 1e20);
+  for(int i = 0; i < mu.size(); i++) {
+    rms[i] = a1 * (Cn * ECI[i] - En).norm() / sqrt(1.0 * Nnrg);
+
+    if(Ncv) {
+      double sqr_sum = 0.0;
+      for(int r = 0; r < Nnrg; r++) {
+        sqr_sum += BP::sqr(Cn.row(r).dot(path[r % Nfold + 1][i]) - En(r));
+      }
+      cv[i] = a1 * sqrt(sqr_sum / Nnrg);
+    }
+  }
+}
+
+//*******************************************************************************************
+
+int L1Path::size() const {
+  return mu.size();
+}
+
+double L1Path::get_mu(int i) const {
+  return mu[i];
+}
+
+const Eigen::VectorXd &L1Path::get_ECI(int i) const {
+  return ECI[i];
+}
+
+double L1Path::get_rms(int i) const {
+  return rms[i];
+}
+
+double L1Path::get_cv(int i) const {
+  return cv[i];
+}
+
+int L1Path::get_Nclust_on(int i) const {
+  int count = 0;
+  for(int j = 0; j < ECI[i].size(); j++)
+    if(ECI[i](j) != 0.0)
+      count++;
+  return count;
+}
+
+int L1Path::get_best_index() const {
+  int best = 0;
+  for(int i = 1; i < cv.size(); i++)
+    if(cv[i] < cv[best])
+      best = i;
+  return best;
+}
+
+//*******************************************************************************************
+
+std::vector<Eigen::VectorXd> L1Path::solve_path(const Eigen::MatrixXd &M1, const Eigen::VectorXd &V1, double tol) const {
+
+  int Neci = V1.size();
+  std::vector<Eigen::VectorXd> result;
+
+  // start from ECI = 0, for which G = -V1
+  Eigen::VectorXd ECI_i = Eigen::VectorXd::Zero(Neci);
+  Eigen::VectorXd G = -V1;
+  double mu_prev = (Neci == 0) ? 0.0 : G.cwiseAbs().maxCoeff();
+
+  std::vector<int> strong;
+  std::vector<bool> in_strong(Neci);
+
+  for(int i = 0; i < mu.size(); i++) {
+
+    // sequential strong rule
+    strong.clear();
+    for(int j = 0; j < Neci; j++) {
+      in_strong[j] = M1(j, j) > 0.0 && (ECI_i(j) != 0.0 || fabs(G(j)) >= 2.0 * mu[i] - mu_prev);
+      if(in_strong[j])
+        strong.push_back(j);
+    }
+
+    // solve on the strong set, then add any clusters that violate the KKT conditions
+    while(true) {
+      coordinate_descent(M1, ECI_i, G, strong, mu[i], tol);
+
+      bool violated = false;
+      for(int j = 0; j < Neci; j++) {
+        if(!in_strong[j] && M1(j, j) > 0.0 && fabs(G(j)) > mu[i]) {
+          in_strong[j] = true;
+          strong.push_back(j);
+          violated = true;
+        }
+      }
+      if(!violated)
+        break;
+      std::sort(strong.begin(), strong.end());
+    }
+
+    result.push_back(ECI_i);
+    mu_prev = mu[i];
+  }
+
+  return result;
+}
+
+//*******************************************************************************************
+
+void L1Path::coordinate_descent(const Eigen::MatrixXd &M1, Eigen::VectorXd &ECI_i, Eigen::VectorXd &G, const std::vector<int> &strong, double mu_i, double tol) const {
+
+  std::vector<int> active;
+  while(true) {
+
+    // sweep over the strong set
+    double max_delta = 0.0;
+    for(int k = 0; k < strong.size(); k++) {
+      max_delta = std::max(max_delta, update(M1, ECI_i, G, strong[k], mu_i));
+    }
+    if(max_delta <= tol)
+      return;
+
+    // iterate over the active set until it converges
+    active.clear();
+    for(int k = 0; k < strong.size(); k++)
+      if(ECI_i(strong[k]) != 0.0)
+        active.push_back(strong[k]);
+
+    do {
+      max_delta = 0.0;
+      for(int k = 0; k < active.size(); k++) {
+        max_delta = std::max(max_delta, update(M1, ECI_i, G, active[k], mu_i));
+      }
+    }
+    while(max_delta > tol);
+  }
+}
+
+//*******************************************************************************************
+
+double L1Path::update(const Eigen::MatrixXd &M1, Eigen::VectorXd &ECI_i, Eigen::VectorXd &G, int j, double mu_i) const {
+
+  // minimize over ECI(j):  0.5*M1(j,j)*ECI(j)^2 + (G(j) - M1(j,j)*ECI(j)_old)*ECI(j) + mu*|ECI(j)|
+  double M1_jj = M1(j, j);
+  double init = ECI_i(j);
+  double z = M1_jj * init - G(j);
+  double value = BP::sign(z) * std::max<double>(fabs(z) - mu_i, 0.0) / M1_jj;
+
+  if(value == init)
+    return 0.0;
+
+  ECI_i(j) = value;
+  G += M1.col(j) * (value - init);
+  return sqrt(M1_jj) * fabs(value - init);
+}
+
+#endif // L1Path_CC
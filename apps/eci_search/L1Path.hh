@@ -0,0 +1,92 @@
+/*
+ *  L1Path.hh
+ */
+
+#ifndef L1Path_HH
+#define L1Path_HH
+
+#include <vector>
+#include "casm/external/Eigen/Dense"
+#include "casm/system/TaskScheduler.hh"
+
+class Correlation;
+class EnergySet;
+
+// This class solves the compressive sensing fit for a decreasing sequence of mu:
+//
+//     min_ECI  0.5*|Cn*ECI - En|^2 + mu*|ECI|_1
+//
+//   with the same weighted and normalized Cn and En as calc_FPC_eci, so mu has the same
+//   meaning as for -calc_cs_fpc.
+//
+//   Each mu is solved by coordinate descent on the Gram matrix M1 = Cn^T*Cn, keeping the
+//   gradient G = M1*ECI - Cn^T*En up to date as ECI change, so a step costs O(Nclust) and
+//   does not touch the correlation matrix. Along the path:
+//     warm start: the solution for the previous mu is the starting point
+//     strong rules: clusters with |G_j| < 2*mu - mu_prev are skipped, unless the KKT
+//                   conditions, |G_j| <= mu, turn out to be violated at the solution
+//     active set: after a sweep over all candidate clusters, only the non-zero ECI are
+//                 iterated until they converge
+//
+//   For cross validation, structures with non-zero weight are split round-robin into Nfold
+//   folds. The path is solved for each training set (all folds but one) and for the full set,
+//   in parallel, and the CV score for each mu is the rms weighted prediction error over the
+//   left out structures.
+//
+class L1Path {
+
+  // weighted correlation matrix and energy, only rows with non-zero weight, normalized so that
+  //   the largest eigenvalue of Cn^T*Cn is <= 1
+  Eigen::MatrixXd Cn;
+  Eigen::VectorXd En;
+
+  // normalization factor: Cn = C/a1
+  double a1;
+
+  int Nfold;
+
+  // results for each mu: ECI, and weighted rms and cv (in unnormalized energy units)
+  std::vector<double> mu;
+  std::vector<Eigen::VectorXd> ECI;
+  std::vector<double> rms;
+  std::vector<double> cv;
+
+public:
+
+  L1Path(const Correlation &corr, const EnergySet &nrg_set, int _Nfold);
+
+  // smallest mu for which all ECI are zero
+  double get_mu_max() const;
+
+  // Nmu values of mu, from get_mu_max() down to mu_min, evenly spaced on a log scale
+  std::vector<double> mu_sequence(double mu_min, int Nmu) const;
+
+  // solve for each of '_mu', which should be decreasing, using 'scheduler' to solve the full set
+  //   and the cross validation folds in parallel. Coordinate descent stops when no step changes
+  //   the fitted energies by more than prec_ECI*|En|, so prec_ECI must be > 0.
+  void solve(const std::vector<double> &_mu, double prec_ECI, CASM::TaskScheduler &scheduler);
+
+  int size() const;
+  double get_mu(int i) const;
+  const Eigen::VectorXd &get_ECI(int i) const;
+  double get_rms(int i) const;
+  double get_cv(int i) const;
+  int get_Nclust_on(int i) const;
+
+  // index of the mu with the lowest cv
+  int get_best_index() const;
+
+private:
+
+  // solve the path for the problem with Gram matrix M1 and V1 = Cn^T*En
+  std::vector<Eigen::VectorXd> solve_path(const Eigen::MatrixXd &M1, const Eigen::VectorXd &V1, double tol) const;
+
+  // coordinate descent, on the clusters in 'strong' with non-zero diagonal, for one mu
+  void coordinate_descent(const Eigen::MatrixXd &M1, Eigen::VectorXd &ECI, Eigen::VectorXd &G, const std::vector<int> &strong, double mu, double tol) const;
+
+  // one coordinate descent step for cluster j, returns the change in ECI(j) scaled by sqrt(M1(j,j))
+  double update(const Eigen::MatrixXd &M1, Eigen::VectorXd &ECI, Eigen::VectorXd &G, int j, double mu) const;
+
+};
+
+#endif // L1Path_HH
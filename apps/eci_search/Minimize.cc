@@ -6,7 +6,6 @@
 #define Minimize_CC
 
 #include "Minimize.hh"
-#include "BP_ThreadPool.hh"
 
 void DirectMinStep::run() {
   Nchoice = 0;
@@ -19,7 +18,10 @@ void DirectMinStep::run() {
     eci.toggle_clust(toggle[i]);
 
     // find fit/cv score
-    eci.fit(*corr, *nrg, singular);
+    if(cache)
+      cache->fit(eci, fitter, singular);
+    else
+      eci.fit(fitter, singular);
 
     if(eci.get_cv() < last_cv) {
       Nchoice++;
@@ -36,11 +38,6 @@ void DirectMinStep::run() {
   }
 }
 
-void *DirectMinStep::run_threaded(void *_this) {
-  ((DirectMinStep *) _this)->run();
-  return NULL;
-}
-
 void DFSMinStep::run() {
   bool singular;
   double last_cv = eci.get_cv();
@@ -54,7 +51,10 @@ void DFSMinStep::run() {
       new_bit_string_list.add(eci.get_bit_string());
 
       // find fit/cv score
-      eci.fit(*corr, *nrg, singular);
+      if(cache)
+        cache->fit(eci, fitter, singular);
+      else
+        eci.fit(fitter, singular);
 
       if(eci.get_cv() < last_cv) {
         improved_state.add(eci.get_state());
@@ -65,28 +65,26 @@ void DFSMinStep::run() {
   }
 }
 
-void *DFSMinStep::run_threaded(void *_this) {
-  ((DFSMinStep *) _this)->run();
-  return NULL;
-}
-
 
 
 void Minimize::direct() {
   bool cont, singular;
   int i, j, Nchoice;
 
-  eci.fit(*corr, *nrg, singular);
+  if(!gram)
+    gram = std::make_shared<GramMatrix>(*corr, *nrg);
+  IncrementalFit fitter(*corr, *nrg, gram);
+  if(cache)
+    cache->fit(eci, fitter, singular);
+  else
+    eci.fit(fitter, singular);
   ECISetState best_state = eci.get_state();
 
-  // create a threadpool
-  BP::ThreadPool pool(Nthreads);
-
   // we'll be toggling each eci on/off
   //   so to parallelize, break eciset into portions
   BP::BP_Vec<DirectMinStep> portion;
   for(i = 0; i < Nthreads; i++) {
-    portion.add(DirectMinStep(*nrg, eci, *corr));
+    portion.add(DirectMinStep(*nrg, eci, *corr, fitter, cache));
   }
 
   std::stringstream ss;
@@ -114,9 +112,10 @@ void Minimize::direct() {
     }
 
     // run the step
-    for(i = 0; i < portion.size(); i++)
-      pool.add_work(DirectMinStep::run_threaded, (void *) &portion[i]);
-    pool.finish();
+    scheduler->parallel_for(0, portion.size(), [&](CASM::Index begin, CASM::Index end) {
+      for(CASM::Index p = begin; p < end; p++)
+        portion[p].run();
+    });
 
     cont = false;
     Nchoice = 0;
@@ -166,19 +165,22 @@ void Minimize::dfs() {
   ECISetState min_state;
 
 
-  eci.fit(*corr, *nrg, singular);
+  if(!gram)
+    gram = std::make_shared<GramMatrix>(*corr, *nrg);
+  IncrementalFit fitter(*corr, *nrg, gram);
+  if(cache)
+    cache->fit(eci, fitter, singular);
+  else
+    eci.fit(fitter, singular);
   ECISetState best_state = eci.get_state();
   //queue.add(best_state);
   bit_string_list.add(eci.get_bit_string());
 
-  // create a threadpool
-  BP::ThreadPool pool(Nthreads);
-
   // we'll be toggling each eci on/off
   //   so to parallelize, break eciset into portions
   BP::BP_Vec<DFSMinStep> portion;
   for(i = 0; i < Nthreads; i++) {
-    portion.add(DFSMinStep(*nrg, eci, *corr, bit_string_list));
+    portion.add(DFSMinStep(*nrg, eci, *corr, fitter, cache, bit_string_list));
   }
 
   std::stringstream ss;
@@ -209,9 +211,10 @@ void Minimize::dfs() {
     //ss.str("");
 
     // run the step
-    for(i = 0; i < portion.size(); i++)
-      pool.add_work(DFSMinStep::run_threaded, (void *) &portion[i]);
-    pool.finish();
+    scheduler->parallel_for(0, portion.size(), [&](CASM::Index begin, CASM::Index end) {
+      for(CASM::Index p = begin; p < end; p++)
+        portion[p].run();
+    });
 
     Nchoice = 0;
     // add the new_bit_string_list's to bit_string_list
@@ -8,7 +8,12 @@
 #include "EnergySet.hh"
 #include "ECISet.hh"
 #include "Correlation.hh"
+#include "IncrementalFit.hh"
+#include "GramMatrix.hh"
+#include "FitCache.hh"
+#include "casm/system/TaskScheduler.hh"
 #include "BP_Vec.hh"
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -19,6 +24,8 @@ public:
   const EnergySet *nrg;
   ECISet eci;
   const Correlation *corr;
+  IncrementalFit fitter;
+  FitCache *cache;
   BP::BP_Vec<int> toggle;
 
   // for direct minimization
@@ -26,12 +33,11 @@ public:
   bool cont;  // continue?
   ECISetState best_state;
 
-  DirectMinStep(const EnergySet &_nrg, const ECISet &_eci, const Correlation &_corr):
-    nrg(&_nrg), eci(_eci), corr(&_corr) {
+  DirectMinStep(const EnergySet &_nrg, const ECISet &_eci, const Correlation &_corr, const IncrementalFit &_fitter, FitCache *_cache):
+    nrg(&_nrg), eci(_eci), corr(&_corr), fitter(_fitter), cache(_cache) {
   }
 
   void run();
-  static void *run_threaded(void *_this);
 };
 
 
@@ -42,6 +48,8 @@ public:
   const EnergySet *nrg;
   ECISet eci;
   const Correlation *corr;
+  IncrementalFit fitter;
+  FitCache *cache;
   const BP::BP_Vec<std::string> *bit_string_list;
   BP::BP_Vec<int> toggle;
 
@@ -52,12 +60,13 @@ public:
   DFSMinStep(const EnergySet &_nrg,
              const ECISet &_eci,
              const Correlation &_corr,
+             const IncrementalFit &_fitter,
+             FitCache *_cache,
              const BP::BP_Vec<std::string> &_bit_string_list):
-    nrg(&_nrg), eci(_eci), corr(&_corr), bit_string_list(&_bit_string_list) {
+    nrg(&_nrg), eci(_eci), corr(&_corr), fitter(_fitter), cache(_cache), bit_string_list(&_bit_string_list) {
   }
 
   void run();
-  static void *run_threaded(void *_this);
 
 
 };
@@ -70,7 +79,10 @@ class Minimize {
   ECISet eci;
   const Correlation *corr;
   std::string sout;
+  CASM::TaskScheduler *scheduler;
   int Nthreads;
+  FitCache *cache;
+  std::shared_ptr<const GramMatrix> gram;
 
   int step;
 
@@ -80,8 +92,18 @@ class Minimize {
   int finished;
 
 public:
-  Minimize(const EnergySet &_nrg, const ECISet &_eci, const Correlation &_corr, int _Nthreads = 1, bool _print_steps = false):
-    nrg(&_nrg), eci(_eci), corr(&_corr), Nthreads(_Nthreads), step(0), print_steps(_print_steps), finished(false) {
+  // Each step is divided into '_Nthreads' portions, which are run using '_scheduler'
+  //   If '_cache' is given, fits are looked up in it and added to it
+  //   If '_gram' is given, it is used for fitting, otherwise it is computed
+  Minimize(const EnergySet &_nrg,
+           const ECISet &_eci,
+           const Correlation &_corr,
+           CASM::TaskScheduler &_scheduler,
+           int _Nthreads = 1,
+           bool _print_steps = false,
+           FitCache *_cache = NULL,
+           const std::shared_ptr<const GramMatrix> &_gram = std::shared_ptr<const GramMatrix>()):
+    nrg(&_nrg), eci(_eci), corr(&_corr), scheduler(&_scheduler), Nthreads(_Nthreads), cache(_cache), gram(_gram), step(0), print_steps(_print_steps), finished(false) {
   }
 
   void direct();
@@ -91,16 +113,6 @@ public:
     Nstop = _Nstop;
   }
 
-  static void *direct_threaded(void *_this) {
-    ((Minimize *) _this)->direct();
-    return NULL;
-  }
-
-  static void *dfs_threaded(void *_this) {
-    ((Minimize *) _this)->dfs();
-    return NULL;
-  }
-
   const ECISet &get_eci() const {
     return eci;
   }
@@ -11,6 +11,16 @@
 #include "BP_useful.hh"
 #include <sstream>
 #include <unistd.h>
+#include "casm/system/TaskScheduler.hh"
+#include <set>
+
+// return true if every future in 'result' is ready
+static bool all_ready(const std::vector<std::future<void> > &result) {
+  for(int i = 0; i < result.size(); i++)
+    if(result[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return false;
+  return true;
+}
 
 std::string Population::format() const {
   return m_format;
@@ -107,7 +117,7 @@ void Population::direct(int pthreads, int mthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
+  int ncore = CASM::default_num_threads();
 
   if(pthreads == -1)
     pthreads = ncore < population.size() ? ncore : population.size() ;
@@ -117,16 +127,19 @@ void Population::direct(int pthreads, int mthreads) {
 
   if(TEST) std::cout << "pthreads: " << pthreads << " mthreads: " << mthreads << std::endl << std::endl;
 
-  // create a ThreadPool
-  BP::ThreadPool pool(pthreads);
+  // create a TaskScheduler, shared by the minimizations and their steps
+  CASM::TaskScheduler scheduler(pthreads * mthreads);
 
   // create minimization objects for each ECISet in the population & run the minimization
   BP::BP_Vec<Minimize> minimization;
   BP::BP_Vec<bool> completed;
+  std::vector<std::future<void> > result;
   for(int i = 0; i < population.size(); i++) {
     completed.add(false);
-    minimization.add(Minimize(nrg, population[i], corr, mthreads, false));
-    pool.add_work(Minimize::direct_threaded, (void *) &minimization[i]);
+    Minimize *min = minimization.add(Minimize(nrg, population[i], corr, scheduler, mthreads, false, &cache, get_gram()));
+    result.push_back(scheduler.submit([ = ]() {
+      min->direct();
+    }));
   }
 
   // while the minimizations are ongoing, print results of completed fits
@@ -136,7 +149,10 @@ void Population::direct(int pthreads, int mthreads) {
     std::cout << minimization_status(minimization, completed);
     std::cout << flush;
   }
-  while(!pool.is_finished());
+  while(!all_ready(result));
+
+  for(int i = 0; i < result.size(); i++)
+    result[i].get();
 
   std::cout << minimization_status(minimization, completed);
   std::cout << flush;
@@ -165,7 +181,7 @@ void Population::dfs(int Nstop, int pthreads, int mthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
+  int ncore = CASM::default_num_threads();
 
   if(pthreads == -1)
     pthreads = ncore < population.size() ? ncore : population.size();
@@ -175,17 +191,20 @@ void Population::dfs(int Nstop, int pthreads, int mthreads) {
 
   if(TEST) std::cout << "pthreads: " << pthreads << " mthreads: " << mthreads << std::endl;
 
-  // create a ThreadPool
-  BP::ThreadPool pool(pthreads);
+  // create a TaskScheduler, shared by the minimizations and their steps
+  CASM::TaskScheduler scheduler(pthreads * mthreads);
 
   // create minimization objects for each ECISet in the population & run the minimization
   BP::BP_Vec<Minimize> minimization;
   BP::BP_Vec<bool> completed;
+  std::vector<std::future<void> > result;
   for(int i = 0; i < population.size(); i++) {
     completed.add(false);
-    minimization.add(Minimize(nrg, population[i], corr, mthreads, false));
-    minimization[i].set_Nstop(Nstop);
-    pool.add_work(Minimize::dfs_threaded, (void *) &minimization[i]);
+    Minimize *min = minimization.add(Minimize(nrg, population[i], corr, scheduler, mthreads, false, &cache, get_gram()));
+    min->set_Nstop(Nstop);
+    result.push_back(scheduler.submit([ = ]() {
+      min->dfs();
+    }));
   }
 
   // while the minimizations are ongoing, print results of completed fits
@@ -195,7 +214,10 @@ void Population::dfs(int Nstop, int pthreads, int mthreads) {
     std::cout << minimization_status(minimization, completed);
     std::cout << flush;
   }
-  while(!pool.is_finished());
+  while(!all_ready(result));
+
+  for(int i = 0; i < result.size(); i++)
+    result[i].get();
 
   std::cout << minimization_status(minimization, completed);
   std::cout << flush;
@@ -244,16 +266,16 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-  int ga_pthreads;
+  int ncore = CASM::default_num_threads();
+  int ga_pthreads = pthreads;
 
   if(pthreads <= 0)
     ga_pthreads = ncore;
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create ThreadPool
-  BP::ThreadPool pool(ga_pthreads);
+  // create TaskScheduler
+  CASM::TaskScheduler scheduler(ga_pthreads);
 
   // create gene pool
   BP::BP_Vec<ECISetState> gene_pool;
@@ -297,10 +319,12 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
       dfs(Nstop, pthreads);
     }
     else {
-      for(int i = 0; i < population.size(); i++) {
-        pool.add_work(ECISet::fit_threaded, (void *) &population[i]);
-      }
-      pool.finish();
+      scheduler.parallel_for(0, population.size(), [&](CASM::Index begin, CASM::Index end) {
+        IncrementalFit fitter(corr, nrg, get_gram());
+        bool singular;
+        for(CASM::Index i = begin; i < end; i++)
+          cache.fit(population[i], fitter, singular);
+      });
     }
 
     // prune to best Npop unique ECISets of last 2 generations
@@ -327,11 +351,176 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
 
   std::cout << "\nFinal Population:" << std::endl;
   std::cout << population_status();
+  std::cout << cache_status();
 
   //std::cout << "finish Population::ga" << std::endl;
 
 }
 
+void Population::ga_async(int Ngen, int Nmut, int Nisland, int Nmigrate, int pthreads) {
+  //std::cout << "begin Population::ga_async" << std::endl;
+
+  std::cout << "\nBeginning steady-state genetic algorithm: " << std::endl;
+  std::cout << "  population size: " << population.size() << std::endl;
+  std::cout << "  number of generations: " << Ngen << std::endl;
+  std::cout << "  avg number of mutations per child: " << Nmut << std::endl;
+  std::cout << "  number of islands: " << Nisland << std::endl;
+  std::cout << "  generations between migrations: " << Nmigrate << std::endl << std::endl;
+
+  if(Nisland < 1 || population.size() < 2 * Nisland) {
+    std::cout << "  Error. population size: " << population.size() << ", must be at least 2 per island" << std::endl;
+    exit(1);
+  }
+
+  // determine the number of threads
+  if(pthreads <= 0)
+    pthreads = CASM::default_num_threads();
+
+  if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
+
+  // create TaskScheduler
+  CASM::TaskScheduler scheduler(pthreads);
+
+  // fit the initial population
+  scheduler.parallel_for(0, population.size(), [&](CASM::Index begin, CASM::Index end) {
+    IncrementalFit fitter(corr, nrg, get_gram());
+    bool singular;
+    for(CASM::Index i = begin; i < end; i++)
+      cache.fit(population[i], fitter, singular);
+  });
+
+  // create the island gene pools
+  std::vector<BP::BP_Vec<ECISetState> > island(Nisland);
+  for(int i = 0; i < population.size(); i++) {
+    island[i % Nisland].add(population[i].get_state());
+  }
+  std::cout << "---------------------------------------------" << std::endl;
+  for(int k = 0; k < Nisland; k++) {
+    std::cout << "Initial gene pool, island: " << k << std::endl;
+    std::cout << gene_pool_status(island[k]);
+  }
+  std::cout << "---------------------------------------------" << std::endl;
+
+  long int Nchild = long(Ngen) * population.size();
+  long int migrate_interval = (Nisland > 1 && Nmigrate > 0) ? long(Nmigrate) * population.size() : 0;
+  long int status_interval = 10L * population.size();
+  long int Nstarted = 0;
+  long int Nfinished = 0;
+
+  // bit_strings of children being fit, so that the same child is not fit twice at once
+  std::set<std::string> in_progress;
+  std::mutex ga_mutex;
+
+  // attempts to create a child that is not already in its island, before accepting a duplicate
+  const int max_attempts = 100;	// CONSTANT
+
+  auto contains = [](const BP::BP_Vec<ECISetState> &pool, const std::string &bit_string) {
+    for(int i = 0; i < pool.size(); i++)
+      if(pool[i].bit_string == bit_string)
+        return true;
+    return false;
+  };
+
+  auto worker = [&]() {
+    IncrementalFit fitter(corr, nrg, get_gram());
+    ECISet child = eci_base;
+    child.set_data(nrg, corr);
+    bool singular;
+
+    while(true) {
+
+      // mate
+      int k;
+      std::string bit_string;
+      {
+        std::lock_guard<std::mutex> lock(ga_mutex);
+        if(Nstarted == Nchild)
+          return;
+        k = Nstarted % Nisland;
+        Nstarted++;
+
+        int count = 0;
+        do {
+          mate(island[k], child, Nmut, mtrand);
+          bit_string = child.get_bit_string();
+          count++;
+        }
+        while(count < max_attempts && (contains(island[k], bit_string) || in_progress.count(bit_string)));
+        in_progress.insert(bit_string);
+      }
+
+      // fit
+      cache.fit(child, fitter, singular);
+
+      // replace the worst in the island, if the child is better
+      std::lock_guard<std::mutex> lock(ga_mutex);
+      in_progress.erase(bit_string);
+
+      ECISetState state = child.get_state();
+      if(!contains(island[k], bit_string)) {
+        int worst = BP::max_index(island[k]);
+        if(state < island[k][worst])
+          island[k][worst] = state;
+      }
+      Nfinished++;
+
+      // migrate the best of each island to the next, replacing its worst
+      if(migrate_interval && Nfinished % migrate_interval == 0) {
+        BP::BP_Vec<ECISetState> emigrant;
+        for(int i = 0; i < Nisland; i++)
+          emigrant.add(island[i][BP::min_index(island[i])]);
+        for(int i = 0; i < Nisland; i++) {
+          BP::BP_Vec<ECISetState> &dest = island[(i + 1) % Nisland];
+          int worst = BP::max_index(dest);
+          if(!contains(dest, emigrant[i].bit_string) && emigrant[i] < dest[worst])
+            dest[worst] = emigrant[i];
+        }
+      }
+
+      // show current gene pool status periodically
+      if(Nfinished % status_interval == 0) {
+        std::cout << "\n---------------------------------------------" << std::endl;
+        std::cout << "Current best, children: " << Nfinished << std::endl;
+        for(int i = 0; i < Nisland; i++) {
+          const ECISetState &best = island[i][BP::min_index(island[i])];
+          std::cout << best.bit_string << "  island: " << std::setw(6) << std::left << i << "  Nclust: " << std::setw(6) << std::left << best.Nclust << "  cv: " << std::setw(12) << best.cv << "  rms: " << std::setw(12) << best.rms << std::endl;
+        }
+        std::cout << cache_status();
+        std::cout << "---------------------------------------------" << std::endl;
+      }
+    }
+  };
+
+  // run the workers, each fits children as soon as it is free
+  std::vector<std::future<void> > result;
+  for(int i = 0; i < pthreads; i++) {
+    result.push_back(scheduler.submit(worker));
+  }
+  for(int i = 0; i < result.size(); i++) {
+    result[i].get();
+  }
+
+  // set the final population, the best unique ECISets of all the islands
+  BP::BP_Vec<ECISetState> gene_pool;
+  for(int k = 0; k < Nisland; k++) {
+    for(int i = 0; i < island[k].size(); i++) {
+      BP::add_once(gene_pool, island[k][i]);
+    }
+  }
+  while(gene_pool.size() > population.size()) {
+    gene_pool.remove(BP::max_index(gene_pool));
+  }
+  for(int i = 0; i < population.size(); i++) {
+    population[i].set_state(gene_pool[i % gene_pool.size()]);
+  }
+
+  std::cout << "\nFinal Population:" << std::endl;
+  std::cout << population_status();
+  std::cout << cache_status();
+
+  //std::cout << "finish Population::ga_async" << std::endl;
+}
+
 void Population::ga_dir(int Ngen, int Nmut, int pthreads) {
   ga(Ngen, Nmut, pthreads, 1);
 }
@@ -352,111 +541,85 @@ void Population::calc(int pthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
+  int ncore = CASM::default_num_threads();
 
   if(pthreads == -1)
     pthreads = ncore < population.size() ? ncore : population.size();
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create Threadpool
-  BP::ThreadPool pool(pthreads);
+  // create TaskScheduler
+  CASM::TaskScheduler scheduler(pthreads);
 
   // fit each ECISet in the population
-  for(int i = 0; i < population.size(); i++) {
-    pool.add_work(ECISet::fit_threaded, &population[i]);
-  }
-  pool.finish();
+  scheduler.parallel_for(0, population.size(), [&](CASM::Index begin, CASM::Index end) {
+    for(CASM::Index i = begin; i < end; i++)
+      population[i].fit();
+  });
 
   std::cout << population_status();
 
   //std::cout << "finish Population::calc" << std::endl;
 }
 
-void Population::calc_all(int N, int pthreads) {
+void Population::calc_all(int N, int K, int pthreads) {
   //std::cout << "begin Population::calc_all" << std::endl;
 
   // Find the optimal cv score considering all combinations of ECISets with N eci
-  // There may be very many possible combinations, so don't set population.size() to number of combinations,
-  //   instead fit Npop=(pthreads*10) combinations at a time. Find the best cv score.
+  // There may be very many possible combinations, so use BestSubset to search them by branch-and-bound,
+  //   fitting only the combinations that could be among the K best.
   // Final population is size=1, with the best cv score.
   std::cout << "Beginning calculation of cv score for all combinations with " << N << " eci." << std::endl << std::endl;
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
+  int ncore = CASM::default_num_threads();
 
   if(pthreads <= 0)
     pthreads = ncore;
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create the ThreadPool
-  BP::ThreadPool pool(pthreads);
+  // create the TaskScheduler
+  CASM::TaskScheduler scheduler(pthreads);
 
-  bool singular;
-  int bestsofar = 0;
   int zero = 0;
-  ECISetState best_state;
 
-  // create BP_Comb object to generate all combinations of ECISets with N eci
   BP::BP_Comb combs(eci_base.size(), N);
 
   std::cout << "This calculates all ecisets with " << N << " eci." << std::endl;
   std::cout << "   For N = " << N << " and ECISet size = " << eci_base.size() << " that will be " << combs.total_combs() << " ecisets." << std::endl << std::endl;
 
+  BestSubset search(get_gram());
+  search.search(N, K, scheduler);
 
+  std::cout << "   Searched " << search.get_Nnode() << " nodes and fit " << search.get_Nleaf() << " ecisets." << std::endl << std::endl;
 
-  // Create Npop ECISets
-  int Npop = 10 * pthreads;
-  int max = Npop;
-  BP::BP_Vec<int> count;
-  for(int i = 0; i < Npop; i++) {
-    count.add();
-    add(eci_base);
+  if(search.size() == 0) {
+    std::cout << "  Error. No non-singular ecisets with " << N << " eci." << std::endl;
+    exit(1);
   }
 
-  do {
-
-    // Fit the current Npop ECISets
-    for(int i = 0; i < Npop; i++) {
-      population[i] = combs;
-      count[i] = combs.get_count();
-      pool.add_work(ECISet::fit_threaded, &population[i]);
-      combs.increment();
-      if(combs.complete()) {
-        max = i;
-        break;
-      }
-    }
-    pool.finish();
-
-    // Track the best cv score
-    for(int i = 0; i < max; i++) {
-      if(best_state.cv == UK || population[i].get_cv() < best_state.cv) {
-        best_state = population[i].get_state();
-        bestsofar = count[i];
-      }
-
-      if(!population[i].get_singular()) {
-        std::cout << population[i].get_bit_string()
-                  << "    i:" << std::setw(12) << count[i] << " "
-                  << "   cv:" << std::setw(12) << population[i].get_cv() << " "
-                  << "   rms:" << std::setw(12) << population[i].get_rms() << " " << std::endl;
-      }
-      else {
-        std::cout << "error, singular" << std::endl;
-      }
-    }
+  // Print the K best, best last
+  BP::BP_Vec<std::string> bit_string;
+  for(int i = 0; i < search.size(); i++) {
+    bit_string.add(std::string(eci_base.size(), '0'));
+    for(int j = 0; j < search.get(i).clust.size(); j++)
+      bit_string[i][search.get(i).clust[j]] = '1';
+  }
+  for(int i = search.size() - 1; i >= 0; i--) {
+    std::cout << bit_string[i]
+              << " rank:" << std::setw(12) << i << " "
+              << "   cv:" << std::setw(12) << search.get(i).cv << " "
+              << "   rms:" << std::setw(12) << search.get(i).rms << " " << std::endl;
   }
-  while(combs.complete() == false);
 
-  // Final population is just the 1 ECISet with the best cv score (no checking for equality...)
+  // Final population is just the 1 ECISet with the best cv score
   population.clear();
-  add(best_state);
+  add(bit_string[zero]);
+  population[zero].fit();
 
-  //std::cout << population[zero].get_bit_string() << "       BestSoFar: " << bestsofar << " Nclust: " << population[zero].get_Nclust_on() << " cv: " << population[zero].get_cv() << " rms: " << population[zero].get_rms() << std::endl;
   std::cout << population[zero].get_bit_string()
-            << " Best:" << std::setw(12) << count[zero] << " "
+            << " Best:" << std::setw(12) << zero << " "
             << "   cv:" << std::setw(12) << population[zero].get_cv() << " "
             << "   rms:" << std::setw(12) << population[zero].get_rms() << " " << std::endl;
 
@@ -820,6 +983,22 @@ std::string Population::minimization_status(const BP::BP_Vec<Minimize> &minimiza
   return result;
 }
 
+std::string Population::cache_status() const {
+
+  // returns a string containing the number of unique ECISets fit, and the number of fits avoided
+
+  stringstream ss;
+  ss << "Fit cache: " << cache.size() << " ECISets fit, " << cache.get_Nhit() << " repeated fits avoided" << std::endl;
+  return ss.str();
+}
+
+std::shared_ptr<const GramMatrix> Population::get_gram() {
+  std::lock_guard<std::mutex> lock(gram_mutex);
+  if(!gram)
+    gram = std::make_shared<GramMatrix>(corr, nrg);
+  return gram;
+}
+
 std::string Population::gene_pool_status(const BP::BP_Vec<ECISetState> &gene_pool) const {
 
   // returns a string containing details about the curent gene_pool: Nclust, cv, rms
@@ -5,12 +5,17 @@
 #ifndef Population_HH
 #define Population_HH
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unistd.h>
 #include "BP_GVec.hh"
 #include "ECISet.hh"
 #include "Functions.hh"
 #include "Minimize.hh"
+#include "FitCache.hh"
+#include "BestSubset.hh"
+#include "GramMatrix.hh"
 
 
 // This class contains a population of ECISets
@@ -19,6 +24,11 @@
 //   direct: direct (steepest-descent) minimization
 //   dfs: depth first search minimization
 //   ga: genetic algorithm
+//   ga_async: steady-state genetic algorithm, with asynchronous fitting and islands
+//
+//   All fits are stored in a FitCache, so an ECISet is only fit once during the lifetime of
+//   the Population, no matter which method, or which thread, encounters it. All fitters share
+//   one GramMatrix, so it is only computed once.
 //
 class Population {
 private:
@@ -29,6 +39,13 @@ private:
 
   MTRand mtrand;
 
+  // fits of all ECISets seen so far, shared by all methods and threads
+  FitCache cache;
+
+  // Gram matrix for 'corr' and 'nrg', shared by all fitters, computed on first use
+  std::shared_ptr<const GramMatrix> gram;
+  std::mutex gram_mutex;
+
   // the population of ECISets
   //   these should be added via the 'add' methods to ensure that ECISet.set_data is called
   BP::BP_Vec<ECISet> population;
@@ -82,6 +99,12 @@ public:
   // Genetic algorithm to optimize the population
   void ga(int Ngen, int Nmut, int pthreads = -1, int mode = 0, int Nstop = 1);
 
+  // Steady-state genetic algorithm: each of 'pthreads' workers repeatedly mates, fits, and
+  //   inserts a child, without waiting for the others. The population is split into Nisland
+  //   islands, and every Nmigrate*population.size() children the best ECISet of each island
+  //   migrates to the next. Ngen*population.size() children are created in total.
+  void ga_async(int Ngen, int Nmut, int Nisland, int Nmigrate, int pthreads = -1);
+
   // Genetic algorithm, with direct minimization of each child
   void ga_dir(int Ngen, int Nmut, int pthreads = -1);
 
@@ -91,8 +114,8 @@ public:
   // Calculate cv for all ECISet in population
   void calc(int pthreads = -1);
 
-  // Calculate cv for all ECISets with N eci, based on eci_base
-  void calc_all(int N, int pthreads);
+  // Find the K ECISets with N eci, based on eci_base, with the lowest cv
+  void calc_all(int N, int K, int pthreads);
 
   // Calculate & write hull, energy.clex, etc. files for population[index]
   void calc_details(int index, std::string out_format, double hulltol = 1.0e-14);
@@ -117,6 +140,12 @@ private:
   // Return a string containing the status of the gene pool
   std::string gene_pool_status(const BP::BP_Vec<ECISetState> &gene_pool) const;
 
+  // Return a string containing the number of fits and cache hits
+  std::string cache_status() const;
+
+  // Return the Gram matrix for 'corr' and 'nrg', computing it if necessary
+  std::shared_ptr<const GramMatrix> get_gram();
+
 };
 
 #endif // Population_HH
@@ -43,9 +43,14 @@ namespace CASM {
 #include "BP_Geo.cc"
 #include "BP_Parse.cc"
 #include "BP_StopWatch.cc"
-#include "BP_ThreadPool.cc"
+#include "TaskScheduler.cc"
 #include "Correlation.cc"
 #include "ECISet.cc"
+#include "GramMatrix.cc"
+#include "IncrementalFit.cc"
+#include "L1Path.cc"
+#include "BestSubset.cc"
+#include "FitCache.cc"
 #include "EnergySet.cc"
 #include "GeneticAlgorithm.cc"
 #include "Functions.cc"
@@ -59,7 +64,7 @@ void print_ecistats_man() {
   std::cout << "  eci_search -ecistats energy eci.in corr.in population_file" << std::endl;
 }
 void print_calc_all_man() {
-  std::cout << "  eci_search -calc_all N energy eci.in corr.in" << std::endl;
+  std::cout << "  eci_search -calc_all N energy eci.in corr.in [K]" << std::endl;
 }
 void print_calc_directmin_man() {
   std::cout << "  eci_search -calc_directmin Nrand Nmin Nmax energy eci.in corr.in [population_file]" << std::endl;
@@ -70,6 +75,9 @@ void print_calc_dfsmin_man() {
 void print_calc_ga_man() {
   std::cout << "  eci_search -calc_ga Npop Nmin Nmax Ngen Nmut energy eci.in corr.in [population_file]" << std::endl;
 }
+void print_calc_ga_async_man() {
+  std::cout << "  eci_search -calc_ga_async Npop Nmin Nmax Ngen Nmut Nisland Nmigrate energy eci.in corr.in [population_file]" << std::endl;
+}
 void print_calc_ga_dir_man() {
   std::cout << "  eci_search -calc_ga_dir Npop Nmin Nmax Ngen Nmut energy eci.in corr.in [population_file]" << std::endl;
 }
@@ -94,6 +102,7 @@ void print_convert_man() {
   std::cout << "  eci_search -convert-eci-to-json eci.in [...]" << std::endl;
   std::cout << "  eci_search -convert-corr-to-text corr.in.json [...]" << std::endl;
   std::cout << "  eci_search -convert-corr-to-json corr.in [...]" << std::endl;
+  std::cout << "  eci_search -convert-corr-to-binary corr.in [...]" << std::endl;
 }
 void print_calc_cs_fpc_man() {
   std::cout << "  eci_search -calc_cs_fpc energy eci.in corr.in mu" << std::endl;
@@ -101,6 +110,9 @@ void print_calc_cs_fpc_man() {
 void print_calc_cs_bi_man() {
   std::cout << "  eci_search -calc_cs_bi energy eci.in corr.in mu" << std::endl;
 }
+void print_calc_cs_path_man() {
+  std::cout << "  eci_search -calc_cs_path energy eci.in corr.in mu_min [Nmu [Nfold]]" << std::endl;
+}
 
 void print_calc_full_man() {
   std::cout << "  eci_search -calc energy eci.in corr.in [bitstring | bitstring_file]" << std::endl;
@@ -147,8 +159,11 @@ void print_ecistats_full_man() {
 
 }
 void print_calc_all_full_man() {
-  std::cout << "  eci_search -calc_all N energy eci.in corr.in" << std::endl;
-  std::cout << "      This calculates eci for all possible ecisets with N eci." << std::endl;
+  std::cout << "  eci_search -calc_all N energy eci.in corr.in [K]" << std::endl;
+  std::cout << "      This finds the K (default 1) ecisets with N eci that have the lowest " << std::endl;
+  std::cout << "      cv score, out of all possible ecisets with N eci. The search is a     " << std::endl;
+  std::cout << "      branch-and-bound, using rms <= cv to skip sets of ecisets that can not " << std::endl;
+  std::cout << "      be among the K best, so only a small fraction of them are fit.        " << std::endl;
   std::cout << std::endl << std::endl;
 
 }
@@ -255,6 +270,24 @@ void print_calc_ga_dir_full_man() {
   std::cout << "      -calc_directmin.                                                      " << std::endl;
   std::cout << std::endl << std::endl;
 
+}
+void print_calc_ga_async_full_man() {
+  std::cout << "  eci_search -calc_ga_async Npop Nmin Nmax Ngen Nmut Nisland Nmigrate energy eci.in corr.in [population_file]" << std::endl;
+  std::cout << "      This is a steady-state version of -calc_ga. Instead of fitting a whole" << std::endl;
+  std::cout << "      generation of children at once, each thread repeatedly creates a     " << std::endl;
+  std::cout << "      child, fits it, and replaces the eciset with the highest cv score if " << std::endl;
+  std::cout << "      the child's cv score is lower, so no thread waits for the others.    " << std::endl;
+  std::cout << "      Ngen*Npop children are created in total.                             " << std::endl;
+  std::cout << "                                                                           " << std::endl;
+  std::cout << "      The population is split into Nisland islands, which evolve           " << std::endl;
+  std::cout << "      separately, except that every Nmigrate*Npop children the best eciset " << std::endl;
+  std::cout << "      of each island replaces the worst of the next island. Each island    " << std::endl;
+  std::cout << "      must have at least 2 ecisets. Mating is done as in -calc_ga.         " << std::endl;
+  std::cout << "                                                                           " << std::endl;
+  std::cout << "      Fits are cached by bitstring, so each eciset is only fit once. The   " << std::endl;
+  std::cout << "      cache is also used by -calc_ga, -calc_ga_dir, and -calc_ga_dfs.      " << std::endl;
+  std::cout << std::endl << std::endl;
+
 }
 void print_calc_ga_dfs_full_man() {
   std::cout << "  eci_search -calc_ga_dfs Npop Nmin Nmax Nchild Nmut Nstop energy eci.in corr.in [population_file]" << std::endl;
@@ -312,7 +345,12 @@ void print_convert_full_man() {
   std::cout << "  eci_search -convert-eci-to-json eci.in [...]" << std::endl;
   std::cout << "  eci_search -convert-corr-to-text corr.in.json [...]" << std::endl;
   std::cout << "  eci_search -convert-corr-to-json corr.in [...]" << std::endl;
+  std::cout << "  eci_search -convert-corr-to-binary corr.in [...]" << std::endl;
   std::cout << "      Convert 'energy', 'eci.in', and 'corr.in' files to/from json          " << std::endl;
+  std::cout << "      'corr.in' files may also be converted to/from binary 'corr.in.bin'    " << std::endl;
+  std::cout << "      files, as written by 'casm fit --binary'. These are memory-mapped     " << std::endl;
+  std::cout << "      rather than parsed, which is much faster for large training sets.     " << std::endl;
+  std::cout << "      Any command that takes 'corr.in' accepts 'corr.in.bin'.               " << std::endl;
 
 }
 void print_calc_cs_fpc_full_man() {
@@ -329,6 +367,17 @@ void print_calc_cs_bi_full_man() {
   std::cout << "      See Nelson, Hart, Zhou, and Ozolins, PRB, 87, 035125 (2013).          " << std::endl;
   std::cout << std::endl << std::endl;
 }
+void print_calc_cs_path_full_man() {
+  std::cout << "  eci_search -calc_cs_path energy eci.in corr.in mu_min [Nmu [Nfold]]" << std::endl;
+  std::cout << "      This solves the same problem as -calc_cs_fpc for Nmu values of mu     " << std::endl;
+  std::cout << "      (default 50), from the smallest mu that turns all ECI off down to     " << std::endl;
+  std::cout << "      mu_min, evenly spaced on a log scale. Each mu is solved by coordinate  " << std::endl;
+  std::cout << "      descent, starting from the solution for the previous mu. The cv score " << std::endl;
+  std::cout << "      is calculated by Nfold-fold cross validation (default 10, use 1 for   " << std::endl;
+  std::cout << "      none), and the eciset with the lowest cv score is kept. Use -pthreads " << std::endl;
+  std::cout << "      to set the number of threads used to solve the folds in parallel.     " << std::endl;
+  std::cout << std::endl << std::endl;
+}
 
 void print_eci_search_quick_man() {
   std::cout << "*** eci_search quick manual ***" << std::endl;
@@ -339,6 +388,7 @@ void print_eci_search_quick_man() {
   print_calc_directmin_man();
   print_calc_dfsmin_man();
   print_calc_ga_man();
+  print_calc_ga_async_man();
   print_calc_ga_dir_man();
   print_calc_ga_dfs_man();
   print_weight_nrg_man();
@@ -349,6 +399,7 @@ void print_eci_search_quick_man() {
   std::cout << std::endl << "  * under development *" << std::endl;
   print_calc_cs_fpc_man();
   print_calc_cs_bi_man();
+  print_calc_cs_path_man();
 
   std::cout << "\n\n  Note: Use 'FixOn' or 'FixOff' for the 'weight' in the 'eci.in' file to set particular eci on/off manually." << std::endl << std::endl;
 
@@ -385,6 +436,7 @@ void print_eci_search_man() {
   print_calc_directmin_full_man();
   print_calc_dfsmin_full_man();
   print_calc_ga_full_man();
+  print_calc_ga_async_full_man();
   print_calc_ga_dir_full_man();
   print_calc_ga_dfs_full_man();
   print_weight_nrg_full_man();
@@ -396,6 +448,7 @@ void print_eci_search_man() {
   print_calc_cs_fpc_full_man();
   std::cout << "  * under development *" << std::endl;
   print_calc_cs_bi_full_man();
+  print_calc_cs_path_full_man();
 
 };
 
@@ -651,6 +704,20 @@ int main(int argc, char *argv[]) {
         print_convert_man();
       }
 
+    }
+    else if(args[1] == "-convert-corr-to-binary") {
+      //eci_search -convert-corr-to-binary corr.in [...]
+      if(argc > 2) {
+
+        for(int i = 2; i < args.size(); i++) {
+          Correlation corr(args[i]);
+          corr.write(args[i], "binary");
+        }
+      }
+      else {
+        print_convert_man();
+      }
+
     }
     else if(args[1] == "-calc_cs_fpc") {
       //eci_search -calc_cs_fpc energy eci.in corr.in mu
@@ -679,6 +746,24 @@ int main(int argc, char *argv[]) {
         //print_calc_man();
       }
 
+    }
+    else if(args[1] == "-calc_cs_path") {
+      //eci_search -calc_cs_path energy eci.in corr.in mu_min [Nmu [Nfold]]
+      if(argc >= 6 && argc <= 8) {
+        int Nmu = 50;
+        int Nfold = 10;
+        if(argc >= 7)
+          Nmu = BP::stoi(args[6]);
+        if(argc == 8)
+          Nfold = BP::stoi(args[7]);
+
+        calc_cs_path_eci(args[2], args[3], args[4], BP::stod(args[5]), Nmu, Nfold, HULLTOL);
+      }
+      else {
+        print_calc_cs_path_man();
+        return 1;
+      }
+
     }
     else if(args[1] == "-ecistats") {
       //eci_search -ecistats energy eci.in corr.in population_file
@@ -714,30 +799,25 @@ int main(int argc, char *argv[]) {
 
     }
     else if(args[1] == "-calc_all") {
-      if(!NEW) {
-        if(argc == 6) {
-          //eci_search -calc_all N energy eci.in corr.in
-          calc_all_eci(BP::stoi(args[2]), args[3], args[4], args[5]);
+      if(argc == 6 || argc == 7) {
+        //eci_search -calc_all N energy eci.in corr.in [K]
+        int K = 1;
+        if(argc == 7)
+          K = BP::stoi(args[6]);
+
+        if(!NEW) {
+          calc_all_eci(BP::stoi(args[2]), K, args[3], args[4], args[5]);
         }
         else {
-          //std::cout << "print_eci_search_man()" << std::endl;
-          print_calc_all_man();
-
-          return 1;
+          Population population(0, 0, args[3], args[4], args[5]);
+          population.calc_all(BP::stoi(args[2]), K, PTHREADS);
         }
       }
       else {
-        if(argc == 6) {
-          //eci_search -calc_all N energy eci.in corr.in
-          Population population(0, 0, args[3], args[4], args[5]);
-          population.calc_all(BP::stoi(args[2]), PTHREADS);
-        }
-        else {
-          //std::cout << "print_eci_search_man()" << std::endl;
-          print_calc_all_man();
+        //std::cout << "print_eci_search_man()" << std::endl;
+        print_calc_all_man();
 
-          return 1;
-        }
+        return 1;
       }
     }
     else if(args[1] == "-calc_directmin") {
@@ -953,6 +1033,34 @@ int main(int argc, char *argv[]) {
         }
       }
     }
+    else if(args[1] == "-calc_ga_async") {
+      //eci_search -calc_ga_async Npop Nmin Nmax Ngen Nmut Nisland Nmigrate energy eci.in corr.in [population_file]
+      if(argc == 12 || argc == 13) {
+        int Npopulation = BP::stoi(args[2]);
+        int Nmin = BP::stoi(args[3]);
+        int Nmax = BP::stoi(args[4]);
+        int Ngenerations = BP::stoi(args[5]);
+        int Nmutations = BP::stoi(args[6]);
+        int Nisland = BP::stoi(args[7]);
+        int Nmigrate = BP::stoi(args[8]);
+        Population population(Nmin, Nmax, args[9], args[10], args[11]);
+
+        if(argc == 12)
+          population.populate(Npopulation);
+        else
+          population.populate(args[12]);
+
+        population.ga_async(Ngenerations, Nmutations, Nisland, Nmigrate, PTHREADS);
+
+        population.write(unique("population"), "default");
+      }
+      else {
+        //std::cout << "print_eci_search_man()" << std::endl;
+        print_calc_ga_async_man();
+
+        return 1;
+      }
+    }
     else if(args[1] == "-calc_ga_dir") {
       //eci_search -calc_ga_dir Npop Nmin Nmax Nchild Nmut energy eci.in corr.in [population_file]
       if(!NEW) {
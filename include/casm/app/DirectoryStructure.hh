@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <boost/filesystem.hpp>
+#include "casm/misc/CASM_math.hh"
 
 
 namespace CASM {
@@ -106,6 +107,37 @@ namespace CASM {
       return m_root / m_casm_dir / "config_list.json";
     }
 
+    /// \brief Return master configuration database path
+    fs::path config_db() const {
+      return m_root / m_casm_dir / "config_list.bin";
+    }
+
+    /// \brief Return master configuration database journal path
+    fs::path config_journal() const {
+      return m_root / m_casm_dir / "config_list.journal";
+    }
+
+    /// \brief Return directory for cached convex hulls
+    fs::path hull_cache_dir() const {
+      return m_root / m_casm_dir / "hull_cache";
+    }
+
+    /// \brief Return cached convex hull path, for the hull of calculated energies of the
+    ///        configurations in 'selection'
+    fs::path hull_cache(std::string calctype, std::string ref, std::string selection) const {
+      return hull_cache_dir() / (_calctype(calctype) + "." + _ref(ref) + "." + stable_hash({selection}) + ".json");
+    }
+
+    /// \brief Return cached convex hull path for 'casm query', for the hull described by 'key'
+    fs::path hull_cache_query(std::string key) const {
+      return hull_cache_dir() / ("query." + stable_hash({key}) + ".json");
+    }
+
+    /// \brief Return directory for checkpoints of 'casm enum --checkpoint' for a supercell
+    fs::path enum_checkpoint_dir(std::string scelname) const {
+      return m_root / m_casm_dir / "enum" / scelname;
+    }
+
 
     // -- Symmetry --------
 
@@ -269,6 +301,11 @@ namespace CASM {
       return eci_dir(clex, calctype, ref, bset, eci) / "eci.out";
     }
 
+    /// \brief Returns path to the source file of the clexulator with eci.out folded in, in eci fitting directory
+    fs::path eci_clexulator_src(std::string project, std::string clex, std::string calctype, std::string ref, std::string bset, std::string eci) const {
+      return eci_dir(clex, calctype, ref, bset, eci) / (project + "_" + clex + "_Clexulator.cc");
+    }
+
     /// \brief Returns path to eci.in, in eci fitting directory
     fs::path energy(std::string clex, std::string calctype, std::string ref, std::string bset, std::string eci) const {
       return eci_dir(clex, calctype, ref, bset, eci) / "energy";
@@ -137,6 +137,11 @@ namespace CASM {
       return name() + "_Clexulator";
     }
 
+    /// \brief Name of the clexulator with the ECI of cluster expansion 'clex' folded in
+    std::string eci_clexulator(std::string clex) const {
+      return name() + "_" + clex + "_Clexulator";
+    }
+
 
     // ** Add directories for additional project data **
 
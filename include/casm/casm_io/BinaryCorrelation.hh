@@ -0,0 +1,105 @@
+#ifndef CASM_BinaryCorrelation
+#define CASM_BinaryCorrelation
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CASM {
+
+  /// \brief Binary correlation matrix file, as written by 'casm fit --binary' and read by eci_search
+  ///
+  /// File layout:
+  /// - a 64 byte header: the 8 character magic "CASMCORR", then the number of configurations and
+  ///   the number of correlations as uint64_t, and zero padding, so that the matrix that follows
+  ///   is aligned when the file is memory-mapped
+  /// - the Nconfig x Ncorr correlation matrix, as double in column-major order, so that a
+  ///   correlation for all configurations is contiguous
+  ///
+  /// All values are in native byte order.
+  namespace BinaryCorrelation {
+
+    const std::string magic = "CASMCORR";
+
+    const std::size_t header_size = 64;
+
+    /// \brief Write the header for an Nconfig x Ncorr matrix
+    inline void write_header(std::ostream &sout, std::uint64_t Nconfig, std::uint64_t Ncorr) {
+      char header[header_size];
+      std::memset(header, 0, header_size);
+      std::memcpy(header, magic.data(), magic.size());
+      std::memcpy(header + magic.size(), &Nconfig, sizeof(Nconfig));
+      std::memcpy(header + magic.size() + sizeof(Nconfig), &Ncorr, sizeof(Ncorr));
+      sout.write(header, header_size);
+    }
+
+    /// \brief Read the header from the first 'size' bytes of a file
+    ///
+    /// \returns false if 'data' does not begin with a valid header, or is too small to hold the matrix
+    inline bool read_header(const char *data, std::size_t size, std::uint64_t &Nconfig, std::uint64_t &Ncorr) {
+      if(size < header_size || std::memcmp(data, magic.data(), magic.size()) != 0) {
+        return false;
+      }
+      std::memcpy(&Nconfig, data + magic.size(), sizeof(Nconfig));
+      std::memcpy(&Ncorr, data + magic.size() + sizeof(Nconfig), sizeof(Ncorr));
+
+      std::uint64_t max_count = (size - header_size) / sizeof(double);
+      return Ncorr == 0 || Nconfig <= max_count / Ncorr;
+    }
+
+    /// \brief Write the header and the column-major Nconfig x Ncorr matrix 'data'
+    ///
+    /// Check the state of 'sout' afterwards for errors
+    inline void write(std::ostream &sout, std::uint64_t Nconfig, std::uint64_t Ncorr, const double *data) {
+      write_header(sout, Nconfig, Ncorr);
+      sout.write(reinterpret_cast<const char *>(data), Nconfig * Ncorr * sizeof(double));
+    }
+
+    /// \brief Memory-map the file 'filename', and get the column-major Nconfig x Ncorr matrix it holds
+    ///
+    /// The file is unmapped when the last copy of the returned pointer is destroyed.
+    /// Throws std::runtime_error if the file can not be mapped or is not a binary correlation file.
+    inline std::shared_ptr<const double> map(const std::string &filename, std::uint64_t &Nconfig, std::uint64_t &Ncorr) {
+
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0) {
+        throw std::runtime_error("could not open file");
+      }
+
+      struct stat st;
+      if(::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(header_size)) {
+        ::close(fd);
+        throw std::runtime_error("not a binary correlation file");
+      }
+      std::size_t map_size = st.st_size;
+
+      void *ptr = ::mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(ptr == MAP_FAILED) {
+        throw std::runtime_error("could not map file");
+      }
+      const char *map = static_cast<const char *>(ptr);
+
+      if(!read_header(map, map_size, Nconfig, Ncorr)) {
+        ::munmap(ptr, map_size);
+        throw std::runtime_error("not a binary correlation file");
+      }
+
+      return std::shared_ptr<const double>(reinterpret_cast<const double *>(map + header_size), [ptr, map_size](const double * p) {
+        ::munmap(ptr, map_size);
+      });
+    }
+
+  }
+
+}
+
+#endif
@@ -6,12 +6,17 @@
 #include <sstream>
 #include <vector>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 #include <boost/tokenizer.hpp>
 #include "casm/CASM_global_definitions.hh"
 #include "casm/misc/CASM_math.hh"
 #include "casm/casm_io/jsonParser.hh"
 #include "casm/casm_io/DataStream.hh"
 #include "casm/casm_io/FormatFlag.hh"
+#include "casm/system/TaskScheduler.hh"
 
 
 namespace CASM {
@@ -21,6 +26,75 @@ namespace CASM {
   template<typename DataObject>
   class BaseDatumFormatter;
 
+  /// \brief Values derived from a DataObject, shared by all the DatumFormatters that format it
+  ///
+  /// DataFormatter opens a DataFormatterContext::Scope for the object it is formatting. Within
+  /// it, DatumFormatters obtain values derived from the object (correlations, composition, etc.)
+  /// with DataFormatterContext::get, so that a value needed by several columns of a row is only
+  /// computed once. Scopes for the same object nest, so a DataFormatter used inside a
+  /// DatumFormatter shares the values of the enclosing row.
+  ///
+  /// Each thread has its own stack of scopes, so rows may be formatted in parallel.
+  ///
+  class DataFormatterContext {
+  public:
+
+    /// \brief Makes 'obj' the object whose values are shared, until destruction
+    class Scope {
+    public:
+      explicit Scope(const void *obj) :
+        m_pushed(false) {
+        std::vector<Frame> &stack(_stack());
+        if(stack.empty() || stack.back().obj != obj) {
+          stack.push_back(Frame(obj));
+          m_pushed = true;
+        }
+      }
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+      ~Scope() {
+        if(m_pushed)
+          _stack().pop_back();
+      }
+
+    private:
+      bool m_pushed;
+    };
+
+    /// \brief Returns the value 'key' of the object of the current Scope, computing it with 'f()'
+    ///        the first time it is requested
+    ///
+    /// 'key' must identify both the quantity and anything it depends on other than the object
+    /// (e.g., "corr(" + clexulator.name() + ")"). Outside of any Scope, 'f()' is always called.
+    template<typename T, typename F>
+    static T get(const std::string &key, F f) {
+      std::vector<Frame> &stack(_stack());
+      if(stack.empty())
+        return f();
+      std::shared_ptr<void> &value = stack.back().value[key];
+      if(!value)
+        value = std::make_shared<T>(f());
+      return *std::static_pointer_cast<T>(value);
+    }
+
+  private:
+
+    struct Frame {
+      explicit Frame(const void *_obj) :
+        obj(_obj) {}
+
+      const void *obj;
+      std::map<std::string, std::shared_ptr<void> > value;
+    };
+
+    static std::vector<Frame> &_stack() {
+      static thread_local std::vector<Frame> stack;
+      return stack;
+    }
+  };
+
   /* A DataFormatter performs extraction of disparate types of data from a 'DataObject' class that contains
    * various types of unasociated 'chunks' of data.
    * The DataFormatter is composed of one or more 'DatumFormatters', with each DatumFormatter knowing how to
@@ -116,6 +190,9 @@ namespace CASM {
     /// Verify that _obj has valid data for all portions of query
     bool validate(const DataObject &_obj) const;
 
+    /// Returns true if copies of *this may format objects on concurrent threads
+    bool thread_safe_clone() const;
+
     ///Output selected data from DataObject to DataStream
     void inject(const DataObject &_obj, DataStream &_stream) const;
 
@@ -181,6 +258,20 @@ namespace CASM {
     std::string m_comment;
 
     void _initialize(const DataObject &_tmplt) const;
+
+    /// For each object in [begin, end), call 'eval(formatter, obj, result)' and then, in order, 'write(result)'
+    template<typename ResultType, typename IteratorType, typename Eval, typename Write>
+    void _for_each_row(IteratorType begin, IteratorType end, Eval eval, Write write) const {
+      _for_each_row<ResultType>(begin, end, eval, write, std::is_lvalue_reference<decltype(*begin)>());
+    }
+
+    /// Iterators that give references: evaluate rows in parallel
+    template<typename ResultType, typename IteratorType, typename Eval, typename Write>
+    void _for_each_row(IteratorType begin, IteratorType end, Eval eval, Write write, std::true_type) const;
+
+    /// Iterators that give temporaries: evaluate rows in order
+    template<typename ResultType, typename IteratorType, typename Eval, typename Write>
+    void _for_each_row(IteratorType begin, IteratorType end, Eval eval, Write write, std::false_type) const;
   };
 
   /*
@@ -224,6 +315,12 @@ namespace CASM {
 
     };
 
+    /// \brief Returns false if clones of this formatter must not be used by concurrent threads,
+    /// e.g., because they share state that is not copied by clone()
+    virtual bool thread_safe_clone() const {
+      return true;
+    }
+
     ///\brief Returns true if _data_obj has valid values for requested data
     virtual bool validate(const DataObject &_data_obj) const {
       return true;
@@ -348,14 +445,26 @@ namespace CASM {
       }
       format.print_header(false);
       _stream << format;
-      for(IteratorType it(m_begin_it); it != m_end_it; ++it)
-        m_formatter_ptr->print(*it, _stream);
+      m_formatter_ptr->template _for_each_row<std::string>(m_begin_it, m_end_it,
+      [](const DataFormatter<DataObject> &_formatter, const DataObject &_obj, std::string &_row) {
+        std::stringstream t_ss;
+        _formatter.print(_obj, t_ss);
+        _row = t_ss.str();
+      },
+      [&](const std::string &_row) {
+        _stream << _row;
+      });
     }
 
     jsonParser &to_json(jsonParser &json) const {
       json.put_array();
-      for(IteratorType it(m_begin_it); it != m_end_it; ++it)
-        json.push_back((*m_formatter_ptr)(*it));
+      m_formatter_ptr->template _for_each_row<jsonParser>(m_begin_it, m_end_it,
+      [](const DataFormatter<DataObject> &_formatter, const DataObject &_obj, jsonParser &_row) {
+        _formatter.to_json(_obj, _row);
+      },
+      [&](const jsonParser &_row) {
+        json.push_back(_row);
+      });
       return json;
     }
 
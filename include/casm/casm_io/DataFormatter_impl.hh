@@ -44,6 +44,7 @@ namespace CASM {
   bool DataFormatter<DataObject>::validate(const DataObject &_obj) const {
     if(!m_initialized)
       _initialize(_obj);
+    DataFormatterContext::Scope scope(&_obj);
     for(Index i = 0; i < m_data_formatters.size(); i++)
       if(!m_data_formatters[i]->validate(_obj))
         return false;
@@ -53,10 +54,22 @@ namespace CASM {
 
   //******************************************************************************
 
+  template<typename DataObject>
+  bool DataFormatter<DataObject>::thread_safe_clone() const {
+    for(Index i = 0; i < m_data_formatters.size(); i++)
+      if(!m_data_formatters[i]->thread_safe_clone())
+        return false;
+
+    return true;
+  }
+
+  //******************************************************************************
+
   template<typename DataObject>
   void DataFormatter<DataObject>::inject(const DataObject &_obj, DataStream &_stream) const {
     if(!m_initialized)
       _initialize(_obj);
+    DataFormatterContext::Scope scope(&_obj);
 
     Index num_pass(1), tnum;
     for(Index i = 0; i < m_data_formatters.size(); i++) {
@@ -87,6 +100,7 @@ namespace CASM {
   void DataFormatter<DataObject>::print(const DataObject &_obj, std::ostream &_stream) const {
     if(!m_initialized)
       _initialize(_obj);
+    DataFormatterContext::Scope scope(&_obj);
     _stream << std::setprecision(m_prec) << std::fixed;
     Index num_pass(1), tnum;
     for(Index i = 0; i < m_data_formatters.size(); i++) {
@@ -131,6 +145,7 @@ namespace CASM {
   jsonParser &DataFormatter<DataObject>::to_json(const DataObject &_obj, jsonParser &json) const {
     if(!m_initialized)
       _initialize(_obj);
+    DataFormatterContext::Scope scope(&_obj);
     for(Index i = 0; i < m_data_formatters.size(); i++) {
       m_data_formatters[i]->to_json(_obj, json[m_data_formatters[i]->short_header(_obj)]);
     }
@@ -145,6 +160,7 @@ namespace CASM {
     _stream << m_comment;
     if(!m_initialized)
       _initialize(_template_obj);
+    DataFormatterContext::Scope scope(&_template_obj);
     int header_size, twidth;
     for(Index i = 0; i < m_data_formatters.size(); i++) {
       std::stringstream t_ss;
@@ -174,6 +190,78 @@ namespace CASM {
     return;
   }
 
+  //******************************************************************************
+  /// Objects are formatted in batches. The rows of a batch are divided among the threads of the
+  /// global TaskScheduler, each formatting with its own copy of *this so that the mutable state of
+  /// the DatumFormatters (e.g., a Clexulator) is not shared, and then written in order. If any
+  /// DatumFormatter can not be cloned for use on another thread, the rows are formatted in order.
+  template<typename DataObject> template<typename ResultType, typename IteratorType, typename Eval, typename Write>
+  void DataFormatter<DataObject>::_for_each_row(IteratorType begin, IteratorType end, Eval eval, Write write, std::true_type) const {
+    if(begin == end)
+      return;
+    if(!m_initialized)
+      _initialize(*begin);
+
+    if(num_threads() == 1 || !thread_safe_clone()) {
+      _for_each_row<ResultType>(begin, end, eval, write, std::false_type());
+      return;
+    }
+
+    // rows per task, and rows per batch
+    const Index grain = 16;
+    const Index batch_size = 16 * grain * num_threads();
+
+    // copies of *this not currently in use by a thread
+    std::mutex pool_mutex;
+    std::vector<std::unique_ptr<DataFormatter<DataObject> > > pool;
+
+    std::vector<const DataObject *> batch;
+    std::vector<ResultType> result;
+    IteratorType it(begin);
+    while(it != end) {
+      batch.clear();
+      for(; it != end && batch.size() < batch_size; ++it)
+        batch.push_back(&(*it));
+      result.assign(batch.size(), ResultType());
+
+      parallel_for(0, batch.size(), [&](Index row_begin, Index row_end) {
+        std::unique_ptr<DataFormatter<DataObject> > tformat;
+        {
+          std::lock_guard<std::mutex> lock(pool_mutex);
+          if(!pool.empty()) {
+            tformat = std::move(pool.back());
+            pool.pop_back();
+          }
+        }
+        if(!tformat) {
+          // the cloned DatumFormatters are already initialized
+          tformat.reset(new DataFormatter<DataObject>(*this));
+          tformat->m_initialized = true;
+        }
+
+        for(Index i = row_begin; i < row_end; i++)
+          eval(*tformat, *batch[i], result[i]);
+
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool.push_back(std::move(tformat));
+      }, grain);
+
+      for(Index i = 0; i < result.size(); i++)
+        write(result[i]);
+    }
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject> template<typename ResultType, typename IteratorType, typename Eval, typename Write>
+  void DataFormatter<DataObject>::_for_each_row(IteratorType begin, IteratorType end, Eval eval, Write write, std::false_type) const {
+    for(IteratorType it(begin); it != end; ++it) {
+      ResultType result;
+      eval(*this, *it, result);
+      write(result);
+    }
+  }
+
   //******************************************************************************
 
   template<typename DataObject>
@@ -0,0 +1,96 @@
+#ifndef CLEXEVALUATOR_HH
+#define CLEXEVALUATOR_HH
+
+#include <vector>
+
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/ECIContainer.hh"
+
+namespace CASM {
+
+  class ConfigDoF;
+  class Supercell;
+  class Configuration;
+
+  /// \brief True if 'clexulator' was printed with exactly the non-zero ECI of 'eci' folded in
+  bool has_folded_eci(const Clexulator &clexulator, const ECIContainer &eci);
+
+  /// \brief Evaluates a cluster expansion, using only the basis functions with non-zero ECI
+  ///
+  /// ECIContainer * correlations(config, clexulator) evaluates every basis function, and then
+  /// uses only those in ECIContainer::eci_index_list(). ClexEvaluator instead uses
+  /// Clexulator::calc_restricted_global_corr_contribution, so that after a sparse fit only a small
+  /// fraction of the basis functions are evaluated.
+  ///
+  /// If the Clexulator was printed with the same ECI folded in (see PrimClex::eci_clexulator),
+  /// its fused Clexulator::calc_global_energy_contribution kernel is used instead.
+  ///
+  /// Like Clexulator, a ClexEvaluator is not thread safe; use a copy for each thread.
+  ///
+  class ClexEvaluator {
+
+  public:
+
+    typedef Clexulator::size_type size_type;
+
+    ClexEvaluator() {}
+
+    /// \brief Construct a ClexEvaluator, throws if 'eci' has an index out of range for 'clexulator'
+    ClexEvaluator(const Clexulator &clexulator, const ECIContainer &eci);
+
+    const Clexulator &clexulator() const {
+      return m_clexulator;
+    }
+
+    const ECIContainer &eci() const {
+      return m_eci;
+    }
+
+    /// \brief Indices of the correlations that are evaluated, those with non-zero ECI
+    const std::vector<size_type> &index_list() const {
+      return m_index;
+    }
+
+    /// \brief True if the Clexulator's fused kernel, with the same ECI folded in, is used
+    bool fused() const {
+      return m_fused;
+    }
+
+    /// \brief Cluster expansion value of 'configdof', normalized per primitive cell
+    double operator()(const ConfigDoF &configdof, const Supercell &scel);
+
+    /// \brief Cluster expansion value of 'config', normalized per primitive cell
+    double operator()(const Configuration &config);
+
+    /// \brief Cluster expansion value, normalized per unit cell
+    ///
+    /// \param occ_begin Pointer to occupation variables
+    /// \param nlist_begin Pointer to neighbor lists of all unit cells, row-major N_unitcell x clexulator().nlist_size()
+    /// \param N_unitcell Number of unit cells
+    ///
+    double operator()(const int *occ_begin, const long int *nlist_begin, size_type N_unitcell);
+
+  private:
+
+    /// \brief Contribution of the unit cell the Clexulator neighbor list is set to
+    double _unitcell_value();
+
+    Clexulator m_clexulator;
+
+    ECIContainer m_eci;
+
+    // the non-zero ECI, and the indices of their correlations
+    std::vector<size_type> m_index;
+    std::vector<double> m_value;
+
+    // if true, the Clexulator has the non-zero ECI folded in and calc_global_energy_contribution is used
+    bool m_fused = false;
+
+    // correlation contributions of one unit cell, only entries in m_index are used
+    std::vector<double> m_corr;
+
+  };
+
+}
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef CLEXULATOR_HH
 #define CLEXULATOR_HH
 #include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 #define BOOST_NO_SCOPED_ENUMS
 #define BOOST_NO_CXX11_SCOPED_ENUMS
@@ -11,6 +14,16 @@ namespace CASM {
 
   namespace Clexulator_impl {
 
+    /// \brief Version of the Base interface that compiled Clexulators implement
+    ///
+    /// Included in the hash that decides if a compiled Clexulator is stale, see RuntimeLibrary::is_stale.
+    /// Increment it whenever Base changes, so that Clexulators compiled against an older Base are
+    /// compiled again instead of loaded.
+    ///
+    /// - 2: added the folded ECI methods, folded_eci_size through calc_delta_point_energy
+    ///
+    const int interface_version = 2;
+
     /// \brief Abstract base class for cluster expansion correlation calculations
     class Base {
 
@@ -59,7 +72,7 @@ namespace CASM {
       /// \code
       /// UnitCellCoord bijk(b,i,j,k);           // UnitCellCoord of site in Configuration
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// \endcode
       ///
       void set_nlist(const long int *_nlist_ptr) {
@@ -76,7 +89,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// myclexulator.calc_global_corr_contribution(correlation_array.begin());
       /// \endcode
       ///
@@ -92,13 +105,58 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_global_corr_contribution(correlation_array.begin(), ind_list.begin(), ind_list.end());
       /// \endcode
       ///
       virtual void calc_restricted_global_corr_contribution(double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const = 0;
 
+      /// \brief Calculate global correlations for a batch of configurations of the same supercell
+      ///
+      /// \param occ_begin Pointer to occupation variables, stored structure-of-arrays: the occupant
+      ///        of site 'l' in configuration 'k' is occ_begin[l*N_config + k]
+      /// \param N_config Number of configurations in the batch
+      /// \param N_site Number of sites in the supercell
+      /// \param nlist_begin Pointer to neighbor lists of all unit cells, row-major N_unitcell x nlist_size()
+      /// \param N_unitcell Number of unit cells in the supercell
+      /// \param corr_begin Pointer to beginning of data structure where correlations are written,
+      ///        row-major N_config x corr_size(), normalized per unit cell
+      ///
+      /// Clexulators printed by PrimClex override this with a kernel whose innermost loop is over
+      /// configurations. This default evaluates one configuration at a time, so that Clexulators
+      /// printed before the batch method existed can still be used.
+      ///
+      virtual void calc_global_corr_batch(const int *occ_begin,
+                                          size_type N_config,
+                                          size_type N_site,
+                                          const long int *nlist_begin,
+                                          size_type N_unitcell,
+                                          double *corr_begin) {
+
+        std::vector<int> occ(N_site);
+        std::vector<double> tcorr(corr_size());
+        for(size_type k = 0; k < N_config; k++) {
+          for(size_type l = 0; l < N_site; l++) {
+            occ[l] = occ_begin[l * N_config + k];
+          }
+          set_config_occ(occ.data());
+
+          double *corr = corr_begin + k * corr_size();
+          std::fill(corr, corr + corr_size(), 0.0);
+          for(size_type v = 0; v < N_unitcell; v++) {
+            set_nlist(nlist_begin + v * nlist_size());
+            calc_global_corr_contribution(tcorr.data());
+            for(size_type i = 0; i < corr_size(); i++) {
+              corr[i] += tcorr[i];
+            }
+          }
+          for(size_type i = 0; i < corr_size(); i++) {
+            corr[i] /= (double) N_unitcell;
+          }
+        }
+      }
+
       /// \brief Calculate point correlations about basis site 'b_index'
       ///
       /// \brief b_index Basis site index about which to calculate correlations
@@ -109,7 +167,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// myclexulator.calc_point_corr(b, correlation_array.begin());
       /// \endcode
       ///
@@ -126,7 +184,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_point_corr(b, correlation_array.begin(), ind_list.begin(), ind_list.end());
       /// \endcode
@@ -144,7 +202,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
       /// myclexulator.calc_delta_point_corr(b, occ_i, occ_f, correlation_array.begin());
       /// \endcode
@@ -163,7 +221,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
       /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_delta_point_corr(b, occ_i, occ_f, correlation_array.begin(), ind_list.begin(), ind_list.end());
@@ -176,6 +234,41 @@ namespace CASM {
                                                     size_type const *ind_list_begin,
                                                     size_type const *ind_list_end) const = 0;
 
+      /// \brief Number of ECI folded into calc_global_energy_contribution and calc_delta_point_energy
+      ///
+      /// Clexulators printed by PrimClex with an ECIContainer override this and the following
+      /// methods. Others have no folded ECI, and their energy methods throw.
+      ///
+      virtual size_type folded_eci_size() const {
+        return 0;
+      }
+
+      /// \brief Indices of the correlations of the folded ECI, in the order they appear in eci.out
+      virtual size_type const *folded_eci_index() const {
+        return nullptr;
+      }
+
+      /// \brief Values of the folded ECI
+      virtual double const *folded_eci_value() const {
+        return nullptr;
+      }
+
+      /// \brief Calculate contribution to the cluster expansion value from one unit cell, using the folded ECI
+      ///
+      /// Equivalent to summing eci*corr over the folded ECI after calc_global_corr_contribution
+      ///
+      virtual double calc_global_energy_contribution() const {
+        throw std::runtime_error("Error in Clexulator: calc_global_energy_contribution requires a Clexulator printed with ECI");
+      }
+
+      /// \brief Calculate the change in the cluster expansion value due to changing an occupant, using the folded ECI
+      ///
+      /// Equivalent to summing eci*delta_corr over the folded ECI after calc_delta_point_corr
+      ///
+      virtual double calc_delta_point_energy(int b_index, int occ_i, int occ_f) const {
+        throw std::runtime_error("Error in Clexulator: calc_delta_point_energy requires a Clexulator printed with ECI");
+      }
+
 
     private:
 
@@ -217,8 +310,11 @@ namespace CASM {
     /// \param so_options Shared library compilation options, by default "g++ -shared"
     ///
     /// If 'name' is 'X_Clexulator', and 'dirpath' is '/path/to':
-    /// - Looks for '/path/to/X_Clexulator.so' and tries to load it.
-    /// - If not found, looks for 'path/to/X_Clexulator.cc' and tries to compile and load it.
+    /// - If '/path/to/X_Clexulator.cc' exists, compiles it unless '/path/to/X_Clexulator.so' was
+    ///   compiled from the same source with the same options against the current
+    ///   Clexulator_impl::interface_version (see RuntimeLibrary::compile_if_stale).
+    ///   Compiled libraries are kept in '/path/to/.clexulator_cache' and reused if the source and options match.
+    /// - Loads '/path/to/X_Clexulator.so'.
     /// - If unsuccesful, will throw std::runtime_error.
     ///
     /// The Clexulator has shared ownership of the loaded library,
@@ -235,22 +331,19 @@ namespace CASM {
       try {
 
         // Construct the RuntimeLibrary that will store the loaded clexulator library
-        m_lib = std::make_shared<RuntimeLibrary>(compile_options, so_options);
-
-        // If the shared library doesn't exist
-        if(!fs::exists(dirpath / (name + ".so"))) {
-
-          // But the library source code does
-          if(fs::exists(dirpath / (name + ".cc"))) {
-
-            // Compile it
-            m_lib->compile((dirpath / name).string());
-          }
-          else {
-            throw std::runtime_error(
-              std::string("Error in Clexulator constructor\n") +
-              "  Could not find '" + dirpath.string() + "/" + name + ".so' or '" + dirpath.string() + "/" + name + ".cc'");
-          }
+        m_lib = std::make_shared<RuntimeLibrary>(compile_options,
+                                                 so_options,
+                                                 "Clexulator_impl::Base " + std::to_string(Clexulator_impl::interface_version));
+
+        // If the library source code exists, compile it unless the shared library was already
+        //   compiled from it with the same options, or a matching build is in the cache
+        if(fs::exists(dirpath / (name + ".cc"))) {
+          m_lib->compile_if_stale((dirpath / name).string(), (dirpath / ".clexulator_cache").string());
+        }
+        else if(!fs::exists(dirpath / (name + ".so"))) {
+          throw std::runtime_error(
+            std::string("Error in Clexulator constructor\n") +
+            "  Could not find '" + dirpath.string() + "/" + name + ".so' or '" + dirpath.string() + "/" + name + ".cc'");
         }
 
         // If the shared library exists
@@ -360,7 +453,7 @@ namespace CASM {
     /// \code
     /// UnitCellCoord bijk(b,i,j,k);           // UnitCellCoord of site in Configuration
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// \endcode
     ///
     void set_nlist(const long int *_nlist_ptr) {
@@ -376,7 +469,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// myclexulator.calc_global_corr_contribution(correlation_array.begin());
     /// \endcode
     ///
@@ -394,7 +487,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_global_corr_contribution(correlation_array.begin(), ind_list.begin(), ind_list.end());
     /// \endcode
@@ -403,6 +496,34 @@ namespace CASM {
       m_clex->calc_restricted_global_corr_contribution(corr_begin, ind_list_begin, ind_list_end);
     }
 
+    /// \brief Calculate global correlations for a batch of configurations of the same supercell
+    ///
+    /// \param occ_begin Pointer to occupation variables, stored structure-of-arrays: the occupant
+    ///        of site 'l' in configuration 'k' is occ_begin[l*N_config + k]
+    /// \param N_config Number of configurations in the batch
+    /// \param N_site Number of sites in the supercell
+    /// \param nlist_begin Pointer to neighbor lists of all unit cells, row-major N_unitcell x nlist_size()
+    /// \param N_unitcell Number of unit cells in the supercell
+    /// \param corr_begin Pointer to beginning of data structure where correlations are written,
+    ///        row-major N_config x corr_size(), normalized per unit cell
+    ///
+    /// Call using:
+    /// \code
+    /// std::vector<int> occ(scel.num_sites()*N_config);  // occ[l*N_config + k]
+    /// std::vector<double> corr(N_config*myclexulator.corr_size());
+    /// // if scel.nlist_size() == myclexulator.nlist_size()
+    /// myclexulator.calc_global_corr_batch(occ.data(), N_config, scel.num_sites(), scel.nlist_table(), scel.volume(), corr.data());
+    /// \endcode
+    ///
+    void calc_global_corr_batch(const int *occ_begin,
+                                size_type N_config,
+                                size_type N_site,
+                                const long int *nlist_begin,
+                                size_type N_unitcell,
+                                double *corr_begin) {
+      m_clex->calc_global_corr_batch(occ_begin, N_config, N_site, nlist_begin, N_unitcell, corr_begin);
+    }
+
     /// \brief Calculate point correlations about basis site 'b_index'
     ///
     /// \brief b_index Basis site index about which to calculate correlations
@@ -413,7 +534,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// myclexulator.calc_point_corr(b, correlation_array.begin());
     /// \endcode
     ///
@@ -432,7 +553,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_point_corr(b, correlation_array.begin(), ind_list.begin(), ind_list.end());
     /// \endcode
@@ -452,7 +573,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
     /// myclexulator.calc_delta_point_corr(b, occ_i, occ_f, correlation_array.begin());
     /// \endcode
@@ -473,7 +594,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
     /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_delta_point_corr(b, occ_i, occ_f, correlation_array.begin(), ind_list.begin(), ind_list.end());
@@ -488,6 +609,55 @@ namespace CASM {
       m_clex->calc_restricted_delta_point_corr(b_index, occ_i, occ_f, corr_begin, ind_list_begin, ind_list_end);
     }
 
+    /// \brief Number of ECI folded into calc_global_energy_contribution and calc_delta_point_energy
+    ///
+    /// Zero unless the Clexulator was printed with an ECIContainer, see PrimClex print_clexulator
+    ///
+    size_type folded_eci_size() const {
+      return m_clex->folded_eci_size();
+    }
+
+    /// \brief Indices of the correlations of the folded ECI, in the order they appear in eci.out
+    size_type const *folded_eci_index() const {
+      return m_clex->folded_eci_index();
+    }
+
+    /// \brief Values of the folded ECI
+    double const *folded_eci_value() const {
+      return m_clex->folded_eci_value();
+    }
+
+    /// \brief Calculate contribution to the cluster expansion value from one unit cell, using the folded ECI
+    ///
+    /// Call using:
+    /// \code
+    /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+    /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
+    /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
+    /// double value = myclexulator.calc_global_energy_contribution();
+    /// \endcode
+    ///
+    double calc_global_energy_contribution() const {
+      return m_clex->calc_global_energy_contribution();
+    }
+
+    /// \brief Calculate the change in the cluster expansion value due to changing an occupant, using the folded ECI
+    ///
+    /// Call using:
+    /// \code
+    /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+    /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to change
+    /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index));
+    /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
+    /// double dE = myclexulator.calc_delta_point_energy(b, occ_i, occ_f);
+    /// \endcode
+    ///
+    double calc_delta_point_energy(int b_index, int occ_i, int occ_f) const {
+      return m_clex->calc_delta_point_energy(b_index, occ_i, occ_f);
+    }
+
 
   private:
 
@@ -0,0 +1,100 @@
+#ifndef ConfigCanonicalizer_HH
+#define ConfigCanonicalizer_HH
+
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/crystallography/PrimGridPermute.hh"
+#include "casm/symmetry/PermuteIterator.hh"
+#include "casm/clex/ConfigDoF.hh"
+
+namespace CASM {
+
+  class TaskScheduler;
+
+  /// \brief Canonical form and is_canonical checks for the ConfigDoF of one Supercell
+  ///
+  /// Gives the same results as ConfigDoF::canonical_form and ConfigDoF::is_canonical over the
+  /// operations [it_begin, it_end), but for occupation-only ConfigDoF it is much faster:
+  /// - site permutations are computed by the PrimGridPermute of the PermuteIterator in blocks of
+  ///   sites, instead of being looked up through PermuteIterator for every site, and are never
+  ///   stored for all operations
+  /// - operations are grouped by which site they bring to site 0, so only operations that bring a
+  ///   maximal occupant to site 0 are considered further
+  /// - permuted occupations are compared lazily, site by site, without making copies, and the
+  ///   canonical ConfigDoF is constructed once at the end
+  ///
+  /// ConfigDoF with displacements or strain use the ConfigDoF methods.
+  ///
+  /// The PermuteIterator passed in must iterate over a PrimGridPermute, see Supercell::permute_begin,
+  /// and must stay valid, so Supercell owns one for its own permutations, see Supercell::canonicalizer.
+  ///
+  class ConfigCanonicalizer {
+
+  public:
+
+    ConfigCanonicalizer(PermuteIterator it_begin, PermuteIterator it_end);
+
+    /// \brief Number of sites permuted
+    Index size() const {
+      return m_N;
+    }
+
+    /// \brief Same as dof.is_canonical(it_begin, it_end, tol)
+    bool is_canonical(const ConfigDoF &dof, double tol = TOL) const;
+
+    /// \brief Same as dof.is_canonical(it_begin, it_end, factor_group, tol)
+    bool is_canonical(const ConfigDoF &dof, Array<PermuteIterator> &factor_group, double tol = TOL) const;
+
+    /// \brief Check if each of 'dof' is canonical, using the threads of 'scheduler'
+    std::vector<bool> is_canonical(const std::vector<const ConfigDoF *> &dof, TaskScheduler &scheduler, double tol = TOL) const;
+
+    /// \brief Same as dof.is_primitive(it_begin, tol)
+    bool is_primitive(const ConfigDoF &dof, double tol = TOL) const;
+
+    /// \brief Same as dof.canonical_form(it_begin, it_end, it_canon, tol)
+    ConfigDoF canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon, double tol = TOL) const;
+
+    /// \brief Same as dof.canonical_form(it_begin, it_end, it_canon, factor_group, tol)
+    ConfigDoF canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon, Array<PermuteIterator> &factor_group, double tol = TOL) const;
+
+  private:
+
+    /// \brief True if the fast path applies to 'dof'
+    bool _occupation_only(const ConfigDoF &dof) const;
+
+    /// \brief Site permutation for operation 'k': after[i] = before[_permute_ind(k, i)]
+    Index _permute_ind(Index k, Index i) const {
+      return m_grid_permute->permute_ind(m_op_fg[k], m_op_trans[k], i);
+    }
+
+    /// \brief Compare 'occ' permuted by operation 'k' to 'ref', starting at site 'begin'
+    ///
+    /// \returns 1 if the permuted occupation is larger, -1 if smaller, 0 if equal
+    int _compare(Index k, const int *occ, const int *ref, Index begin) const;
+
+    bool _is_canonical(const ConfigDoF &dof, Array<PermuteIterator> *fg_ptr, double tol) const;
+
+    ConfigDoF _canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon, Array<PermuteIterator> *fg_ptr, double tol) const;
+
+    PermuteIterator m_begin;
+    PermuteIterator m_end;
+
+    Index m_N;
+
+    PrimGridPermute const *m_grid_permute;
+
+    /// operations, and their factor group and translation indices
+    std::vector<PermuteIterator> m_op;
+    std::vector<Index> m_op_fg;
+    std::vector<Index> m_op_trans;
+
+    /// m_first_site_ops[j]: the operations k, in order, with _permute_ind(k, 0) == m_first_site[j]
+    std::vector<Index> m_first_site;
+    std::vector<std::vector<Index> > m_first_site_ops;
+
+  };
+
+}
+
+#endif
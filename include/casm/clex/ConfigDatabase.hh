@@ -0,0 +1,160 @@
+#ifndef ConfigDatabase_HH
+#define ConfigDatabase_HH
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/casm_io/jsonParser.hh"
+
+namespace CASM {
+
+  class Configuration;
+  class Supercell;
+
+  /// \brief Binary store for the master list of Configurations
+  ///
+  /// Replaces rewriting '.casm/config_list.json' on every update. Data is kept in two files:
+  /// - a base file, memory-mapped on open so that only the pages that are used get read, with
+  ///   one section per Supercell containing:
+  ///   - occupation: one byte per site, stored as a [configuration][site] array
+  ///   - selected: one byte per configuration
+  ///   - all other config_list.json data for each configuration (source, properties, non-occupation
+  ///     DoF) as compact JSON, stored once per unique value and referenced by index
+  /// - an append-only journal of new and changed configurations, replayed on open
+  ///
+  /// When the journal grows larger than the base file, both are rewritten as a new base file.
+  ///
+  /// Appending to the journal and rewriting the base file hold an exclusive lock on a third file,
+  /// the base file path plus '.lock', so records written by concurrent processes are not
+  /// interleaved. Each process only knows the configurations it has read, though, so only one
+  /// process at a time should add configurations.
+  ///
+  /// Configurations are identified by Supercell name and config id, and ids are contiguous.
+  /// Configurations are only ever added or changed, never removed.
+  ///
+  class ConfigDatabase {
+
+  public:
+
+    /// \brief Open the database stored in 'db_path' and 'journal_path', if they exist
+    ConfigDatabase(const fs::path &db_path, const fs::path &journal_path);
+
+    ConfigDatabase(const ConfigDatabase &) = delete;
+    ConfigDatabase &operator=(const ConfigDatabase &) = delete;
+
+    ~ConfigDatabase();
+
+    /// \brief Number of Configurations stored for the Supercell named 'scelname'
+    Index size(const std::string &scelname) const;
+
+    /// \brief Construct stored Configuration 'id' of 'scel'
+    Configuration configuration(Supercell &scel, Index id) const;
+
+    /// \brief Store 'config', if it has been added or changed
+    ///
+    /// Follows Configuration::write: source and properties are updated only if they were changed
+    /// since the Configuration was read. DoF and selection are always updated. Must be followed
+    /// by commit().
+    void insert(const Configuration &config);
+
+    /// \brief Store all configurations in the config_list.json format 'json'
+    ///
+    /// Used to convert existing projects. Must be followed by commit().
+    void insert(const jsonParser &json);
+
+    /// \brief Append new records to the journal, and compact if the journal has grown large
+    void commit();
+
+    /// \brief Rewrite the base file with all records, and remove the journal
+    void compact();
+
+  private:
+
+    /// A record written to the journal
+    struct JournalRecord {
+      std::string occupation;
+      bool selected;
+      std::string data;
+      mutable std::shared_ptr<jsonParser> parsed;
+    };
+
+    /// Records for one Supercell
+    struct SupercellRecords {
+
+      SupercellRecords() :
+        num_sites(0), base_size(0), occupation(nullptr), selected(nullptr), blob_id(nullptr),
+        blob_count(0), blob_offset(nullptr), blob_data(nullptr) {}
+
+      Index size() const {
+        return journal.empty() ? base_size : std::max(base_size, journal.rbegin()->first + 1);
+      }
+
+      Index num_sites;
+
+      // sections of the mapped base file
+      Index base_size;
+      const char *occupation;
+      const char *selected;
+      const char *blob_id;
+      Index blob_count;
+      const char *blob_offset;
+      const char *blob_data;
+      mutable std::vector<std::shared_ptr<jsonParser> > parsed_blob;
+
+      // journaled records, which replace base records with the same id
+      std::map<Index, JournalRecord> journal;
+    };
+
+    /// \brief Path of the file locked while writing
+    fs::path _lock_path() const {
+      return fs::path(m_db_path.string() + ".lock");
+    }
+
+    /// \brief Map the base file and replay the journal
+    void _open();
+
+    /// \brief Unmap the base file and forget all records
+    void _close();
+
+    /// \brief Read the directory of the mapped base file
+    void _read_base();
+
+    /// \brief Apply the records in the journal file
+    void _read_journal();
+
+    /// \brief Add a record, if it differs from the stored record
+    void _insert(const std::string &scelname, Index num_sites, Index id,
+                 const std::string &occupation, bool selected, const std::string &data);
+
+    /// \brief Get record 'id'
+    void _record(const SupercellRecords &scel, Index id,
+                 std::string &occupation, bool &selected, std::string &data) const;
+
+    /// \brief Get all data for record 'id' other than occupation and selected
+    const jsonParser &_parsed(const SupercellRecords &scel, Index id) const;
+
+    const SupercellRecords &_find(const std::string &scelname) const;
+
+    fs::path m_db_path;
+    fs::path m_journal_path;
+
+    // mapped base file
+    const char *m_map;
+    Index m_map_size;
+
+    Index m_journal_size;
+
+    /// records inserted but not yet committed
+    std::string m_pending;
+
+    std::map<std::string, SupercellRecords> m_scel;
+
+  };
+
+}
+
+#endif
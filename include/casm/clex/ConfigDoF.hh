@@ -11,6 +11,7 @@ namespace CASM {
   typedef Array<double> Correlation;
   class Supercell;
   class Clexulator;
+  class TaskScheduler;
 
 
   /**
@@ -193,9 +194,29 @@ namespace CASM {
 
   void swap(ConfigDoF &A, ConfigDoF &B);
 
+  /// \brief Hash of the occupation of 'configdof'
+  ///
+  /// - Consistent with ConfigDoF::operator==: equal ConfigDoF always have equal hash values
+  /// - Displacement and deformation are compared within tolerance, so they are not hashed
+  std::size_t hash_value(const ConfigDoF &configdof);
+
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
   Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator);
 
+  /// \brief Returns correlations using 'clexulator', dividing the unit cells of 'scel' among the threads of 'scheduler'
+  ///
+  /// - Each block of unit cells uses its own copy of 'clexulator'
+  /// - The result does not depend on the number of threads
+  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, const Clexulator &clexulator, TaskScheduler &scheduler);
+
+  /// \brief Returns correlations for each of 'configdof_list', which must all be configurations of 'scel'
+  ///
+  /// - Uses Clexulator::calc_global_corr_batch, evaluating up to 'batch_size' configurations per call
+  std::vector<Correlation> correlations(const std::vector<const ConfigDoF *> &configdof_list,
+                                        const Supercell &scel,
+                                        Clexulator &clexulator,
+                                        Index batch_size = 64);
+
 }
 
 #endif
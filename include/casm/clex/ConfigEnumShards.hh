@@ -0,0 +1,103 @@
+#ifndef CONFIGENUMSHARDS_HH
+#define CONFIGENUMSHARDS_HH
+
+#include <map>
+#include <string>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/Array.hh"
+
+namespace CASM {
+
+  class Supercell;
+  class TaskScheduler;
+
+  /// \brief Sharded, resumable enumeration of all occupations of a Supercell
+  ///
+  /// Gives the same configurations, in the same order, as Supercell::enumerate_all_occupation_configurations,
+  /// but the occupation counter space is split into shards by fixing the occupants of the last
+  /// (outer loop) sites of the counter:
+  /// - shards are enumerated in parallel, each keeping only primitive canonical occupations
+  /// - each completed shard is appended to a file in the checkpoint directory, so an interrupted
+  ///   enumeration resumes with the shards that were not completed
+  /// - several processes can enumerate different parts of the shards for the same Supercell, each
+  ///   writing its own file
+  ///
+  /// Once all shards are complete, merge() adds the enumerated configurations to the Supercell. The
+  /// checkpoint directory should be removed once the config list has been written.
+  ///
+  /// Checkpoint directory contents:
+  /// - 'shards.json': the shard layout, which must match on resume
+  /// - 'part_I_of_N.bin': records of completed shards, as [uint64 size][uint64 shard]
+  ///   [uint64 count][count * num_sites bytes of occupation]
+  ///
+  class ConfigEnumShards {
+
+  public:
+
+    /// \brief Open or create the checkpoint in 'dir' for enumerating 'scel'
+    ///
+    /// \param target_shards The minimum number of shards, unless the Supercell has fewer occupations
+    ConfigEnumShards(Supercell &scel, const fs::path &dir, Index target_shards = 256);
+
+    /// \brief Number of shards
+    Index size() const {
+      return m_num_shards;
+    }
+
+    /// \brief Number of completed shards, from all parts
+    Index num_complete() const {
+      return m_complete.size();
+    }
+
+    /// \brief True if all shards are complete
+    bool complete() const {
+      return num_complete() == size();
+    }
+
+    /// \brief Number of configurations found in completed shards
+    Index num_configs() const;
+
+    /// \brief Enumerate the incomplete shards with (shard % num_parts == part), in parallel
+    void enumerate(TaskScheduler &scheduler, Index part = 0, Index num_parts = 1);
+
+    /// \brief Add all enumerated configurations to the Supercell, as add_enumerated_configurations
+    void merge();
+
+  private:
+
+    /// Location of a completed shard
+    struct ShardRecord {
+      fs::path path;
+      Index offset;
+      Index count;
+    };
+
+    /// \brief Read or write 'shards.json'
+    void _read_layout(Index part);
+
+    /// \brief Find all completed shards
+    ///
+    /// An incomplete record at the end of 'own_file' is removed, incomplete records at the end of
+    /// other files are ignored because they may still be written.
+    void _read_shards(const fs::path &own_file);
+
+    /// \brief Primitive canonical occupations of 'shard', one byte per site each
+    std::string _enumerate_shard(Index shard) const;
+
+    Supercell *m_scel;
+    fs::path m_dir;
+
+    Array<int> m_max_occupation;
+
+    /// number of sites, at the end of the counter, which are fixed for each shard
+    Index m_fixed_sites;
+    Index m_num_shards;
+
+    std::map<Index, ShardRecord> m_complete;
+
+  };
+
+}
+
+#endif
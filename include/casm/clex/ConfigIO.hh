@@ -4,6 +4,7 @@
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/casm_io/DataFormatterTools.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/clex/ClexEvaluator.hh"
 #include "casm/clex/ECIContainer.hh"
 
 namespace CASM {
@@ -172,9 +173,11 @@ namespace CASM {
 
       bool parse_args(const std::string &args);
     private:
+      /// Value of the cluster expansion, shared by the formatters of a DataFormatter row
+      double _row_value(const Configuration &_config) const;
+
       mutable std::string m_clex_name;
-      mutable Clexulator m_clexulator;
-      mutable ECIContainer m_eci;
+      mutable ClexEvaluator m_clex;
 
     };
 
@@ -5,6 +5,7 @@
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/ECIContainer.hh"
 #include "casm/hull/Hull.hh"
+#include "casm/hull/HullCache.hh"
 namespace CASM {
 
   class Configuration;
@@ -21,6 +22,10 @@ namespace CASM {
       /// Initialize the convex hull and determine on-hull configurations
       void init(const Configuration &_tmplt) const override;
 
+      bool thread_safe_clone() const override {
+        return m_format.thread_safe_clone();
+      }
+
       std::string short_header(const Configuration &_config) const override;
 
       //void inject(const Configuration &_config, DataStream &_stream, Index) const override;
@@ -31,8 +36,8 @@ namespace CASM {
 
       bool parse_args(const std::string &args);
     protected:
-      const BP::Geo &_hull() const {
-        return m_hull;
+      const HullCache &_hull() const {
+        return *m_hull;
       }
       const DataFormatter<Configuration> &_format() const {
         return m_format;
@@ -46,12 +51,23 @@ namespace CASM {
       const Eigen::MatrixXd &_projection() const {
         return m_projection;
       }
+
+      /// Distance to hull of a configuration, read from the hull if it was one of the
+      /// configurations used to construct it
+      double _dist_to_hull(const Configuration &_config, const Eigen::MatrixXd &_data) const;
+
+      /// Distance to hull of a configuration, or NAN if it is missing data, shared by the
+      /// formatters of a DataFormatter row
+      double _row_dist_to_hull(const Configuration &_config) const;
       //const std::string &_dependent_prop const{ return m_dependent_prop;}
       //void _parse_args(const std::string &args, const std::string &_dep_prop);
     private:
       // specifies the dependent property to use (e.g., formation_energy or clex(formation_energy) )
       const std::string m_dependent_prop;
-      mutable BP::Geo m_hull;
+
+      // hull, with energy first, shared by copies of this formatter, and stored in the project
+      // so that it is only updated for configurations that changed since the last query
+      mutable std::shared_ptr<HullCache> m_hull;
 
       // Matrix that describes subspace spanned by data
       mutable Eigen::MatrixXd m_projection;
@@ -91,7 +107,7 @@ namespace CASM {
 
     protected:
       //inherits:
-      // const BP::Geo& _hull() const{ return m_hull;}
+      // const HullCache& _hull() const{ return *m_hull;}
       // const std::map<std::string, bool> &_on_hull() const{ return m_on_hull;}
       // const std::vector<std::string> &_independent_props const{ return m_independent_props;}
     };
@@ -117,7 +133,7 @@ namespace CASM {
 
     protected:
       //inherits:
-      // const BP::Geo& _hull() const{ return m_hull;}
+      // const HullCache& _hull() const{ return *m_hull;}
       // const std::map<std::string, bool> &_on_hull() const{ return m_on_hull;}
       // const std::vector<std::string> &_independent_props const{ return m_independent_props;}
     };
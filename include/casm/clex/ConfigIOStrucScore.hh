@@ -24,6 +24,11 @@ namespace CASM {
         return new StrucScoreConfigFormatter(*this);
       }
 
+      /// PrimClex does not make a correct copy of itself, so clones may not be used concurrently
+      bool thread_safe_clone() const override {
+        return false;
+      }
+
       bool validate(const Configuration &_config) const override;
 
       std::string short_header(const Configuration &_config) const override;
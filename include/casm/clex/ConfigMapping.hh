@@ -1,11 +1,73 @@
 #ifndef CONFIGMAPPING_HH
 #define CONFIGMAPPING_HH
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "casm/CASM_global_definitions.hh"
+#include "casm/clex/ConfigDoF.hh"
+#include "casm/crystallography/Lattice.hh"
 namespace CASM {
   class Supercell;
-  class Lattice;
   class SymGroup;
   class PrimClex;
+  class Configuration;
+
+  /// \brief Candidate supercells for mapping structures onto the prim of a PrimClex
+  ///
+  /// For each volume it considers, deformed_struc_to_configdof tries every supercell of the prim,
+  /// up to symmetry. MappingCandidates enumerates and niggli-reduces those supercells, and
+  /// constructs a Supercell for each, once per volume, the first time that volume is needed.
+  ///
+  /// The supercells are only read while mapping, so one MappingCandidates can be shared by many
+  /// structures, including structures mapped in parallel by map_structures.
+  class MappingCandidates {
+  public:
+
+    /// \brief Construct for 'pclex', reducing supercells with tolerance '_tol'
+    MappingCandidates(PrimClex &_pclex, double _tol);
+
+    PrimClex &primclex() const {
+      return *m_pclex;
+    }
+
+    double tol() const {
+      return m_tol;
+    }
+
+    /// \brief The niggli-reduced supercells of volume 'vol', in the order they are enumerated
+    ///
+    /// Safe to call from multiple threads.
+    const std::vector<std::shared_ptr<const Supercell> > &supercells(Index vol) const;
+
+  private:
+
+    PrimClex *m_pclex;
+    double m_tol;
+
+    mutable std::mutex m_mutex;
+    mutable std::map<Index, std::vector<std::shared_ptr<const Supercell> > > m_supercells;
+  };
+
+  namespace ConfigMapping {
+
+    /// \brief The result of mapping a structure with map_structures
+    class MappedStructure {
+    public:
+      MappedStructure() : valid(false) {}
+
+      /// ConfigDoF and supercell lattice of the mapping, if valid
+      ConfigDoF configdof;
+      Lattice lat;
+
+      /// false if the structure could not be mapped
+      bool valid;
+
+      /// if an exception was thrown while mapping, its message
+      std::string error;
+    };
+
+  }
 
   Lattice find_nearest_super_lattice(const Lattice &prim_lat,
                                      const Lattice &relaxed_lat,
@@ -51,6 +113,33 @@ namespace CASM {
                                    double lattice_weight = 0.5,
                                    double vol_tol = 0.25);
 
+  /// \brief Add the configuration 'tconfigdof' on 'mapped_lat', found by mapping '_struc' with
+  ///        struc_to_configdof, to 'pclex'
+  ///
+  /// Does everything import_structure_occupation does after mapping.
+  bool import_mapped_occupation(const BasicStructure<Site> &_struc,
+                                const ConfigDoF &tconfigdof,
+                                const Lattice &mapped_lat,
+                                const Configuration *hint_ptr,
+                                PrimClex &pclex,
+                                std::string &imported_name,
+                                jsonParser &relaxation_properties,
+                                bool strict_flag,
+                                double _tol);
+
+  /// \brief Map many structures with struc_to_configdof, in parallel
+  ///
+  /// The structures are mapped with the global TaskScheduler, all sharing 'candidates', and the
+  /// results do not depend on the number of threads. Nothing is added to the PrimClex, so the
+  /// results can then be imported in order with import_mapped_occupation.
+  std::vector<ConfigMapping::MappedStructure> map_structures(const std::vector<BasicStructure<Site> > &strucs,
+                                                             const MappingCandidates &candidates,
+                                                             bool robust_flag,
+                                                             bool rotate_flag,
+                                                             double _tol,
+                                                             double lattice_weight = 0.5,
+                                                             double vol_tol = 0.25);
+
   bool import_structure(const fs::path &pos_path,
                         PrimClex &pclex,
                         std::string &imported_name,
@@ -83,6 +172,17 @@ namespace CASM {
                           double lattice_weight = 0.5,
                           double vol_tol = 0.25);
 
+  /// \brief Same as above, using candidate supercells that may be shared with other structures
+  bool struc_to_configdof(const BasicStructure<Site> &_struc,
+                          const MappingCandidates &candidates,
+                          ConfigDoF &mapped_configdof,
+                          Lattice &mapped_lat,
+                          bool robust_flag,
+                          bool rotate_flag,
+                          double _tol,
+                          double lattice_weight = 0.5,
+                          double vol_tol = 0.25);
+
 
   bool ideal_struc_to_configdof(BasicStructure<Site> struc,
                                 PrimClex &pclex,
@@ -100,6 +200,16 @@ namespace CASM {
                                    double lattice_weight = 0.5,
                                    double vol_tol = 0.25);
 
+  /// \brief Same as above, using candidate supercells that may be shared with other structures
+  bool deformed_struc_to_configdof(const BasicStructure<Site> &_struc,
+                                   const MappingCandidates &candidates,
+                                   ConfigDoF &mapped_config_dof,
+                                   Lattice &mapped_lat,
+                                   bool rotate_flag,
+                                   double _tol,
+                                   double lattice_weight = 0.5,
+                                   double vol_tol = 0.25);
+
 
 
   // Assignment Problem Routines
@@ -120,6 +230,9 @@ namespace CASM {
   //   TRANSLATE = true -> rigid-translations are removed. (typically this option should be used, especially if you care about vacancies)
   //
   //   TRANSLATE = false -> rigid translations are not considered. (less robust but more efficient -- use only if you know rigid translations are small or zero)
+  //
+  // The assignment problem is solved with SparseAssignment, using only the (site, atom) pairs within a cutoff
+  // distance that is increased until the solution is provably the same as with the full cost matrix.
 
   bool struc_to_configdof(const Supercell &scel,
                           BasicStructure<Site> rstruc,
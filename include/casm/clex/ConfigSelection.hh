@@ -3,6 +3,7 @@
 
 #include <limits>
 #include "casm/clex/Configuration.hh"
+#include "casm/clex/ClexEvaluator.hh"
 
 namespace CASM {
 
@@ -325,8 +326,16 @@ namespace CASM {
     return _stream;
   }
 
+  /// \brief ClexEvaluator for each 'clex(clex_name)' in selection criteria, keyed by clex_name
+  typedef std::map<std::string, ClexEvaluator> ClexEvaluatorCache;
+
   bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool is_selected);
 
+  /// \brief Use 'clex_cache' to construct the ClexEvaluator for each clex_name only once when
+  ///        applying the same criteria to many configurations
+  bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool is_selected,
+                     ClexEvaluatorCache &clex_cache);
+
   namespace ConfigSelection_impl {
 
     bool is_operator(const std::string &q);
@@ -338,6 +347,8 @@ namespace CASM {
     bool is_unary(const std::string &q);
 
     std::string convert_variable(const std::string &q, const Configuration &config);
+
+    std::string convert_variable(const std::string &q, const Configuration &config, ClexEvaluatorCache &clex_cache);
   }
 
 }
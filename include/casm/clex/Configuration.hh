@@ -21,6 +21,7 @@ namespace CASM {
   class Supercell;
   class UnitCellCoord;
   class Clexulator;
+  class TaskScheduler;
 
   class Configuration {
   private:
@@ -125,6 +126,10 @@ namespace CASM {
     /// Construct by reading from main data file (json)
     Configuration(const jsonParser &json, Supercell &_supercell, Index _id);
 
+    /// Construct from data stored in a ConfigDatabase
+    ///   json_config: the data for this configuration in config_list.json format, except for occupation and 'selected'
+    Configuration(const jsonParser &json_config, const Array<int> &_occupation, bool _selected, Supercell &_supercell, Index _id);
+
 
     /// Construct a Configuration with occupation specified by string 'con_name'
     //Configuration(Supercell &_supercell, std::string con_name, bool select, const jsonParser &source = jsonParser());
@@ -157,11 +162,11 @@ namespace CASM {
 
     void set_deformation(const Eigen::Matrix3d &_deformation);
 
+    /// Uses Supercell::canonicalizer if [it_begin, it_end) are all the Supercell permutations
     Configuration canonical_form(PermuteIterator it_begin, PermuteIterator it_end, PermuteIterator &it_canon, double tol = TOL) const;
 
-    bool is_canonical(PermuteIterator it_begin, PermuteIterator it_end, double tol = TOL) const {
-      return m_configdof.is_canonical(it_begin, it_end, tol);
-    }
+    /// Uses Supercell::canonicalizer if [it_begin, it_end) are all the Supercell permutations
+    bool is_canonical(PermuteIterator it_begin, PermuteIterator it_end, double tol = TOL) const;
 
     bool is_primitive(PermuteIterator it_begin, double tol = TOL) const {
       return m_configdof.is_primitive(it_begin, tol);
@@ -221,6 +226,16 @@ namespace CASM {
       return m_selected;
     }
 
+    /// True if source or properties were changed since reading, so that write() will update them
+    bool data_updated() const {
+      return source_updated || prop_updated;
+    }
+
+    /// True if DoF were changed since reading, so that the stored DoF are out of date
+    bool dof_changed() const {
+      return dof_updated;
+    }
+
     //PrimClex &get_primclex();
     const PrimClex &get_primclex() const;
 
@@ -379,6 +394,7 @@ namespace CASM {
     void read_dof(const jsonParser &json);
     void read_corr(const jsonParser &json);
     void read_properties(const jsonParser &json);
+    void read_curr_properties(const jsonParser &json);
 
     /// Functions used to perform write to config_list.json:
     jsonParser &write_dof(jsonParser &json) const;
@@ -397,6 +413,12 @@ namespace CASM {
   /// \brief Returns correlations using 'clexulator'.
   Correlation correlations(const Configuration &config, Clexulator &clexulator);
 
+  /// \brief Returns correlations using 'clexulator', dividing the unit cells among the threads of 'scheduler'
+  Correlation correlations(const Configuration &config, const Clexulator &clexulator, TaskScheduler &scheduler);
+
+  /// \brief Call Configuration::set_correlations for each Configuration in 'config_list', using the threads of 'scheduler'
+  void set_correlations(const std::vector<Configuration *> &config_list, const Clexulator &clexulator, TaskScheduler &scheduler);
+
 }
 
 #endif
@@ -28,6 +28,7 @@ namespace CASM {
 
     //Clexulator printing routines
     ReturnArray<FunctionVisitor *> get_function_label_visitors() const;
+    ReturnArray<FunctionVisitor *> get_batch_function_label_visitors() const;
     void print_clexulator_member_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent) const;
     void print_clexulator_private_method_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent) const;
     void print_clexulator_private_method_implementations(std::ostream &stream, const PrimClex &primclex, const std::string &indent) const;
@@ -70,6 +71,11 @@ namespace CASM {
       return NULL;
     };
 
+    /// Labels functions for evaluation in Clexulator batch methods, which loop over configurations 'k'
+    virtual FunctionVisitor *get_batch_function_label_visitor() const {
+      return NULL;
+    };
+
     virtual void print_clexulator_member_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent)const {};
 
     virtual void print_clexulator_private_method_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent)const {};
@@ -107,6 +113,10 @@ namespace CASM {
       return new OccFuncLabeler("occ_func_%b_%f(%n)");
     };
 
+    FunctionVisitor *get_batch_function_label_visitor() const {
+      return new OccFuncLabeler("occ_func_%b_%f(%n, k)");
+    };
+
     void print_clexulator_member_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent)const;
 
     void print_clexulator_private_method_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent) const;
@@ -402,6 +402,9 @@ namespace CASM {
 
     Clexulator global_clexulator() const;
     ECIContainer global_eci(std::string clex_name) const;
+
+    /// \brief Clexulator printed with the ECI of 'clex_name' folded in, if it exists, else the global Clexulator
+    Clexulator eci_clexulator(std::string clex_name) const;
   private:
 
     /// Return the configuration closest in param_composition to the target_param_comp
@@ -410,17 +413,42 @@ namespace CASM {
 
 
     mutable Clexulator m_global_clexulator;
+
+    // Clexulators with ECI folded in, by source file path
+    mutable std::map<std::string, Clexulator> m_eci_clexulator;
   };
 
 
   /// \brief Make orbitree. For now specifically global.
   SiteOrbitree make_orbitree(Structure &prim, const jsonParser &json);
 
+  /// \brief Approximate size, in bytes of source code, of basis function implementations per translation
+  ///        unit of a printed Clexulator
+  const Index clexulator_translation_unit_size = 250000;
+
+  /// \brief Maximum number of translation units of a printed Clexulator
+  const Index clexulator_max_translation_units = 16;
+
   /// \brief Print clexulator
+  ///
+  /// Large Clexulators are split into translation units, see RuntimeLibrary::compile
+  void print_clexulator(const Structure &prim,
+                        SiteOrbitree &tree,
+                        const Array<UnitCellCoord> &nlist,
+                        std::string class_name,
+                        std::ostream &stream);
+
+  /// \brief Print clexulator, with fused kernels that evaluate a cluster expansion with fixed ECI
+  ///
+  /// In addition to everything printed by the other overload, the Clexulator overrides
+  /// Clexulator_impl::Base::calc_global_energy_contribution and
+  /// Clexulator_impl::Base::calc_delta_point_energy. Basis functions with zero ECI are left out,
+  /// and occupation function lookups are shared by all the clusters in a kernel.
   void print_clexulator(const Structure &prim,
                         SiteOrbitree &tree,
                         const Array<UnitCellCoord> &nlist,
                         std::string class_name,
+                        const ECIContainer &eci,
                         std::ostream &stream);
 
 
@@ -1,7 +1,12 @@
 #ifndef SUPERCELL_HH
 #define SUPERCELL_HH
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/PrimGridPermute.hh"
 #include "casm/crystallography/BasicStructure.hh"
 #include "casm/crystallography/Structure.hh"
 #include "casm/crystallography/UnitCellCoord.hh"
@@ -16,6 +21,8 @@ namespace CASM {
   class PermuteIterator;
   class PrimClex;
   class Clexulator;
+  class ConfigDatabase;
+  class ConfigCanonicalizer;
 
   class Supercell {
 
@@ -31,6 +38,37 @@ namespace CASM {
     typedef PermuteIterator permute_const_iterator;
 
   private:
+
+    /// Value constructed on first use, by only one thread if several use it at once. Copies
+    /// and assignment leave it unconstructed, because the values refer to m_prim_grid
+    template<typename T>
+    class LazyValue {
+    public:
+      LazyValue() :
+        m_flag(new std::once_flag()) {}
+
+      LazyValue(const LazyValue &RHS) :
+        LazyValue() {}
+
+      LazyValue &operator=(const LazyValue &RHS) {
+        m_flag.reset(new std::once_flag());
+        m_value.reset();
+        return *this;
+      }
+
+      /// Returns the value, constructing it as 'make()' if this is the first use
+      template<typename Make>
+      const T &get(Make make) const {
+        std::call_once(*m_flag, [&]() {
+          m_value = make();
+        });
+        return *m_value;
+      }
+
+    private:
+      std::unique_ptr<std::once_flag> m_flag;
+      mutable std::shared_ptr<T> m_value;
+    };
     // pointer to Primcell containing all the cluster expansion data
     PrimClex *primclex;
 
@@ -137,11 +175,26 @@ namespace CASM {
     void generate_phase_factor(const Eigen::MatrixXd &shift_vectors, const Array<bool> &is_commensurate, const bool &override);
     ///************************************************************************************************
 
-    Array< Array<Index> >    nlists;  //[scell site][ nbor_indices]
+    /// Neighbor list table, row-major num_sites() x m_nlist_size: m_nlist[l*m_nlist_size + n] is
+    /// the index of neighbor 'n' of site 'l'. Immutable once generated, so it is shared by copies and
+    /// by Supercells with the same PrimClex, transformation matrix, and neighborhood.
+    std::shared_ptr<const std::vector<long int> > m_nlist;
+    Index m_nlist_size;
 
     // Could hold either enumerated configurations or any 'saved' configurations
     ConfigList config_list;
 
+    /// hash_value(ConfigDoF) -> index into config_list, used by contains_config to avoid a linear scan
+    std::unordered_multimap<std::size_t, Index> m_config_index;
+
+    /// Constructed on first use by grid_permute(), and not copied with the Supercell,
+    /// because it refers to m_prim_grid
+    LazyValue<PrimGridPermute> m_grid_permute;
+
+    /// Constructed on first use by canonicalizer(), and not copied with the Supercell,
+    /// because it refers to m_prim_grid
+    LazyValue<ConfigCanonicalizer> m_canonicalizer;
+
     Matrix3 < int > transf_mat;
 
     double scaling;
@@ -278,13 +331,28 @@ namespace CASM {
 
     // get indices of neighbor sites ('nlist_index') in Configuration to some 'site'
     Index get_nlist_l(Index pivot_l, Index nlist_index) const {
-      return nlists[pivot_l][nlist_index];
+      return (*m_nlist)[pivot_l * m_nlist_size + nlist_index];
     };
 
-    const Array<Index> &get_nlist(Index pivot_l) const {
-      return nlists[pivot_l];
+    /// \brief Neighbor list of site 'pivot_l', nlist_size() entries
+    const long int *get_nlist(Index pivot_l) const {
+      return m_nlist->data() + pivot_l * m_nlist_size;
     };
 
+    /// \brief Number of entries in the neighbor list of each site
+    Index nlist_size() const {
+      return m_nlist_size;
+    }
+
+    /// \brief Neighbor lists of all sites, row-major num_sites() x nlist_size()
+    ///
+    /// The first volume() rows are the neighbor lists of the unit cells, which is the table
+    /// expected by Clexulator::calc_global_corr_batch, with row 'v' passed to Clexulator::set_nlist
+    /// for unit cell 'v'. Requires generate_neighbor_list().
+    const long int *nlist_table() const {
+      return m_nlist->data();
+    }
+
 
     ConfigList &get_config_list() {
       return config_list;
@@ -358,10 +426,19 @@ namespace CASM {
     // Populates m_trans_permute if needed
     const Array<Permutation> &translation_permute() const;
 
+    /// Factor group and translation permutations of the sites, computed as needed.
+    /// Constructed on first use.
+    const PrimGridPermute &grid_permute() const;
+
     // begin and end iterators for iterating over translation and factor group permutations
+    //   These use grid_permute(), so the full permutations are not stored
     permute_const_iterator permute_begin() const;
     permute_const_iterator permute_end() const;
 
+    /// Fast canonical form and is_canonical checks over [permute_begin(), permute_end()). Safe to
+    /// call from several threads; it is constructed by the first.
+    const ConfigCanonicalizer &canonicalizer() const;
+
     ///Return path to supercell directory
     fs::path get_path() const;
 
@@ -451,6 +528,10 @@ namespace CASM {
     bool add_config(const Configuration &config, Index &index, Supercell::permute_const_iterator &permute_it);
     bool add_canon_config(const Configuration &config, Index &index);
     void read_config_list(const jsonParser &json);
+    void read_config_list(const ConfigDatabase &db);
+
+    /// Rebuild the index used by contains_config. Call if Configuration occupations in config_list were modified in place.
+    void rebuild_config_index();
 
     template<typename ConfigIterType>
     void add_configs(ConfigIterType it_begin, ConfigIterType it_end);
@@ -467,6 +548,13 @@ namespace CASM {
     //    void populate_correlations(Clexulator &clexulator, const Index &config_index);
 
 
+  private:
+
+    /// Add config_list[index] to m_config_index
+    void _index_config(Index index);
+
+  public:
+
     // **** Other ****
     // Reads a relaxed structure and calculates the strains and stretches using the reference structure
     void read_relaxed_structure(Index configNum, const Lattice &home_lattice);
@@ -507,6 +595,9 @@ namespace CASM {
     ///Call Configuration::write out every configuration in supercell
     jsonParser &write_config_list(jsonParser &json);
 
+    ///Call ConfigDatabase::insert for every configuration in supercell
+    void write_config_list(ConfigDatabase &db);
+
     //void printUCC(std::ostream &stream, COORD_TYPE mode, UnitCellCoord ucc);
     // this function finds the displacements of a structure defined by the CONTCAR passed by stream, and the real_super_lattice
     void findConfigDisplacements(Structure tstruc, Index config_num);
@@ -0,0 +1,87 @@
+#ifndef CLUSTERKEY_HH
+#define CLUSTERKEY_HH
+
+#include <unordered_set>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
+
+namespace CASM {
+
+  class Structure;
+
+  /// \brief Integer key identifying a periodic cluster of sites, up to translation and site order
+  ///
+  /// The sites are sorted by (b, i, j, k), which is not changed by translation, and translated so
+  /// that the first site is in the origin unit cell. Two clusters have the same ClusterKey if and
+  /// only if one can be translated onto the other, as by GenericCluster::map_onto.
+  class ClusterKey {
+
+  public:
+
+    explicit ClusterKey(const std::vector<UnitCellCoord> &sites);
+
+    /// \brief Number of sites
+    Index size() const {
+      return m_key.size() / 4;
+    }
+
+    bool operator==(const ClusterKey &B) const {
+      return m_key == B.m_key;
+    }
+
+    std::size_t hash() const;
+
+  private:
+
+    /// b, i, j, k of each site
+    std::vector<long int> m_key;
+
+  };
+
+  struct ClusterKeyHash {
+    std::size_t operator()(const ClusterKey &key) const {
+      return key.hash();
+    }
+  };
+
+  typedef std::unordered_set<ClusterKey, ClusterKeyHash> ClusterKeySet;
+
+  /// \brief The factor group of a primitive Structure, acting on UnitCellCoord
+  ///
+  /// Site (b, t) goes to (b', R * t + t') under an operation, where R is the integer rotation
+  /// matrix of the operation in fractional coordinates and (b', t') is the image of site (b, 0, 0, 0),
+  /// as in Structure::basis_permutation_symrep. Applying an operation to a cluster is then a few
+  /// integer operations per site instead of applying a SymOp to each Coordinate.
+  class FactorGroupSiteMap {
+
+  public:
+
+    explicit FactorGroupSiteMap(const Structure &prim);
+
+    /// \brief Number of factor group operations
+    Index size() const {
+      return m_rotation.size() / 9;
+    }
+
+    /// \brief Image of 'ucc' under factor group operation 'op'
+    UnitCellCoord apply(Index op, const UnitCellCoord &ucc) const;
+
+    /// \brief Insert the keys of all clusters equivalent to the cluster of 'sites' into 'keys'
+    void insert_orbit(const std::vector<UnitCellCoord> &sites, ClusterKeySet &keys) const;
+
+  private:
+
+    /// rotation matrix of each operation, row major
+    std::vector<long int> m_rotation;
+
+    /// image of (b, 0, 0, 0) for each operation, m_basis_size per operation
+    std::vector<UnitCellCoord> m_basis_image;
+    Index m_basis_size;
+
+  };
+
+}
+
+#endif
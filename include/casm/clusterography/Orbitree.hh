@@ -21,6 +21,8 @@ namespace CASM {
 
   class Supercell;
 
+  class TaskScheduler;
+
   template<typename ClustType>
   class GenericOrbitree;
 
@@ -154,6 +156,8 @@ namespace CASM {
 
     //Finds all the clusters of a structure, based on the generative properties
     void generate_orbitree(const Structure &prim, bool verbose = false); //John
+    /// Same result as generate_orbitree(prim, verbose), using integer cluster keys and the threads of 'scheduler'
+    void generate_orbitree(const Structure &prim, TaskScheduler &scheduler, bool verbose = false);
     void generate_orbitree_TB(const Structure &prim); //AAB
     void generate_orbitree(const Structure &prim, const int maxClust); //Anirudh
     void generate_orbitree_neighbour(const Structure &prim, const Array<int> maxNeighbour); //Anirudh
@@ -1,6 +1,8 @@
 #include "casm/BP_C++/BP_Vec.hh"
 #include "casm/BP_C++/BP_Parse.hh"
 #include "casm/crystallography/Structure.hh"
+#include "casm/clusterography/ClusterKey.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
 
@@ -541,6 +543,199 @@ namespace CASM {
     return;
   }
 
+  //************************************************************
+  /**
+   * Constructs the same orbitree as generate_orbitree(prim, verbose),
+   * which it calls for local (non-periodic) clusters.
+   *
+   * Candidate clusters are identified by the ClusterKey of the
+   * UnitCellCoord of their sites, and looked up in a hash set holding
+   * the keys of every equivalent cluster of the orbits found so far.
+   * The equivalent clusters are generated with the integer
+   * FactorGroupSiteMap. This replaces 'contains', which compares
+   * Coordinates with every equivalent cluster of every orbit.
+   *
+   * For each OrbitBranch, the candidates grown from each orbit of the
+   * previous OrbitBranch are found in parallel, using the threads of
+   * 'scheduler'. New orbits are then added in the same order as by
+   * generate_orbitree(prim, verbose).
+   */
+  //************************************************************
+
+  template<typename ClustType>
+  void GenericOrbitree<ClustType>::generate_orbitree(const Structure &prim, TaskScheduler &scheduler, bool verbose) {
+
+    if(PERIODICITY_MODE::IS_LOCAL()) {
+      generate_orbitree(prim, verbose);
+      return;
+    }
+
+    if(prim.factor_group().size() == 0) {
+      std::cerr << "WARNING: In Orbitree::generate_orbitree, prim's factor_group is empty. It  must at least have one element (identity).\n";
+      assert(0);
+    }
+
+    Index i, j, np, no;
+    Vector3<int> dim; //size of gridstruc
+    double dist, min_dist;
+    Array<typename ClustType::WhichCoordType> basis, gridstruc;
+    Array<Index> basis_index;
+    std::vector<UnitCellCoord> grid_ucc;
+    std::vector<Vector3<double> > grid_cart;
+    std::string clean(80, ' ');
+
+    lattice = prim.lattice();
+    Coordinate lat_point(lattice);
+
+    // make the basis from which the sites for the local clusters are to be picked
+    if(verbose) std::cout << "* Finding Basis:\n";
+    for(i = 0; i < prim.basis.size(); i++) {
+      if(prim.basis[i].site_occupant().size() >= min_num_components) {
+        basis.push_back(prim.basis[i]);
+        basis.back().set_lattice(lattice);
+        basis_index.push_back(i);
+      }
+    }
+
+    double max_radius = max_length.max();
+    dim = lattice.enclose_sphere(max_radius);
+    Counter<Vector3<int> > grid_count(-dim, dim, Vector3<int>(1));
+    if(verbose) std::cout << "dim is " << dim << '\n';
+    if(verbose) std::cout << "\n Finding Grid_struc:\n";
+    do {
+      lat_point(FRAC) = grid_count();
+
+      for(i = 0; i < basis.size(); i++) {
+        typename ClustType::WhichCoordType tatom(basis[i] + lat_point);
+
+        min_dist = 1e20;
+        for(j = 0; j < basis.size(); j++) {
+          dist = tatom.dist(basis[j]);
+          if(dist < min_dist)
+            min_dist = dist;
+        }
+        if(min_dist < max_radius) {
+          gridstruc.push_back(tatom);
+          grid_ucc.push_back(UnitCellCoord(basis_index[i], grid_count()[0], grid_count()[1], grid_count()[2]));
+          grid_cart.push_back(tatom(CART));
+        }
+      }
+    }
+    while(++grid_count);
+
+    if(verbose) std::cout << "Finished finding grid_struc\n";
+    if(size())
+      std::cerr << "WARNING:  Orbitree is about to be overwritten! Execution will continue normally, but side effects may occur.\n";
+
+    resize(max_num_sites + 1);
+
+    // Add orbit corresponding to empty cluster
+    at(0).push_back(GenericOrbit<ClustType>(ClustType(lattice)));
+    at(0).back().get_equivalent(prim.factor_group());
+    at(0).back().get_cluster_symmetry();
+
+    FactorGroupSiteMap site_map(prim);
+    ClusterKeySet keys;
+
+    if(!verbose) std::cout << clean << '\r' << "About to begin construction of non-empty clusters\r" << std::flush;
+    for(np = 1; np <= max_num_sites; np++) {
+      if(verbose) std::cout << "Doing np = " << np << '\n';
+      else std::cout << clean << '\r' << "Doing np = " << np << '\r' << std::flush;
+
+      if(size(np - 1) == 0) {
+        std::cerr << "CRITICAL ERROR: Orbitree::generate_orbitree is unable to enumerate clusters of size " << np << '\n';
+        get_index();
+        print(std::cout);
+        exit(1);
+      }
+
+      // the prototypes of the previous branch, translated so that their first site is within the
+      // unit cell, which are the sites that tclust starts with in generate_orbitree(prim, verbose)
+      std::vector<ClustType> base;
+      std::vector<std::vector<UnitCellCoord> > proto_ucc(size(np - 1));
+      std::vector<std::vector<Vector3<double> > > proto_cart(size(np - 1));
+      for(no = 0; no < size(np - 1); no++) {
+        base.push_back(ClustType(lattice));
+        for(i = 0; i < prototype(np - 1, no).size(); i++)
+          base.back().push_back(prototype(np - 1, no)[i]);
+        base.back().within();
+
+        // const access, so that the sites keep their fractional coordinates
+        const ClustType &tbase = base.back();
+        for(i = 0; i < tbase.size(); i++) {
+          proto_ucc[no].push_back(prim.get_unit_cell_coord(tbase[i]));
+          proto_cart[no].push_back(tbase[i](CART));
+        }
+      }
+
+      // indices into gridstruc and keys of the clusters, grown from each prototype, that satisfy the size requirements
+      std::vector<std::vector<std::pair<Index, ClusterKey> > > candidates(size(np - 1));
+      scheduler.parallel_for(0, size(np - 1), [&](Index begin, Index end) {
+        for(Index o = begin; o < end; o++) {
+          const std::vector<Vector3<double> > &cart = proto_cart[o];
+          std::vector<UnitCellCoord> sites(proto_ucc[o]);
+          sites.push_back(UnitCellCoord());
+
+          for(Index g = 0; g < gridstruc.size(); g++) {
+
+            // the lengths of the cluster, as GenericCluster::calc_properties
+            if(np > 1) {
+              double max_len = (cart[0] - grid_cart[g]).length();
+              double min_len = max_len;
+              for(Index a = 0; a < cart.size(); a++) {
+                double len = (cart[a] - grid_cart[g]).length();
+                max_len = std::max(max_len, len);
+                min_len = std::min(min_len, len);
+                for(Index b = a + 1; b < cart.size(); b++) {
+                  len = (cart[a] - cart[b]).length();
+                  max_len = std::max(max_len, len);
+                  min_len = std::min(min_len, len);
+                }
+              }
+              if(!(max_len < max_length[np] && min_len > min_length)) {
+                continue;
+              }
+            }
+
+            sites.back() = grid_ucc[g];
+            candidates[o].push_back(std::make_pair(g, ClusterKey(sites)));
+          }
+        }
+      }, 1);
+
+      for(no = 0; no < size(np - 1); no++) {
+        if(verbose) std::cout << "Adding sites to orbit " << no << " of " << size(np - 1) << "\n";
+
+        for(const auto &candidate : candidates[no]) {
+          if(keys.count(candidate.second)) {
+            continue;
+          }
+
+          ClustType tclust(lattice);
+          for(i = 0; i < base[no].size(); i++)
+            tclust.push_back(base[no][i]);
+          tclust.push_back(gridstruc[candidate.first]);
+          tclust.within();
+          tclust.calc_properties();
+
+          at(np).push_back(GenericOrbit<ClustType>(tclust));
+          at(np).back().get_equivalent(prim.factor_group());
+          at(np).back().get_cluster_symmetry();
+
+          std::vector<UnitCellCoord> sites(proto_ucc[no]);
+          sites.push_back(grid_ucc[candidate.first]);
+          site_map.insert_orbit(sites, keys);
+        }
+      }
+    }
+
+    if(!verbose) std::cout << clean << '\r' << std::flush;
+
+    sort();
+    get_index();
+    return;
+  }
+
   //****************************************************************************************************************
   /**
    * Constructs an orbitree given a primitive Structure and the max number of clusters that the user wants
@@ -14,6 +14,7 @@ namespace CASM {
   class Coordinate;
   class UnitCellCoord;
   class SiteCluster;
+  class PeriodicCellList;
   class MasterSymGroup;
   template<typename ClustType> class GenericOrbitree;
   typedef GenericOrbitree<SiteCluster> SiteOrbitree;
@@ -60,6 +61,14 @@ namespace CASM {
     template<typename CoordType2>
     Index find(const CoordType2 &test_site, const Coordinate &shift, double tol) const;
 
+    /// same as find(test_site, tol), checking only the sites near test_site in 'cells',
+    /// a PeriodicCellList of the basis, as from basis_cell_list(radius), with radius >= tol
+    template<typename CoordType2>
+    Index find(const CoordType2 &test_site, const PeriodicCellList &cells, double tol = TOL) const;
+
+    /// PeriodicCellList of the basis sites, for finding sites within 'radius' of a position
+    PeriodicCellList basis_cell_list(double radius = TOL) const;
+
     const Lattice &lattice() const {
       return m_lattice;
     }
@@ -69,6 +78,10 @@ namespace CASM {
     template<typename CoordType2>
     UnitCellCoord get_unit_cell_coord(const CoordType2 &test_site, double tol = TOL)const;
 
+    /// same as get_unit_cell_coord(test_site, tol), using 'cells' as in find(test_site, cells, tol)
+    template<typename CoordType2>
+    UnitCellCoord get_unit_cell_coord(const CoordType2 &test_site, const PeriodicCellList &cells, double tol = TOL)const;
+
     // ****Mutators****
 
     //   - Basic assignment/bookkeeping
@@ -5,9 +5,11 @@
 
 #include "casm/crystallography/UnitCellCoord.hh"
 #include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/PeriodicCellList.hh"
 #include "casm/symmetry/SymPermutation.hh"
 #include "casm/symmetry/SymBasisPermute.hh"
 #include "casm/symmetry/SymGroupRep.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
   template<typename CoordType>
@@ -102,11 +104,6 @@ namespace CASM {
     //std::cout << "SLOW GENERATION OF FACTOR GROUP " << &factor_group << "\n";
     //std::cout << "begin generate_factor_group_slow() " << this << std::endl;
 
-    Array<CoordType> tsite;
-    Index pg, b0, b1, b2;
-    Coordinate t_tau(lattice());
-    Index num_suc_maps;
-
     SymGroup point_group;
     //reset();
     lattice().generate_point_group(point_group, map_tol);
@@ -117,58 +114,108 @@ namespace CASM {
       factor_group.clear();
     }
 
-    //Loop over all point group ops of the lattice
-    for(pg = 0; pg < point_group.size(); pg++) {
-      tsite.clear();
-      //First, generate the symmetrically transformed basis sites
-      //Loop over all sites in basis
-      for(b0 = 0; b0 < basis.size(); b0++) {
-        tsite.push_back(point_group[pg]*basis[b0]);
+    // Site types and coordinates are cached on first use; do that here, before the
+    // point group operations are checked in parallel
+    Index ref = 0, ref_count = basis.size() + 1;
+    for(Index b0 = 0; b0 < basis.size(); b0++) {
+      basis[b0](CART);
+      basis[b0](FRAC);
+      Index count = 0;
+      for(Index b1 = 0; b1 < basis.size(); b1++) {
+        if(basis[b0].compare_type(basis[b1]))
+          count++;
       }
+      // Translations are found by mapping the site of the least common type, so there are as few
+      // as possible to check
+      if(count < ref_count) {
+        ref = b0;
+        ref_count = count;
+      }
+    }
 
-      //Using the symmetrically transformed basis, find all possible translations
-      //that MIGHT map the symmetrically transformed basis onto the original basis
-      for(b0 = 0; b0 < tsite.size(); b0++) {
-
-        if(!basis[0].compare_type(tsite[b0]))
-          continue;
-
-        t_tau = basis[0] - tsite[b0];
-
-        t_tau.within();
-        num_suc_maps = 0; //Keeps track of number of old->new basis site mappings that are found
-
-        double tdist = 0.0;
-        double max_error = 0.0;
-        for(b1 = 0; b1 < basis.size(); b1++) { //Loop over original basis sites
-          for(b2 = 0; b2 < tsite.size(); b2++) { //Loop over symmetrically transformed basis sites
-
-            //see if translation successfully maps the two sites
-            if(basis[b1].compare(tsite[b2], t_tau, map_tol)) {
-              tdist = basis[b1].min_dist(tsite[b2], t_tau);
-              if(tdist > max_error) {
-                max_error = tdist;
+    // The operations found for each point group operation, with the index of the transformed
+    // site that maps onto basis[0], which gives the order they are added to the factor group
+    std::vector<std::vector<std::pair<Index, SymOp> > > found(point_group.size());
+
+    global_scheduler().parallel_for(0, point_group.size(), [&](Index begin, Index end) {
+      Array<CoordType> tsite;
+      std::vector<Vector3<double> > tsite_frac;
+      std::vector<Index> near;
+
+      for(Index pg = begin; pg < end; pg++) {
+        tsite.clear();
+        tsite_frac.clear();
+        //First, generate the symmetrically transformed basis sites
+        //Loop over all sites in basis
+        for(Index b0 = 0; b0 < basis.size(); b0++) {
+          tsite.push_back(point_group[pg]*basis[b0]);
+          const CoordType &ctsite = tsite.back();
+          tsite_frac.push_back(ctsite(FRAC));
+        }
+        PeriodicCellList cells(lattice(), tsite_frac, map_tol);
+
+        //Using the symmetrically transformed basis, find all possible translations
+        //that MIGHT map the symmetrically transformed basis onto the original basis
+        for(Index b0 = 0; b0 < tsite.size(); b0++) {
+
+          if(!basis[ref].compare_type(tsite[b0]))
+            continue;
+
+          Coordinate t_tau(lattice());
+          const Coordinate &ct_tau = t_tau;
+          t_tau = basis[ref] - tsite[b0];
+
+          t_tau.within();
+
+          Index b1, b0_map = 0;
+          double tdist = 0.0;
+          double max_error = 0.0;
+          for(b1 = 0; b1 < basis.size(); b1++) { //Loop over original basis sites
+
+            //Loop over the symmetrically transformed basis sites that may map onto basis[b1]
+            cells.near(basis[b1](FRAC) - ct_tau(FRAC), near);
+            Index i;
+            for(i = 0; i < near.size(); i++) {
+
+              //see if translation successfully maps the two sites
+              if(basis[b1].compare(tsite[near[i]], t_tau, map_tol)) {
+                tdist = basis[b1].min_dist(tsite[near[i]], t_tau);
+                if(tdist > max_error) {
+                  max_error = tdist;
+                }
+                if(b1 == 0) {
+                  b0_map = near[i];
+                }
+                break;
               }
-              num_suc_maps++;
+            }
+
+            //break out of outer loop if inner loop finds no successful map
+            if(i == near.size()) {
               break;
             }
           }
 
-          //break out of outer loop if inner loop finds no successful map
-          if(b2 == tsite.size()) {
-            break;
+          //If all atoms in the basis are mapped successfully, keep the corresponding
+          //symmetry operation
+          if(b1 == basis.size()) {
+            SymOp tSym(SymOp(t_tau)*point_group[pg]);
+            tSym.set_map_error(max_error);
+            found[pg].push_back(std::make_pair(b0_map, tSym));
           }
         }
-
-        //If all atoms in the basis are mapped successfully, try to add the corresponding
-        //symmetry operation to the factor_group
-        if(num_suc_maps == basis.size()) {
-          SymOp tSym(SymOp(t_tau)*point_group[pg]);
-          tSym.set_map_error(max_error);
-
-          if(!factor_group.contains(tSym)) {
-            factor_group.push_back(tSym);
-          }
+      }
+    });
+
+    // Add the operations to the factor_group in the order of trial translations basis[0] - tsite[b0]
+    for(Index pg = 0; pg < point_group.size(); pg++) {
+      std::stable_sort(found[pg].begin(), found[pg].end(),
+      [](const std::pair<Index, SymOp> &A, const std::pair<Index, SymOp> &B) {
+        return A.first < B.first;
+      });
+      for(const std::pair<Index, SymOp> &op : found[pg]) {
+        if(!factor_group.contains(op.second)) {
+          factor_group.push_back(op.second);
         }
       }
     } //End loop over point_group operations
@@ -283,46 +330,62 @@ namespace CASM {
     }
     SymGroupRep permute_group(factor_group);
     Index rep_id;
-    CoordType tsite(basis[0]);
-    CASM::BasicStructure<CoordType> sym_tstruc = (*this);
-    Array<Index> tArr;
 
     std::string clr(100, ' ');
-
-    for(Index symOp_num = 0; symOp_num < factor_group.size(); symOp_num++) {
-      if(verbose) {
-        if(symOp_num % 100 == 0)
-          std::cout << '\r' << clr.c_str() << '\r' << "Find permute rep for symOp " << symOp_num << "/" << factor_group.size() << std::flush;
-      }
-      int flag;
-      tArr.clear();
-      // Applies the symmetry operation
-      //sym_tstruc = factor_group[symOp_num] * (*this);  <-- slow due to memory copying
-      for(Index i = 0; i < basis.size(); i++) {
-        tsite = basis[i];
-        sym_tstruc.basis[i] = tsite.apply_sym(factor_group[symOp_num]);
-      }
-      for(Index i = 0; i < sym_tstruc.basis.size(); i++) {
-        // Moves the atom within the unit cell
-        sym_tstruc.basis[i].within();
-        flag = 0;
-        // tries to locate the transformed basis in the untransformed structure
-        for(Index j = 0; j < basis.size(); j++) {
-          if(sym_tstruc.basis[i].compare(basis[j])) {
-            tArr.push_back(j);
-            flag = 1;
+    if(verbose) {
+      std::cout << '\r' << clr.c_str() << '\r' << "Find permute rep for " << factor_group.size() << " symOps" << std::flush;
+    }
+
+    // Site types and coordinates are cached on first use, and new site types are added to a
+    // shared table; do that here, before the factor group operations are applied in parallel
+    for(Index b = 0; b < basis.size(); b++) {
+      basis[b](CART);
+      basis[b](FRAC);
+      basis[b].compare_type(basis[b]);
+    }
+
+    PeriodicCellList cells = basis_cell_list();
+
+    std::vector<Array<Index> > perm(factor_group.size());
+    std::vector<char> failed(factor_group.size(), false);
+
+    global_scheduler().parallel_for(0, factor_group.size(), [&](Index begin, Index end) {
+      std::vector<Index> near;
+      for(Index symOp_num = begin; symOp_num < end; symOp_num++) {
+        Array<Index> &tArr = perm[symOp_num];
+        for(Index i = 0; i < basis.size(); i++) {
+          // Applies the symmetry operation and moves the atom within the unit cell
+          CoordType tsite(basis[i]);
+          tsite.apply_sym(factor_group[symOp_num]);
+          tsite.within();
+          const CoordType &ctsite = tsite;
+
+          // tries to locate the transformed basis in the untransformed structure
+          cells.near(ctsite(FRAC), near);
+          Index j;
+          for(j = 0; j < near.size(); j++) {
+            if(tsite.compare(basis[near[j]])) {
+              tArr.push_back(near[j]);
+              break;
+            }
+          }
+          if(j == near.size()) {
+            failed[symOp_num] = true;
             break;
           }
         }
-        if(!flag) {
-          //Quits if it wasnt able to perform the mapping
-          std::cerr << "\nWARNING:  In BasicStructure::generate_permutation_representation ---"
-                    << "            Something is wrong with your factor group operations. I\'m quitting!\n";
-          exit(1);
-        }
+      }
+    });
+
+    for(Index symOp_num = 0; symOp_num < factor_group.size(); symOp_num++) {
+      if(failed[symOp_num]) {
+        //Quits if it wasnt able to perform the mapping
+        std::cerr << "\nWARNING:  In BasicStructure::generate_permutation_representation ---"
+                  << "            Something is wrong with your factor group operations. I\'m quitting!\n";
+        exit(1);
       }
       // Creates a new SymGroupRep
-      permute_group.push_back(SymPermutation(tArr));
+      permute_group.push_back(SymPermutation(perm[symOp_num]));
     }
     // Adds the representation into the master sym group of this structure and returns the rep id
     rep_id = factor_group.add_representation(permute_group);
@@ -352,26 +415,38 @@ namespace CASM {
     SymGroupRep basis_permute_group(factor_group);
     Index rep_id;
 
-    CoordType tsite(basis[0]);
-    Array<UnitCellCoord> new_ucc(basis.size());
-
     std::string clr(100, ' ');
+    if(verbose) {
+      std::cout << '\r' << clr.c_str() << '\r' << "Find permute rep for " << factor_group.size() << " symOps" << std::flush;
+    }
 
-    for(Index ng = 0; ng < factor_group.size(); ng++) {
-      if(verbose) {
-        if(ng % 100 == 0)
-          std::cout << '\r' << clr.c_str() << '\r' << "Find permute rep for symOp " << ng << "/" << factor_group.size() << std::flush;
-      }
+    // Site types and coordinates are cached on first use, and new site types are added to a
+    // shared table; do that here, before the factor group operations are applied in parallel
+    for(Index b = 0; b < basis.size(); b++) {
+      basis[b](CART);
+      basis[b](FRAC);
+      basis[b].compare_type(basis[b]);
+    }
 
-      // Applies the symmetry operation
-      //sym_tstruc = factor_group[ng] * (*this);  <-- slow due to memory copying
-      for(Index nb = 0; nb < basis.size(); nb++) {
-        tsite = basis[nb];
-        tsite.apply_sym(factor_group[ng]);
-        new_ucc[nb] = get_unit_cell_coord(tsite);
+    PeriodicCellList cells = basis_cell_list();
+
+    std::vector<Array<UnitCellCoord> > new_ucc(factor_group.size(), Array<UnitCellCoord>(basis.size()));
+
+    global_scheduler().parallel_for(0, factor_group.size(), [&](Index begin, Index end) {
+      for(Index ng = begin; ng < end; ng++) {
+        // Applies the symmetry operation
+        //sym_tstruc = factor_group[ng] * (*this);  <-- slow due to memory copying
+        for(Index nb = 0; nb < basis.size(); nb++) {
+          CoordType tsite(basis[nb]);
+          tsite.apply_sym(factor_group[ng]);
+          new_ucc[ng][nb] = get_unit_cell_coord(tsite, cells);
+        }
       }
+    });
+
+    for(Index ng = 0; ng < factor_group.size(); ng++) {
       // Creates a new SymGroupRep
-      basis_permute_group.push_back(SymBasisPermute(new_ucc));
+      basis_permute_group.push_back(SymBasisPermute(new_ucc[ng]));
     }
     // Adds the representation into the master sym group of this structure and returns the rep id
     rep_id = factor_group.add_representation(basis_permute_group);
@@ -382,7 +457,6 @@ namespace CASM {
     return rep_id;
   }
 
-
   //***********************************************************
   /**
    * It is NOT wise to use this function unless you have already
@@ -720,6 +794,31 @@ namespace CASM {
     return basis.size();
   }
 
+  //***********************************************************
+
+  template<typename CoordType> template<typename CoordType2>
+  Index BasicStructure<CoordType>::find(const CoordType2 &test_site, const PeriodicCellList &cells, double tol) const {
+    std::vector<Index> near;
+    cells.near(test_site(FRAC), near);
+    for(Index i : near) {
+      if(basis[i].compare(test_site, tol)) {
+        return i;
+      }
+    }
+    return basis.size();
+  }
+
+  //***********************************************************
+
+  template<typename CoordType>
+  PeriodicCellList BasicStructure<CoordType>::basis_cell_list(double radius) const {
+    std::vector<Vector3<double> > frac;
+    for(Index i = 0; i < basis.size(); i++) {
+      frac.push_back(basis[i](FRAC));
+    }
+    return PeriodicCellList(lattice(), frac, radius);
+  }
+
   //John G 070713
   //***********************************************************
   /**
@@ -758,6 +857,33 @@ namespace CASM {
     return UnitCellCoord(b, x, y, z);
   };
 
+  //***********************************************************
+
+  template<typename CoordType> template<typename CoordType2>
+  UnitCellCoord BasicStructure<CoordType>::get_unit_cell_coord(const CoordType2 &bsite, const PeriodicCellList &cells, double tol) const {
+
+    CoordType2 tsite = bsite;
+
+    tsite.set_lattice(lattice(), CART);
+
+    const CoordType2 &ctsite = tsite;
+    Index b = find(ctsite, cells, tol);
+
+    if(b == basis.size()) {
+      std::cerr << "ERROR in BasicStructure::get_unit_cell_coord" << std::endl
+                << "Could not find a matching basis site." << std::endl
+                << "  Looking for: FRAC: " << ctsite(FRAC) << "\n"
+                << "               CART: " << ctsite(CART) << "\n";
+      exit(1);
+    }
+
+    int x = round(ctsite.get(0, FRAC) - basis[b].get(0, FRAC));
+    int y = round(ctsite.get(1, FRAC) - basis[b].get(1, FRAC));
+    int z = round(ctsite.get(2, FRAC) - basis[b].get(2, FRAC));
+
+    return UnitCellCoord(b, x, y, z);
+  };
+
 
   //*******************************************************************************************
 
@@ -29,6 +29,10 @@ namespace CASM {
 
     //int periodicity_dim;   //dimension of periodicity
     //int periodicity_axis;  //index of lattice vector that is non-periodic (2d) or periodic (1d)
+
+    /// generate_point_group, without the cache
+    void _generate_point_group(SymGroup &point_group, double pg_tol) const;
+
   public:
     //Lattice properties
     //lengths -> lattice parameters
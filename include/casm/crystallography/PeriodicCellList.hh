@@ -0,0 +1,56 @@
+#ifndef PERIODICCELLLIST_HH
+#define PERIODICCELLLIST_HH
+
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/LinearAlgebra.hh"
+
+namespace CASM {
+
+  class Lattice;
+
+  /// \brief Periodic cell list of points in a unit cell, for finding the points near a position
+  ///
+  /// The unit cell is divided into a grid of cells along the lattice vectors. Each cell is at
+  /// least 'radius' across, so the points within 'radius' of a position, including periodic
+  /// images, are in the cell of that position or its neighboring cells. Structure symmetry
+  /// methods use it so that finding the basis site matching a transformed site looks at a few
+  /// sites instead of all of them.
+  ///
+  class PeriodicCellList {
+
+  public:
+
+    /// \brief Construct from the fractional coordinates of the points
+    ///
+    /// \param lat The lattice that 'frac' is relative to
+    /// \param radius The largest distance, in Angstr., that will be searched with 'near'
+    PeriodicCellList(const Lattice &lat, const std::vector<Vector3<double> > &frac, double radius);
+
+    /// \brief Indices, in increasing order, of the points that may be within 'radius' of 'frac'
+    ///
+    /// All points within 'radius' are included, some further away may be as well.
+    void near(const Vector3<double> &frac, std::vector<Index> &result) const;
+
+  private:
+
+    /// Cell indices of a fractional coordinate
+    Vector3<int> _cell(const Vector3<double> &frac) const;
+
+    Index _linear(int i, int j, int k) const {
+      return i + m_n[0] * (j + m_n[1] * k);
+    }
+
+    /// number of cells along each lattice vector
+    Vector3<int> m_n;
+
+    /// m_cell_begin[c] to m_cell_begin[c + 1]: range of m_index of the points in cell c
+    std::vector<Index> m_cell_begin;
+    std::vector<Index> m_index;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef PRIMGRIDPERMUTE_HH
+#define PRIMGRIDPERMUTE_HH
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/LinearAlgebra.hh"
+#include "casm/container/Permutation.hh"
+
+namespace CASM {
+
+  class PrimGrid;
+  class SymGroup;
+
+  /// \brief Site permutations of a PrimGrid, for factor group operations combined with translations,
+  /// computed as needed instead of stored
+  ///
+  /// Site 'i' of the supercell is sublattice b = i / size() at canonical PrimGrid coordinate
+  /// mnp = (m, n, p), with i % size() = m + n*S(0) + p*S(0)*S(1). Factor group operation 'f'
+  /// combined with translation 't' (as in PermuteIterator) takes the occupant of site
+  ///
+  ///     permute_ind(f, t, i) = (sublat[b], (F*(mnp - mnp(t)) + shift[b]) mod S)
+  ///
+  /// to site i, where F is the inverse of the integer action of 'f' on canonical coordinates. So
+  /// each operation is stored as a 3x3 integer matrix plus a source sublattice and shift for each
+  /// sublattice, instead of a Permutation of all num_sites(), and translations are not stored at
+  /// all. This is the same permutation as
+  ///
+  ///     factor_group_permute(f)[prim_grid.translation_permutation(t)[i]]
+  ///
+  /// Use permute_ind_block or permute to get many sites at a time, which step through
+  /// canonical coordinates with additions only.
+  ///
+  class PrimGridPermute {
+
+  public:
+
+    /// \brief Construct for the operations of 'group', which should leave the supercell lattice
+    /// of 'prim_grid' invariant, such as Supercell::factor_group()
+    ///
+    /// \param basis_permute_ID ID of the basis permutation representation of the prim factor group
+    PrimGridPermute(const PrimGrid &prim_grid, const SymGroup &group, Index basis_permute_ID);
+
+    /// \brief PrimGrid of the supercell
+    const PrimGrid &prim_grid() const {
+      return *m_prim_grid;
+    }
+
+    /// \brief Factor group operations, in the order of their index 'f'
+    const SymGroup &factor_group() const {
+      return *m_group;
+    }
+
+    /// \brief Number of sites, basis_size * prim_grid().size()
+    Index size() const {
+      return m_N;
+    }
+
+    /// \brief Index of the site taken to site 'i' by factor group operation 'f' and translation 't'
+    ///
+    /// after_array[i] = before_array[permute_ind(f, t, i)]
+    Index permute_ind(Index f, Index t, Index i) const;
+
+    /// \brief Set result[i - begin] = permute_ind(f, t, i), for i in [begin, end)
+    void permute_ind_block(Index f, Index t, Index begin, Index end, Index *result) const;
+
+    /// \brief Set after[i] = before[permute_ind(f, t, i)] for all size() sites
+    template<typename T>
+    void permute(Index f, Index t, const T *before, T *after) const;
+
+    /// \brief Permutation of factor group operation 'f' combined with translation 't'
+    Permutation permutation(Index f, Index t) const;
+
+    /// \brief Permutation of factor group operation 'f' alone, constructed on first use
+    const Permutation &factor_group_permute(Index f) const;
+
+  private:
+
+    /// \brief Canonical coordinates, and the shift due to the translation, of combined operation (f, t)
+    ///
+    /// The shift of sublattice b is m_shift(f, b) + shift_t, so nothing is allocated per operation
+    struct AffineOp {
+      /// F(i, j), already mod S(i), so that each step adds less than S(i)
+      int F[3][3];
+      /// -F*mnp(t), mod S(i)
+      int shift_t[3];
+    };
+
+    /// \brief The AffineOp for factor group operation f combined with translation t
+    AffineOp _affine_op(Index f, Index t) const;
+
+    /// \brief Canonical coordinates of linear PrimGrid index l
+    void _mnp(Index l, int mnp[3]) const {
+      mnp[0] = l % m_S[0];
+      mnp[1] = (l / m_S[0]) % m_S[1];
+      mnp[2] = l / (m_S[0] * m_S[1]);
+    }
+
+    /// \brief Call 'visit(i, source)' for each site i in [begin, end), in order
+    template<typename Visitor>
+    void _for_each(Index f, Index t, Index begin, Index end, Visitor visit) const;
+
+    PrimGrid const *m_prim_grid;
+    SymGroup const *m_group;
+
+    /// number of sites, PrimGrid size and basis size
+    Index m_N;
+    Index m_vol;
+    Index m_NB;
+
+    /// Smith normal form diagonal, as in PrimGrid
+    int m_S[3];
+
+    /// For each factor group operation f, the inverse of its action on canonical coordinates, and
+    /// for each sublattice b the source sublattice m_sublat[f*m_NB + b] and the canonical shift
+    /// m_shift[3*(f*m_NB + b) + i], mod S(i)
+    std::vector<Matrix3<int> > m_F;
+    std::vector<Index> m_sublat;
+    std::vector<int> m_shift;
+
+    /// factor group Permutations, only constructed if requested through factor_group_permute
+    mutable std::vector<std::unique_ptr<Permutation> > m_fg_permute;
+    mutable std::mutex m_fg_permute_mutex;
+
+  };
+
+  //*******************************************************************************************
+
+  template<typename Visitor>
+  void PrimGridPermute::_for_each(Index f, Index t, Index begin, Index end, Visitor visit) const {
+
+    if(begin >= end) {
+      return;
+    }
+
+    AffineOp op = _affine_op(f, t);
+
+    Index i = begin;
+    Index b = i / m_vol;
+    int mnp[3];
+    _mnp(i % m_vol, mnp);
+
+    while(i < end) {
+
+      Index src_offset = m_sublat[f * m_NB + b] * m_vol;
+      const int *shift = &m_shift[3 * (f * m_NB + b)];
+
+      // source coordinates y = F*mnp + shift, mod S, at the start of this row of constant (n, p)
+      int y[3];
+      for(int r = 0; r < 3; r++) {
+        long int sum = shift[r] + op.shift_t[r];
+        for(int c = 0; c < 3; c++) {
+          sum += long(op.F[r][c]) * mnp[c];
+        }
+        y[r] = sum % m_S[r];
+      }
+
+      // step m along the row, adding column 0 of F
+      Index row_end = std::min(end, i + (m_S[0] - mnp[0]));
+      for(; i < row_end; i++) {
+        visit(i, src_offset + y[0] + m_S[0] * (y[1] + m_S[1] * Index(y[2])));
+        for(int r = 0; r < 3; r++) {
+          y[r] += op.F[r][0];
+          if(y[r] >= m_S[r]) {
+            y[r] -= m_S[r];
+          }
+        }
+      }
+
+      // next row
+      mnp[0] = 0;
+      if(++mnp[1] == m_S[1]) {
+        mnp[1] = 0;
+        if(++mnp[2] == m_S[2]) {
+          mnp[2] = 0;
+          b++;
+        }
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  template<typename T>
+  void PrimGridPermute::permute(Index f, Index t, const T *before, T *after) const {
+    _for_each(f, t, 0, m_N, [&](Index i, Index source) {
+      after[i] = before[source];
+    });
+  }
+
+}
+
+#endif
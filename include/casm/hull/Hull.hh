@@ -6,6 +6,12 @@
 
 namespace CASM {
 
+  ///Run through configurations, and collect the energy and composition of the valid configurations.
+  template<typename ConSelectOutputIterator>
+  Eigen::MatrixXd hull_points(ConfigSelectionIterator<false, false> begin,
+                              ConfigSelectionIterator<false, false> end,
+                              ConSelectOutputIterator valid_config);
+
   ///Run through configurations, and make a hull out of them, keeping track of the valid configurations.
   template<typename ConSelectOutputIterator>
   bool populate_convex_hull(BP::Geo &hull,
@@ -14,24 +20,26 @@ namespace CASM {
                             ConSelectOutputIterator valid_config);
 
   ///Run through all the configurations and update hull variables into generated Properties. Also return hull in json.
+  ///
+  /// The hull is cached for each calctype, ref, and 'selection', which names the selection that
+  /// [begin, end) is taken from
   jsonParser update_hull_props(PrimClex &primclex,
                                ConfigSelectionIterator<false, false> begin,
                                ConfigSelectionIterator<false, false> end,
+                               const std::string &selection,
                                double geo_tol = 0.0005);
 
 
 
   /**
    * For every configuration that's selected, check to see if it has relaxed_energy. If it does, then include
-   * its energy and composition into a list. Once we have all the energies, we use the list to generate the convex
-   * hull. Because we may not use all the configurations, also keep track of the indices of supercells
-   * and configurations that were used to make hull.
+   * its energy and composition into a list. Because we may not use all the configurations, also keep track
+   * of the configurations that were used.
    */
   template<typename ConSelectOutputIterator>
-  bool populate_convex_hull(BP::Geo &hull,
-                            ConfigSelectionIterator<false, false> begin,
-                            ConfigSelectionIterator<false, false> end,
-                            ConSelectOutputIterator valid_config) {
+  Eigen::MatrixXd hull_points(ConfigSelectionIterator<false, false> begin,
+                              ConfigSelectionIterator<false, false> end,
+                              ConSelectOutputIterator valid_config) {
 
     //As we go through, we store the energies and compositions. These will then get put into an Eigen matrix
     Array<double> energies;
@@ -91,6 +99,20 @@ namespace CASM {
     //x2   ...   ...   ...   ...   ...
     //...  ...   ...   ...   ...   ...
 
+    return enercomps;
+  }
+
+  /**
+   * Once we have all the energies and compositions from hull_points, we use them to generate the convex hull.
+   */
+  template<typename ConSelectOutputIterator>
+  bool populate_convex_hull(BP::Geo &hull,
+                            ConfigSelectionIterator<false, false> begin,
+                            ConfigSelectionIterator<false, false> end,
+                            ConSelectOutputIterator valid_config) {
+
+    Eigen::MatrixXd enercomps = hull_points(begin, end, valid_config);
+
     //Let the BP magic begin
     //We start by making a BP::Geo object for our hull
     hull.reset_points(enercomps, true); //Check for repeats is good?
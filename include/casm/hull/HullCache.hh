@@ -0,0 +1,185 @@
+#ifndef CASM_HullCache
+#define CASM_HullCache
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/BP_C++/BP_Geo.hh"
+
+namespace CASM {
+
+  class jsonParser;
+
+  /// \brief The bottom of a convex hull, and the distance to it of every point it was built from
+  ///
+  /// Points are columns of a matrix: the energy in row 0, followed by the composition. Each point
+  /// is labeled by a name (e.g. the configname), and the cache is keyed on the values of the
+  /// labeled points it was built from, so that it can be stored (see HullCache::write) and brought
+  /// up to date with HullCache::update without rebuilding the hull:
+  ///
+  /// - A point that is new, or whose energy or composition changed, and that lies above the
+  ///   current hull, does not change the hull, and is inserted by finding its distance to the hull.
+  /// - A point that is not a hull vertex can be removed without changing the hull.
+  /// - Otherwise, including when a hull vertex only moves down in energy, only the hull vertices
+  ///   and the points below or outside the current hull can be vertices of the new hull, because
+  ///   it lies on or below the current hull. The hull is rebuilt from those points only, which for
+  ///   large data sets is usually a small fraction of all points.
+  /// - If a hull vertex is removed, moved up, or changes composition, the hull is rebuilt from all
+  ///   points.
+  ///
+  /// Each facet of the bottom of the hull is stored as the plane E(x) = c + g.dot(x), so the energy
+  /// of the hull at any composition in its domain is the maximum over facets, and distances for
+  /// any number of points are found at once with a matrix product.
+  ///
+  class HullCache {
+
+  public:
+
+    /// \brief Construct an empty cache
+    ///
+    /// \param _tol A point whose distance to the hull is less than this is treated as though it
+    ///        may be on the hull when deciding whether the hull must be rebuilt
+    explicit HullCache(double _tol = 1e-8);
+
+    /// \brief Bring the cache up to date with 'points', labeled by 'names'
+    ///
+    /// \returns false if the hull could not be found, in which case the cache is empty
+    bool update(const std::vector<std::string> &_names, const Eigen::MatrixXd &_points);
+
+    /// \brief Number of points
+    Index size() const {
+      return m_names.size();
+    }
+
+    /// \brief Names of the points, in the order given to the last update
+    const std::vector<std::string> &names() const {
+      return m_names;
+    }
+
+    /// \brief Points, as columns: energy, then composition
+    const Eigen::MatrixXd &points() const {
+      return m_points;
+    }
+
+    /// \brief Index of the point with a particular name, or size() if not found
+    Index find(const std::string &name) const;
+
+    /// \brief Indices of the points that are hull vertices, in increasing order
+    const std::vector<Index> &vertices() const {
+      return m_vertices;
+    }
+
+    /// \brief True if point 'i' is a hull vertex
+    bool is_vertex(Index i) const;
+
+    /// \brief Distance to the hull of every point, in energy units
+    const Eigen::VectorXd &dist_to_hull() const {
+      return m_dist;
+    }
+
+    /// \brief Distance to the hull of point 'i', in energy units
+    double dist_to_hull(Index i) const {
+      return m_dist(i);
+    }
+
+    /// \brief Distance to the hull of any number of points, as columns of 'points'
+    ///
+    /// The distance is negative for points below the hull. Points outside the composition range
+    /// of the hull are compared with the extension of the hull facets.
+    Eigen::VectorXd dist_to_hull(const Eigen::MatrixXd &_points) const;
+
+    /// \brief Number of bottom facets
+    Index facets_size() const {
+      return m_plane.rows();
+    }
+
+    /// \brief True if the last update rebuilt the hull
+    bool rebuilt() const {
+      return m_rebuilt;
+    }
+
+    /// \brief Number of points the hull was last built from
+    Index rebuild_size() const {
+      return m_rebuild_size;
+    }
+
+    /// \brief True if the last update added, removed, or changed any points
+    bool changed() const {
+      return m_changed;
+    }
+
+    /// \brief The bottom of the hull as a BP::Geo, built from the hull vertices only
+    ///
+    /// \param index Set to the index of the point corresponding to each BP::Geo point
+    BP::Geo &geo(std::vector<Index> &index) const;
+
+    /// \brief Read a cache written with HullCache::write, return false if there is none
+    bool read(const fs::path &file);
+
+    /// \brief Write the cache, creating the parent directory if necessary
+    void write(const fs::path &file) const;
+
+    /// \brief Remove all but the 'max_size' most recently written '.json' files in 'dir'
+    ///
+    /// Used to bound the number of caches kept in DirectoryStructure::hull_cache_dir
+    static void prune(const fs::path &dir, Index max_size);
+
+    /// \brief Maximum number of caches kept in DirectoryStructure::hull_cache_dir
+    static const int max_cached = 20;
+
+    jsonParser &to_json(jsonParser &json) const;
+
+    void from_json(const jsonParser &json);
+
+  private:
+
+    /// \brief Build the hull from the points with indices 'subset', return false if not found
+    bool _build(const std::vector<Index> &subset);
+
+    /// \brief Energy of the extended hull facets at the composition of 'points', and the facet
+    ///        that gives it
+    void _hull_energy(const Eigen::MatrixXd &_points, Eigen::VectorXd &energy, std::vector<Index> &facet) const;
+
+    /// \brief True if the composition of 'point' is within the domain of 'facet'
+    bool _in_facet(const Eigen::VectorXd &point, Index facet) const;
+
+    void _clear();
+
+    double m_tol;
+
+    std::vector<std::string> m_names;
+    std::map<std::string, Index> m_index;
+    Eigen::MatrixXd m_points;
+    Eigen::VectorXd m_dist;
+    std::vector<Index> m_vertices;
+
+    // row f is (c, g) for facet f, so that its energy at x is m_plane.row(f)*(1, x)
+    Eigen::MatrixXd m_plane;
+
+    // rows [f*dim, (f+1)*dim) give the barycentric coordinates of x in facet f as
+    //   m_bary.block(f*dim, 0, dim, dim)*(1, x)
+    Eigen::MatrixXd m_bary;
+
+    // false if any facet is not a simplex, in which case every update rebuilds the hull
+    bool m_incremental;
+
+    bool m_rebuilt;
+    Index m_rebuild_size;
+    bool m_changed;
+
+    // BP::Geo of the hull vertices, built when requested
+    mutable std::shared_ptr<BP::Geo> m_geo;
+    mutable std::vector<Index> m_geo_index;
+
+  };
+
+  jsonParser &to_json(const HullCache &cache, jsonParser &json);
+
+  void from_json(HullCache &cache, const jsonParser &json);
+
+}
+
+#endif
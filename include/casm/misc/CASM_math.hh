@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <complex>
 #include <string>
+#include <vector>
 #include <sstream>
 
 namespace CASM {
@@ -195,6 +196,14 @@ namespace CASM {
 
   // *******************************************************************************************
 
+  /// \brief 64-bit FNV-1a hash of 'fields', as 16 hex digits
+  ///
+  /// Unlike std::hash, the result is the same for every platform, build and run, so it can be
+  /// used in file names. Fields are separated, so that {"ab", "c"} and {"a", "bc"} differ.
+  std::string stable_hash(const std::vector<std::string> &fields);
+
+  // *******************************************************************************************
+
   void poly_fit(Eigen::VectorXcd &xvec, Eigen::VectorXcd &yvec, Eigen::VectorXcd &coeffs, int degree); //Ivy
 
   // //////////////////////////////////////////
@@ -0,0 +1,95 @@
+#ifndef CASM_SparseAssignment
+#define CASM_SparseAssignment
+
+#include <utility>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Minimum cost assignment of rows to columns, for a sparse square cost matrix
+  ///
+  /// Solves the same problem as hungarian_method, but only for the (row, column) pairs that
+  /// have been given a cost; pairs without a cost can not be assigned. It uses shortest
+  /// augmenting paths, found with Dijkstra's algorithm on the non-zero costs (as in the
+  /// Jonker-Volgenant algorithm), so that the time and memory needed scale with the number of
+  /// costs rather than with the square of the dimension.
+  ///
+  /// The column duals ("prices") of a solution are kept by SparseAssignment::reset, and used as
+  /// the starting point of the next solution. For a sequence of similar problems, such as
+  /// mapping a structure at several trial translations, most rows are then assigned without
+  /// searching.
+  ///
+  /// The dual variables can be used to check that a solution is also optimal for a problem with
+  /// more costs: a pair (i, j) without a cost can not improve the solution if
+  /// row_dual()[i] + col_dual()[j] <= cost(i, j).
+  ///
+  class SparseAssignment {
+
+  public:
+
+    typedef std::vector<std::pair<Index, double> > row_type;
+
+    SparseAssignment() :
+      m_cost(0.0) {}
+
+    /// \brief Remove all costs, and set the dimension
+    ///
+    /// Column duals are kept if the dimension is unchanged.
+    void reset(Index _dim);
+
+    /// \brief Dimension of the cost matrix
+    Index dim() const {
+      return m_row.size();
+    }
+
+    /// \brief Set the cost of assigning column 'col' to row 'row', which must not already have a cost
+    void add(Index row, Index col, double cost) {
+      m_row[row].push_back(std::make_pair(col, cost));
+    }
+
+    /// \brief The (column, cost) pairs of row 'i'
+    const row_type &row(Index i) const {
+      return m_row[i];
+    }
+
+    /// \brief Find the minimum cost assignment, return false if no assignment is possible
+    bool solve();
+
+    /// \brief Column assigned to each row
+    const std::vector<Index> &assignment() const {
+      return m_col4row;
+    }
+
+    /// \brief Total cost of the assignment
+    double cost() const {
+      return m_cost;
+    }
+
+    const std::vector<double> &row_dual() const {
+      return m_u;
+    }
+
+    const std::vector<double> &col_dual() const {
+      return m_v;
+    }
+
+  private:
+
+    std::vector<row_type> m_row;
+
+    std::vector<Index> m_col4row;
+    std::vector<Index> m_row4col;
+
+    // dual variables, such that cost(i, j) - m_u[i] - m_v[j] >= 0, with equality for assigned pairs
+    std::vector<double> m_u;
+    std::vector<double> m_v;
+
+    double m_cost;
+
+  };
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 namespace CASM {
 
   class PrimGrid;
+  class PrimGridPermute;
 
   /// Permutation bidirectional Iterator class
   ///   Can iterate over all combined factor group and translation permutations for a Supercell
@@ -36,8 +37,9 @@ namespace CASM {
     /// m_prim_grid holds permutation representation of lattice translations acting on sites of the supercell
     PrimGrid const *m_prim_grid;
 
-    /// m_trans_permute points to the Array<Permutation> of translation permutations inside of m_prim_grid (to provide faster access)
-    Array<Permutation> const *m_trans_permute;
+    /// If not NULL, permutations are computed by m_grid_permute instead of being looked up in
+    /// m_fg_permute_rep and m_prim_grid, which then do not need to store them
+    PrimGridPermute const *m_grid_permute;
 
     Index m_factor_group_index;
     Index m_translation_index;
@@ -53,6 +55,11 @@ namespace CASM {
                     Index _factor_group_index,
                     Index _translation_index);
 
+    /// Iterate over the permutations of 'grid_permute', which are computed as needed
+    PermuteIterator(const PrimGridPermute &grid_permute,
+                    Index _factor_group_index,
+                    Index _translation_index);
+
     PermuteIterator &operator=(PermuteIterator iter);
 
     /// Returns the combination of factor_group permutation and translation permutation
@@ -69,11 +76,18 @@ namespace CASM {
     Index translation_index() const;
 
     /// Return the factor group permutation being pointed at
+    ///   If this iterates over a PrimGridPermute, it is constructed on first use
     const Permutation &factor_group_permute() const;
 
     /// Return the translation permutation being pointed at
+    ///   The PrimGrid constructs all translation permutations on first use
     const Permutation &translation_permute() const;
 
+    /// Return the PrimGridPermute this iterates over, or NULL if permutations are stored
+    PrimGridPermute const *grid_permute() const {
+      return m_grid_permute;
+    }
+
     /// gets the SymOp for the current operation, defined by translation_op[trans_index]*factor_group_op[fg_index]
     /// i.e, equivalent to application of the factor group operation, FOLLOWED BY application of the translation operation
     SymOp sym_op()const;
@@ -166,6 +166,10 @@ namespace CASM {
     SymGroupRepHandle():
       m_head_group(NULL), m_group_rep(NULL) {}
 
+    /// Handle for the operations of 'head_group' only, without a representation
+    explicit SymGroupRepHandle(const SymGroup &head_group) :
+      m_head_group(&head_group), m_group_rep(NULL) {}
+
     SymGroupRepHandle(const SymGroup &head_group, Index symrep_ID) :
       m_head_group(&head_group), m_group_rep(NULL) {
       assert(m_head_group->size() && valid_index(symrep_ID) && (*m_head_group)[0].has_valid_master());
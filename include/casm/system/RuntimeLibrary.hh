@@ -17,10 +17,17 @@ namespace CASM {
 
     /// \brief Construct a RuntimeLibrary object, with the options to be used for compile
     ///        the '.o' file and the '.so' file
+    ///
+    /// \param _interface_version Identifies the interface the library is compiled against, for example the
+    ///        version of a base class it implements. It is included in source_hash, so that libraries compiled
+    ///        against a different interface are stale even if their source code and options did not change.
+    ///
     RuntimeLibrary(std::string _compile_options = RuntimeLibrary::default_compile_options(),
-                   std::string _so_options = RuntimeLibrary::default_so_options()) :
+                   std::string _so_options = RuntimeLibrary::default_so_options(),
+                   std::string _interface_version = "") :
       m_compile_options(_compile_options),
       m_so_options(_so_options),
+      m_interface_version(_interface_version),
       m_filename_base(""),
       m_handle(nullptr) {}
 
@@ -54,21 +61,12 @@ namespace CASM {
     void compile(std::string _filename_base,
                  std::string _source) {
 
-      if(m_handle != nullptr) {
-        close();
-      }
-
-      m_filename_base = _filename_base;
-
       // write the source code
-      std::ofstream file(m_filename_base + ".cc");
+      std::ofstream file(_filename_base + ".cc");
       file << _source;
       file.close();
 
-      // compile the source code into a dynamic library
-      Popen p;
-      p.popen(m_compile_options + " -o " + m_filename_base + ".o" + " -c " + m_filename_base + ".cc");
-      p.popen(m_so_options + " -o " + m_filename_base + ".so" + " " + m_filename_base + ".o");
+      compile(_filename_base);
     }
 
     /// \brief Compile a shared library
@@ -82,18 +80,32 @@ namespace CASM {
     /// To enable runtime symbol lookup use C-style functions, i.e use extern "C" for functions you want to use
     /// via get_function.  This means no member functions or overloaded functions.
     ///
-    void compile(std::string _filename_base) {
-      if(m_handle != nullptr) {
-        close();
-      }
+    /// Source code that contains the line "#define CASM_NUM_TRANSLATION_UNITS N" is compiled N times, in
+    /// parallel, using "-DCASM_TRANSLATION_UNIT=i" for i in [0, N), into "/path/to/hello_i.o", which are
+    /// linked together. The source code should use CASM_TRANSLATION_UNIT to select which parts are compiled
+    /// each time, and compile everything if it is not defined.
+    ///
+    /// Writes a hash of the source code, options and interface version to "/path/to/hello.so.hash", see is_stale.
+    ///
+    void compile(std::string _filename_base);
 
-      m_filename_base = _filename_base;
+    /// \brief Compile a shared library, unless it is up to date
+    ///
+    /// \param _filename_base Base name for the source code file, as for compile
+    /// \param cache_dir If not empty, a directory where compiled libraries are kept, named by the hash of
+    ///        their source code, options and interface version, so that they can be reused instead of compiled again
+    ///
+    /// \returns true if the library was compiled or copied from 'cache_dir', false if it was up to date
+    ///
+    bool compile_if_stale(std::string _filename_base, std::string cache_dir = "");
 
-      // compile the source code into a dynamic library
-      Popen p;
-      p.popen(m_compile_options + " -o " + m_filename_base + ".o" + " -c " + m_filename_base + ".cc");
-      p.popen(m_so_options + " -o " + m_filename_base + ".so" + " " + m_filename_base + ".o");
-    }
+    /// \brief True if "/path/to/hello.so" does not exist, or was not compiled from the current "/path/to/hello.cc"
+    ///        with the current options and interface version
+    bool is_stale(std::string _filename_base) const;
+
+    /// \brief Hash of the source code file "/path/to/hello.cc", the compile and shared library options,
+    ///        and the interface version
+    std::string source_hash(std::string _filename_base) const;
 
 
     /// \brief Load a library with a given name
@@ -150,7 +162,8 @@ namespace CASM {
 
       // rm
       Popen p;
-      p.popen(std::string("rm -f ") + m_filename_base + ".cc " + m_filename_base + ".o " + m_filename_base + ".so");
+      p.popen(std::string("rm -f ") + m_filename_base + ".cc " + m_filename_base + ".o " + m_filename_base + ".so " +
+              m_filename_base + ".so.hash");
     }
 
     /// \brief Default compilation options
@@ -167,10 +180,14 @@ namespace CASM {
       return "g++ -shared";
     }
 
+    /// \brief Maximum number of libraries kept in the cache directory used by compile_if_stale
+    static const int max_cached_libraries = 10;
+
   private:
 
     std::string m_compile_options;
     std::string m_so_options;
+    std::string m_interface_version;
 
     std::string m_filename_base;
 
@@ -0,0 +1,257 @@
+#ifndef TaskScheduler_HH
+#define TaskScheduler_HH
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Work-stealing thread pool
+  ///
+  /// Each worker thread owns a deque of tasks. Workers push and pop tasks at the back of their
+  /// own deque and, when it is empty, steal from the front of the other workers' deques. Tasks
+  /// submitted from outside the pool are distributed round-robin. Because each deque has its own
+  /// lock, queuing many small tasks does not serialize on a single mutex.
+  ///
+  /// A worker that waits on work it spawned (wait, parallel_for, parallel_reduce) runs tasks from
+  /// its own deque in the meantime, so nested parallelism does not deadlock.
+  ///
+  /// Typical use is through the global scheduler:
+  /// \code
+  /// std::vector<double> result(N);
+  /// parallel_for(0, N, [&](Index begin, Index end) {
+  ///   for(Index i = begin; i < end; i++) {
+  ///     result[i] = f(i);
+  ///   }
+  /// });
+  /// \endcode
+  ///
+  class TaskScheduler {
+
+  public:
+
+    typedef std::function<void ()> Task;
+
+    /// \brief Construct a TaskScheduler with 'num_threads' worker threads
+    ///
+    /// If num_threads < 1, default_num_threads() is used.
+    explicit TaskScheduler(Index num_threads);
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /// \brief Finishes all queued tasks and joins the worker threads
+    ~TaskScheduler();
+
+    /// \brief Number of worker threads
+    Index size() const {
+      return m_worker.size();
+    }
+
+    /// \brief Queue 'f()' for execution and return a future for its result
+    ///
+    /// Exceptions thrown by 'f' are rethrown by std::future::get.
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> submit(F f) {
+      typedef typename std::result_of<F()>::type result_type;
+      auto task = std::make_shared<std::packaged_task<result_type ()> >(std::move(f));
+      std::future<result_type> result = task->get_future();
+      _push([task]() {
+        (*task)();
+      });
+      return result;
+    }
+
+    /// \brief Wait for 'fut' to be ready
+    ///
+    /// If called from a worker thread of this TaskScheduler, tasks from the worker's own deque are
+    /// run while waiting.
+    template<typename T>
+    void wait(const std::future<T> &fut) {
+      while(fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if(!_run_local_task(0)) {
+          fut.wait_for(std::chrono::microseconds(100));
+        }
+      }
+    }
+
+    /// \brief Call 'f(b, e)' for disjoint ranges [b, e) covering [begin, end), each at most 'grain' long
+    ///
+    /// The calling thread takes part in the work. Ranges are handed out as threads become free,
+    /// so the order in which they are processed is unspecified.
+    template<typename F>
+    void parallel_for(Index begin, Index end, F f, Index grain = 1) {
+      if(end <= begin) {
+        return;
+      }
+      grain = std::max(grain, Index(1));
+      Index N_chunk = (end - begin + grain - 1) / grain;
+
+      std::atomic<Index> next_chunk(0);
+      auto runner = [&]() {
+        Index c;
+        while((c = next_chunk++) < N_chunk) {
+          Index b = begin + c * grain;
+          f(b, std::min(b + grain, end));
+        }
+      };
+
+      Index N_runner = std::min(N_chunk, size() + 1) - 1;
+      Index mark = _local_mark();
+      std::vector<std::future<void> > helpers;
+      for(Index i = 0; i < N_runner; i++) {
+        helpers.push_back(submit(runner));
+      }
+
+      // run on this thread too, and make sure exceptions don't leave 'runner' dangling
+      std::exception_ptr error;
+      try {
+        runner();
+      }
+      catch(...) {
+        next_chunk = N_chunk;
+        error = std::current_exception();
+      }
+
+      for(auto &fut : helpers) {
+        while(fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+          if(!_run_local_task(mark)) {
+            fut.wait_for(std::chrono::microseconds(100));
+          }
+        }
+      }
+      for(auto &fut : helpers) {
+        try {
+          fut.get();
+        }
+        catch(...) {
+          if(!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+      if(error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    /// \brief Reduce 'f(b, e)' over ranges [b, e) covering [begin, end), each at most 'grain' long
+    ///
+    /// Returns combine(...combine(combine(init, f(r_0)), f(r_1))..., f(r_n)) for the ranges r_i in
+    /// order. Range boundaries depend only on 'grain', so the result does not depend on the number of
+    /// threads, even for floating point sums.
+    template<typename T, typename F, typename Combine>
+    T parallel_reduce(Index begin, Index end, T init, F f, Combine combine, Index grain = 1) {
+      if(end <= begin) {
+        return init;
+      }
+      grain = std::max(grain, Index(1));
+      Index N_chunk = (end - begin + grain - 1) / grain;
+
+      std::vector<std::unique_ptr<T> > partial(N_chunk);
+      parallel_for(0, N_chunk, [&](Index c_begin, Index c_end) {
+        for(Index c = c_begin; c < c_end; c++) {
+          Index b = begin + c * grain;
+          partial[c].reset(new T(f(b, std::min(b + grain, end))));
+        }
+      });
+
+      for(Index c = 0; c < N_chunk; c++) {
+        init = combine(init, *partial[c]);
+      }
+      return init;
+    }
+
+  private:
+
+    struct Worker {
+      std::mutex mutex;
+      /// tasks, with the sequence number they were pushed with
+      std::deque<std::pair<Index, Task> > deque;
+      Index next_seq = 0;
+    };
+
+    /// \brief Add a task to the current worker's deque, or round-robin if not called from a worker
+    void _push(Task task);
+
+    /// \brief Pop from the back of worker w's own deque
+    bool _pop(Index w, Task &task);
+
+    /// \brief Steal from the front of another worker's deque
+    bool _steal(Index w, Task &task);
+
+    /// \brief Worker thread main loop
+    void _run(Index w);
+
+    /// \brief Index of the calling thread in this TaskScheduler, or -1
+    Index _this_worker() const;
+
+    /// \brief Sequence number that the next task pushed by the calling worker will have, or 0
+    Index _local_mark();
+
+    /// \brief Run the task at the back of the calling worker's deque, if its sequence number is >= 'mark'
+    bool _run_local_task(Index mark);
+
+    std::vector<std::unique_ptr<Worker> > m_worker;
+    std::vector<std::thread> m_thread;
+
+    /// number of queued tasks, and of workers waiting for one
+    std::atomic<Index> m_pending;
+    std::atomic<Index> m_sleeping;
+
+    /// next worker to receive a task submitted from outside the pool
+    std::atomic<Index> m_next;
+
+    bool m_stop;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cond;
+
+  };
+
+  /// \brief Number of threads to use when not otherwise specified
+  ///
+  /// The value of the environment variable CASM_NUM_THREADS if it is set to a positive integer,
+  /// otherwise the number of hardware threads.
+  Index default_num_threads();
+
+  /// \brief Number of worker threads in the global TaskScheduler
+  Index num_threads();
+
+  /// \brief Set the number of worker threads in the global TaskScheduler
+  ///
+  /// If num_threads < 1, default_num_threads() is used. Must not be called while the global
+  /// TaskScheduler is in use.
+  void set_num_threads(Index num_threads);
+
+  /// \brief The global TaskScheduler, constructed on first use with num_threads() workers
+  TaskScheduler &global_scheduler();
+
+  /// \brief Call global_scheduler().parallel_for(begin, end, f, grain)
+  template<typename F>
+  void parallel_for(Index begin, Index end, F f, Index grain = 1) {
+    global_scheduler().parallel_for(begin, end, f, grain);
+  }
+
+  /// \brief Call global_scheduler().parallel_reduce(begin, end, init, f, combine, grain)
+  template<typename T, typename F, typename Combine>
+  T parallel_reduce(Index begin, Index end, T init, F f, Combine combine, Index grain = 1) {
+    return global_scheduler().parallel_reduce(begin, end, init, f, combine, grain);
+  }
+
+}
+
+#endif
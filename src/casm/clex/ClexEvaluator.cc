@@ -0,0 +1,111 @@
+#include "casm/clex/ClexEvaluator.hh"
+
+#include "casm/clex/ConfigDoF.hh"
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/Supercell.hh"
+
+namespace CASM {
+
+  bool has_folded_eci(const Clexulator &clexulator, const ECIContainer &eci) {
+
+    std::vector<ECIContainer::size_type> index;
+    std::vector<double> value;
+    for(Index i = 0; i < eci.eci_index_list().size(); i++) {
+      if(eci.eci_list()[i] != 0.0) {
+        index.push_back(eci.eci_index_list()[i]);
+        value.push_back(eci.eci_list()[i]);
+      }
+    }
+
+    return !index.empty() &&
+           clexulator.folded_eci_size() == index.size() &&
+           std::equal(index.begin(), index.end(), clexulator.folded_eci_index()) &&
+           std::equal(value.begin(), value.end(), clexulator.folded_eci_value());
+  }
+
+  //*********************************************************************************
+  ClexEvaluator::ClexEvaluator(const Clexulator &clexulator, const ECIContainer &eci) :
+    m_clexulator(clexulator),
+    m_eci(eci),
+    m_corr(clexulator.corr_size(), 0.0) {
+
+    for(Index i = 0; i < eci.eci_index_list().size(); i++) {
+      if(eci.eci_index_list()[i] >= clexulator.corr_size()) {
+        throw std::runtime_error("Error in ClexEvaluator: ECI index " + std::to_string(eci.eci_index_list()[i])
+                                 + " is out of range for Clexulator '" + clexulator.name() + "' with "
+                                 + std::to_string(clexulator.corr_size()) + " correlations");
+      }
+      if(eci.eci_list()[i] != 0.0) {
+        m_index.push_back(eci.eci_index_list()[i]);
+        m_value.push_back(eci.eci_list()[i]);
+      }
+    }
+
+    // use the fused kernel only if it was printed with exactly these ECI
+    m_fused = has_folded_eci(clexulator, eci);
+  }
+
+  //*********************************************************************************
+  double ClexEvaluator::operator()(const ConfigDoF &configdof, const Supercell &scel) {
+
+    Index scel_vol = scel.volume();
+    if(m_index.empty() || scel_vol == 0) {
+      return 0.0;
+    }
+
+    m_clexulator.set_config_occ(configdof.occupation().begin());
+
+    double result = 0.0;
+    for(Index v = 0; v < scel_vol; v++) {
+
+      //Point the Clexulator to the right neighborhood
+      m_clexulator.set_nlist(scel.get_nlist(v));
+
+      result += _unitcell_value();
+    }
+
+    // normalize by supercell volume
+    return result / double(scel_vol);
+  }
+
+  //*********************************************************************************
+  double ClexEvaluator::operator()(const Configuration &config) {
+    return (*this)(config.configdof(), config.get_supercell());
+  }
+
+  //*********************************************************************************
+  double ClexEvaluator::operator()(const int *occ_begin, const long int *nlist_begin, size_type N_unitcell) {
+
+    if(m_index.empty() || N_unitcell == 0) {
+      return 0.0;
+    }
+
+    m_clexulator.set_config_occ(occ_begin);
+
+    double result = 0.0;
+    for(size_type v = 0; v < N_unitcell; v++) {
+      m_clexulator.set_nlist(nlist_begin + v * m_clexulator.nlist_size());
+      result += _unitcell_value();
+    }
+
+    return result / double(N_unitcell);
+  }
+
+  //*********************************************************************************
+  double ClexEvaluator::_unitcell_value() {
+
+    if(m_fused) {
+      return m_clexulator.calc_global_energy_contribution();
+    }
+
+    //Fill up contributions of the non-zero ECI correlations only
+    m_clexulator.calc_restricted_global_corr_contribution(m_corr.data(), m_index.data(), m_index.data() + m_index.size());
+
+    double result = 0.0;
+    for(Index i = 0; i < m_index.size(); i++) {
+      result += m_value[i] * m_corr[m_index[i]];
+    }
+    return result;
+  }
+
+}
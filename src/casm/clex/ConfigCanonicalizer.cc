@@ -0,0 +1,247 @@
+#include "casm/clex/ConfigCanonicalizer.hh"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+#include "casm/system/TaskScheduler.hh"
+
+namespace CASM {
+
+  namespace {
+
+    /// Number of sites permuted at a time when comparing permuted occupations, small enough that
+    /// comparisons that end early don't waste much
+    const Index site_block_size = 64;
+
+  }
+
+  //*******************************************************************************
+
+  ConfigCanonicalizer::ConfigCanonicalizer(PermuteIterator it_begin, PermuteIterator it_end) :
+    m_begin(it_begin),
+    m_end(it_end),
+    m_N(0),
+    m_grid_permute(it_begin.grid_permute()) {
+
+    if(!m_grid_permute) {
+      throw std::runtime_error("Error in ConfigCanonicalizer: PermuteIterator does not iterate over a PrimGridPermute");
+    }
+    m_N = m_grid_permute->size();
+
+    std::map<Index, Index> first_site_slot;
+
+    for(; it_begin != it_end; ++it_begin) {
+      Index k = m_op.size();
+      m_op.push_back(it_begin);
+      m_op_fg.push_back(it_begin.factor_group_index());
+      m_op_trans.push_back(it_begin.translation_index());
+
+      if(m_N == 0) {
+        continue;
+      }
+
+      Index site = _permute_ind(k, 0);
+      auto site_it = first_site_slot.find(site);
+      if(site_it == first_site_slot.end()) {
+        site_it = first_site_slot.insert(std::make_pair(site, Index(m_first_site.size()))).first;
+        m_first_site.push_back(site);
+        m_first_site_ops.push_back(std::vector<Index>());
+      }
+      m_first_site_ops[site_it->second].push_back(k);
+    }
+  }
+
+  //*******************************************************************************
+
+  bool ConfigCanonicalizer::is_canonical(const ConfigDoF &dof, double tol) const {
+    return _is_canonical(dof, NULL, tol);
+  }
+
+  //*******************************************************************************
+
+  bool ConfigCanonicalizer::is_canonical(const ConfigDoF &dof, Array<PermuteIterator> &factor_group, double tol) const {
+    return _is_canonical(dof, &factor_group, tol);
+  }
+
+  //*******************************************************************************
+
+  std::vector<bool> ConfigCanonicalizer::is_canonical(const std::vector<const ConfigDoF *> &dof, TaskScheduler &scheduler, double tol) const {
+
+    // std::vector<bool> packs bits, so it can't be written from several threads
+    std::vector<char> canonical(dof.size());
+    scheduler.parallel_for(0, dof.size(), [&](Index begin, Index end) {
+      for(Index i = begin; i < end; i++) {
+        canonical[i] = _is_canonical(*dof[i], NULL, tol);
+      }
+    }, 64);
+
+    return std::vector<bool>(canonical.begin(), canonical.end());
+  }
+
+  //*******************************************************************************
+
+  bool ConfigCanonicalizer::is_primitive(const ConfigDoF &dof, double tol) const {
+
+    if(!_occupation_only(dof) || m_op.empty()) {
+      return dof.is_primitive(m_begin, tol);
+    }
+
+    const Array<int> &occ = dof.occupation();
+
+    // as in ConfigDoF::is_primitive, check the non-zero translations combined with the first
+    // factor group operation, which are the operations after the first with the same m_op_fg
+    for(Index k = 1; k < m_op.size() && m_op_fg[k] == m_op_fg[0]; k++) {
+      if(_compare(k, occ.begin(), occ.begin(), 0) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //*******************************************************************************
+
+  ConfigDoF ConfigCanonicalizer::canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon, double tol) const {
+    return _canonical_form(dof, it_canon, NULL, tol);
+  }
+
+  //*******************************************************************************
+
+  ConfigDoF ConfigCanonicalizer::canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon,
+                                                Array<PermuteIterator> &factor_group, double tol) const {
+    return _canonical_form(dof, it_canon, &factor_group, tol);
+  }
+
+  //*******************************************************************************
+
+  bool ConfigCanonicalizer::_occupation_only(const ConfigDoF &dof) const {
+    return m_N != 0 && !m_op.empty() && dof.size() == m_N && dof.occupation().size() == m_N &&
+           !dof.is_strained() && !dof.displacement().cols();
+  }
+
+  //*******************************************************************************
+
+  bool ConfigCanonicalizer::_is_canonical(const ConfigDoF &dof, Array<PermuteIterator> *fg_ptr, double tol) const {
+
+    if(!_occupation_only(dof)) {
+      return fg_ptr ? dof.is_canonical(m_begin, m_end, *fg_ptr, tol) : dof.is_canonical(m_begin, m_end, tol);
+    }
+
+    if(fg_ptr)
+      fg_ptr->clear();
+
+    const Array<int> &occ = dof.occupation();
+
+    // any operation that brings a larger occupant to site 0 gives a larger configuration
+    for(Index j = 0; j < m_first_site.size(); j++) {
+      if(occ[m_first_site[j]] > occ[0]) {
+        return false;
+      }
+    }
+
+    std::vector<Index> fg;
+    for(Index j = 0; j < m_first_site.size(); j++) {
+      if(occ[m_first_site[j]] < occ[0]) {
+        continue;
+      }
+
+      for(Index k : m_first_site_ops[j]) {
+        int compare = _compare(k, occ.begin(), occ.begin(), 1);
+        if(compare > 0) {
+          return false;
+        }
+        else if(compare == 0 && fg_ptr) {
+          fg.push_back(k);
+        }
+      }
+    }
+
+    if(fg_ptr) {
+      std::sort(fg.begin(), fg.end());
+      for(Index k : fg) {
+        fg_ptr->push_back(m_op[k]);
+      }
+    }
+    return true;
+  }
+
+  //*******************************************************************************
+
+  ConfigDoF ConfigCanonicalizer::_canonical_form(const ConfigDoF &dof, PermuteIterator &it_canon,
+                                                 Array<PermuteIterator> *fg_ptr, double tol) const {
+
+    if(!_occupation_only(dof) || m_op.empty()) {
+      return fg_ptr ? dof.canonical_form(m_begin, m_end, it_canon, *fg_ptr, tol) : dof.canonical_form(m_begin, m_end, it_canon, tol);
+    }
+
+    if(fg_ptr)
+      fg_ptr->clear();
+
+    const Array<int> &occ = dof.occupation();
+
+    // only operations that bring the largest occupant to site 0 are candidates
+    int max_first = occ[m_first_site[0]];
+    for(Index j = 1; j < m_first_site.size(); j++) {
+      max_first = std::max(max_first, occ[m_first_site[j]]);
+    }
+
+    // operations giving the largest configuration found so far, and that configuration
+    std::vector<Index> best;
+    std::vector<int> best_occ(m_N);
+    for(Index j = 0; j < m_first_site.size(); j++) {
+      if(occ[m_first_site[j]] != max_first) {
+        continue;
+      }
+
+      for(Index k : m_first_site_ops[j]) {
+        if(best.empty()) {
+          best.push_back(k);
+          m_grid_permute->permute(m_op_fg[k], m_op_trans[k], occ.begin(), best_occ.data());
+          continue;
+        }
+
+        int compare = _compare(k, occ.begin(), best_occ.data(), 1);
+
+        if(compare > 0) {
+          best.clear();
+          best.push_back(k);
+          m_grid_permute->permute(m_op_fg[k], m_op_trans[k], occ.begin(), best_occ.data());
+        }
+        else if(compare == 0) {
+          best.push_back(k);
+        }
+      }
+    }
+
+    // as in ConfigDoF::canonical_form, 'it_canon' is the first operation giving the canonical form
+    std::sort(best.begin(), best.end());
+    it_canon = m_op[best[0]];
+
+    if(fg_ptr) {
+      PermuteIterator it_inverse = it_canon.inverse();
+      for(Index k : best) {
+        fg_ptr->push_back(it_inverse * m_op[k]);
+      }
+    }
+
+    return it_canon * dof;
+  }
+
+  //*******************************************************************************
+
+  int ConfigCanonicalizer::_compare(Index k, const int *occ, const int *ref, Index begin) const {
+    Index permute_ind[site_block_size];
+    for(Index block_begin = begin; block_begin < m_N; block_begin += site_block_size) {
+      Index block_end = std::min(block_begin + site_block_size, m_N);
+      m_grid_permute->permute_ind_block(m_op_fg[k], m_op_trans[k], block_begin, block_end, permute_ind);
+      for(Index i = block_begin; i < block_end; i++) {
+        int permuted = occ[permute_ind[i - block_begin]];
+        if(permuted != ref[i]) {
+          return (permuted > ref[i]) ? 1 : -1;
+        }
+      }
+    }
+    return 0;
+  }
+
+}
@@ -0,0 +1,699 @@
+#include "casm/clex/ConfigDatabase.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "casm/casm_io/SafeOfstream.hh"
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/Supercell.hh"
+
+namespace CASM {
+
+  namespace {
+
+    const char db_magic[] = "CASMCFG1";
+    const Index db_magic_size = 8;
+
+    /// compact the journal once it is larger than the base file and this
+    const Index min_compact_size = 1 << 20;
+
+    void _write_uint(std::ostream &sout, Index value) {
+      std::uint64_t v = value;
+      sout.write(reinterpret_cast<const char *>(&v), sizeof(v));
+    }
+
+    void _write_string(std::ostream &sout, const std::string &value) {
+      _write_uint(sout, value.size());
+      sout.write(value.data(), value.size());
+    }
+
+    /// i-th value of an array of uint64 that may not be aligned
+    Index _get_uint(const char *array, Index i) {
+      std::uint64_t v;
+      std::memcpy(&v, array + i * sizeof(v), sizeof(v));
+      return v;
+    }
+
+    /// Reads values written by _write_uint and _write_string, throwing if they run past the end
+    class Reader {
+
+    public:
+
+      Reader(const char *_begin, const char *_end, const fs::path &_path) :
+        m_ptr(_begin), m_end(_end), m_path(_path) {}
+
+      const char *bytes(Index n) {
+        if(n < 0 || m_end - m_ptr < n) {
+          throw std::runtime_error(
+            std::string("Error in ConfigDatabase: unexpected end of file in ") + m_path.string());
+        }
+        const char *result = m_ptr;
+        m_ptr += n;
+        return result;
+      }
+
+      Index uint() {
+        return _get_uint(bytes(sizeof(std::uint64_t)), 0);
+      }
+
+      std::string string() {
+        Index n = uint();
+        return std::string(bytes(n), n);
+      }
+
+      Index remaining() const {
+        return m_end - m_ptr;
+      }
+
+    private:
+
+      const char *m_ptr;
+      const char *m_end;
+      fs::path m_path;
+    };
+
+    std::string _to_string(const jsonParser &json) {
+      return json_spirit::write_string((const json_spirit::mValue &) json, 0, 12);
+    }
+
+    std::shared_ptr<jsonParser> _parse(const char *data, Index size) {
+      std::shared_ptr<jsonParser> json = std::make_shared<jsonParser>();
+      std::istringstream ss(std::string(data, size));
+      if(!json->read(ss)) {
+        throw std::runtime_error("Error in ConfigDatabase: could not parse stored configuration data");
+      }
+      return json;
+    }
+
+    /// Exclusive lock on 'path', created if it does not exist, held until destruction
+    class FileLock {
+
+    public:
+
+      explicit FileLock(const fs::path &path) :
+        m_fd(::open(path.string().c_str(), O_RDWR | O_CREAT, 0644)) {
+        if(m_fd < 0 || ::flock(m_fd, LOCK_EX) != 0) {
+          if(m_fd >= 0) {
+            ::close(m_fd);
+          }
+          throw std::runtime_error(std::string("Error in ConfigDatabase: could not lock ") + path.string());
+        }
+      }
+
+      FileLock(const FileLock &) = delete;
+      FileLock &operator=(const FileLock &) = delete;
+
+      ~FileLock() {
+        ::flock(m_fd, LOCK_UN);
+        ::close(m_fd);
+      }
+
+    private:
+
+      int m_fd;
+    };
+
+    std::string _occupation_bytes(const Array<int> &occ) {
+      std::string result(occ.size(), 0);
+      for(Index i = 0; i < occ.size(); i++) {
+        if(occ[i] < 0 || occ[i] > 255) {
+          std::stringstream ss;
+          ss << "Error in ConfigDatabase: occupant index " << occ[i] << " can not be stored in one byte";
+          throw std::runtime_error(ss.str());
+        }
+        result[i] = static_cast<char>(static_cast<unsigned char>(occ[i]));
+      }
+      return result;
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  ConfigDatabase::ConfigDatabase(const fs::path &db_path, const fs::path &journal_path) :
+    m_db_path(db_path),
+    m_journal_path(journal_path),
+    m_map(nullptr),
+    m_map_size(0),
+    m_journal_size(0) {
+    if(fs::exists(m_journal_path)) {
+      // do not read a journal record that another process is still appending
+      FileLock lock(_lock_path());
+      _open();
+    }
+    else {
+      _open();
+    }
+  }
+
+  //*******************************************************************************************
+
+  ConfigDatabase::~ConfigDatabase() {
+    _close();
+  }
+
+  //*******************************************************************************************
+
+  Index ConfigDatabase::size(const std::string &scelname) const {
+    auto it = m_scel.find(scelname);
+    return (it == m_scel.end()) ? 0 : it->second.size();
+  }
+
+  //*******************************************************************************************
+
+  Configuration ConfigDatabase::configuration(Supercell &scel, Index id) const {
+    const SupercellRecords &records = _find(scel.get_name());
+    if(id < 0 || id >= records.size()) {
+      std::stringstream ss;
+      ss << "Error in ConfigDatabase::configuration: no configuration " << scel.get_name() << "/" << id;
+      throw std::runtime_error(ss.str());
+    }
+
+    const char *occ_bytes;
+    bool selected;
+    auto it = records.journal.find(id);
+    if(it != records.journal.end()) {
+      occ_bytes = it->second.occupation.data();
+      selected = it->second.selected;
+    }
+    else {
+      occ_bytes = records.occupation + id * records.num_sites;
+      selected = records.selected[id] != 0;
+    }
+
+    Array<int> occupation(records.num_sites);
+    for(Index i = 0; i < records.num_sites; i++) {
+      occupation[i] = static_cast<unsigned char>(occ_bytes[i]);
+    }
+
+    return Configuration(_parsed(records, id), occupation, selected, scel, id);
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::insert(const Configuration &config) {
+
+    const Supercell &scel = config.get_supercell();
+    std::string scelname = scel.get_name();
+
+    Index id;
+    std::istringstream ss(config.get_id());
+    if(!(ss >> id)) {
+      throw std::runtime_error(
+        std::string("Error in ConfigDatabase::insert: invalid configuration id '") + config.get_id() + "'");
+    }
+
+    std::string occupation = _occupation_bytes(config.occupation());
+
+    auto it = m_scel.find(scelname);
+    bool stored = (it != m_scel.end() && id < it->second.size());
+
+    // skip unchanged configurations without formatting their data
+    if(stored && !config.data_updated() && !config.dof_changed()) {
+      const SupercellRecords &records = it->second;
+      auto j_it = records.journal.find(id);
+      if(j_it != records.journal.end()) {
+        if(j_it->second.occupation == occupation && j_it->second.selected == config.selected()) {
+          return;
+        }
+      }
+      else if(occupation.size() == records.num_sites &&
+              std::equal(occupation.begin(), occupation.end(), records.occupation + id * records.num_sites) &&
+              (records.selected[id] != 0) == config.selected()) {
+        return;
+      }
+    }
+
+    // merge with the stored data, same as writing to config_list.json
+    jsonParser json;
+    jsonParser &json_config = json["supercells"][scelname][config.get_id()];
+    if(stored) {
+      json_config = _parsed(it->second, id);
+
+      // Configuration::write keeps existing DoF, so drop them if they changed
+      if(config.dof_changed()) {
+        json_config.erase("dof");
+      }
+    }
+    config.write(json);
+
+    json_config.erase("selected");
+    json_config["dof"].erase("occupation");
+
+    _insert(scelname, scel.num_sites(), id, occupation, config.selected(), _to_string(json_config));
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::insert(const jsonParser &json) {
+
+    if(!json.contains("supercells")) {
+      return;
+    }
+
+    for(auto scel_it = json["supercells"].cbegin(); scel_it != json["supercells"].cend(); ++scel_it) {
+      std::string scelname = scel_it.name();
+
+      // configurations are numbered sequentially, so read until not found
+      for(Index id = 0; ; id++) {
+        std::stringstream ss;
+        ss << id;
+        if(!scel_it->contains(ss.str())) {
+          break;
+        }
+
+        jsonParser json_config = (*scel_it)[ss.str()];
+        if(!json_config.contains("dof")) {
+          throw std::runtime_error(
+            std::string("Error in ConfigDatabase::insert: no 'dof' for configuration ") + scelname + "/" + ss.str());
+        }
+
+        Array<int> occ;
+        json_config["dof"].get_if(occ, "occupation");
+        bool selected;
+        json_config.get_else(selected, "selected", false);
+
+        json_config.erase("selected");
+        json_config["dof"].erase("occupation");
+
+        _insert(scelname, occ.size(), id, _occupation_bytes(occ), selected, _to_string(json_config));
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::commit() {
+
+    if(!fs::exists(m_db_path)) {
+      compact();
+      return;
+    }
+
+    if(m_pending.empty()) {
+      return;
+    }
+
+    {
+      FileLock lock(_lock_path());
+      fs::ofstream file(m_journal_path, std::ios::binary | std::ios::app);
+      file.write(m_pending.data(), m_pending.size());
+      file.close();
+      if(file.fail()) {
+        throw std::runtime_error(std::string("Error in ConfigDatabase::commit: could not write ") + m_journal_path.string());
+      }
+    }
+
+    m_journal_size += m_pending.size();
+    m_pending.clear();
+
+    if(m_journal_size > std::max(m_map_size, min_compact_size)) {
+      compact();
+    }
+  }
+
+  //*******************************************************************************************
+  /// Base file layout, with all integers stored as uint64:
+  ///
+  /// \code
+  /// "CASMCFG1", directory offset
+  /// for each supercell:
+  ///   occupation [configuration][site] (uint8), selected [configuration] (uint8),
+  ///   blob id [configuration], blob offset [blob + 1], blob data
+  /// directory:
+  ///   number of supercells
+  ///   for each supercell:
+  ///     name length, name, number of sites, number of configurations,
+  ///     occupation offset, selected offset, blob id offset, number of blobs, blob offset offset,
+  ///     blob data offset
+  /// \endcode
+  void ConfigDatabase::compact() {
+
+    struct Section {
+      std::string name;
+      Index num_sites, size, occupation, selected, blob_id, blob_count, blob_offset, blob_data;
+    };
+    std::vector<Section> directory;
+
+    FileLock lock(_lock_path());
+    SafeOfstream file;
+    file.open(m_db_path);
+    std::ostream &sout = file.ofstream();
+
+    sout.write(db_magic, db_magic_size);
+    _write_uint(sout, 0);
+
+    std::string occupation, data;
+    bool selected;
+    for(const auto &value : m_scel) {
+      const SupercellRecords &records = value.second;
+
+      Section section;
+      section.name = value.first;
+      section.num_sites = records.num_sites;
+      section.size = records.size();
+
+      std::string selected_bytes;
+      std::vector<Index> blob_id;
+      std::unordered_map<std::string, Index> blob_index;
+      std::vector<const std::string *> blob;
+
+      section.occupation = sout.tellp();
+      for(Index id = 0; id < section.size; id++) {
+        _record(records, id, occupation, selected, data);
+        sout.write(occupation.data(), occupation.size());
+        selected_bytes.push_back(selected ? 1 : 0);
+
+        auto result = blob_index.insert(std::make_pair(data, Index(blob.size())));
+        if(result.second) {
+          blob.push_back(&result.first->first);
+        }
+        blob_id.push_back(result.first->second);
+      }
+
+      section.selected = sout.tellp();
+      sout.write(selected_bytes.data(), selected_bytes.size());
+
+      section.blob_id = sout.tellp();
+      for(Index i = 0; i < blob_id.size(); i++) {
+        _write_uint(sout, blob_id[i]);
+      }
+
+      section.blob_count = blob.size();
+      section.blob_offset = sout.tellp();
+      Index offset = 0;
+      _write_uint(sout, offset);
+      for(Index b = 0; b < blob.size(); b++) {
+        offset += blob[b]->size();
+        _write_uint(sout, offset);
+      }
+
+      section.blob_data = sout.tellp();
+      for(Index b = 0; b < blob.size(); b++) {
+        sout.write(blob[b]->data(), blob[b]->size());
+      }
+
+      directory.push_back(section);
+    }
+
+    Index directory_offset = sout.tellp();
+    _write_uint(sout, directory.size());
+    for(const auto &section : directory) {
+      _write_string(sout, section.name);
+      _write_uint(sout, section.num_sites);
+      _write_uint(sout, section.size);
+      _write_uint(sout, section.occupation);
+      _write_uint(sout, section.selected);
+      _write_uint(sout, section.blob_id);
+      _write_uint(sout, section.blob_count);
+      _write_uint(sout, section.blob_offset);
+      _write_uint(sout, section.blob_data);
+    }
+
+    sout.seekp(db_magic_size);
+    _write_uint(sout, directory_offset);
+
+    if(sout.fail()) {
+      throw std::runtime_error(std::string("Error in ConfigDatabase::compact: could not write ") + m_db_path.string());
+    }
+    file.close();
+
+    fs::remove(m_journal_path);
+    m_pending.clear();
+
+    _close();
+    _open();
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_open() {
+
+    if(fs::exists(m_db_path)) {
+      int fd = ::open(m_db_path.string().c_str(), O_RDONLY);
+      if(fd < 0) {
+        throw std::runtime_error(std::string("Error in ConfigDatabase: could not open ") + m_db_path.string());
+      }
+
+      struct stat st;
+      if(::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error(std::string("Error in ConfigDatabase: could not stat ") + m_db_path.string());
+      }
+      m_map_size = st.st_size;
+
+      if(m_map_size > 0) {
+        void *ptr = ::mmap(nullptr, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(ptr == MAP_FAILED) {
+          ::close(fd);
+          throw std::runtime_error(std::string("Error in ConfigDatabase: could not map ") + m_db_path.string());
+        }
+        m_map = static_cast<const char *>(ptr);
+      }
+      ::close(fd);
+
+      _read_base();
+    }
+
+    if(fs::exists(m_journal_path)) {
+      _read_journal();
+    }
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_close() {
+    if(m_map) {
+      ::munmap(const_cast<char *>(m_map), m_map_size);
+    }
+    m_map = nullptr;
+    m_map_size = 0;
+    m_journal_size = 0;
+    m_scel.clear();
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_read_base() {
+
+    auto error = [&]() {
+      return std::runtime_error(std::string("Error in ConfigDatabase: invalid file ") + m_db_path.string());
+    };
+
+    // pointer to a section of the mapped file, checking bounds
+    auto section = [&](Index offset, Index count, Index elem_size) {
+      if(offset < 0 || count < 0 || offset > m_map_size || count > (m_map_size - offset) / elem_size) {
+        throw error();
+      }
+      return m_map + offset;
+    };
+
+    Reader header(m_map, m_map + m_map_size, m_db_path);
+    if(std::string(header.bytes(db_magic_size), db_magic_size) != db_magic) {
+      throw error();
+    }
+    Index directory_offset = header.uint();
+
+    Reader dir(section(directory_offset, 0, 1), m_map + m_map_size, m_db_path);
+    Index N_scel = dir.uint();
+    for(Index s = 0; s < N_scel; s++) {
+      SupercellRecords &records = m_scel[dir.string()];
+      records.num_sites = dir.uint();
+      records.base_size = dir.uint();
+      if(records.num_sites < 0 || records.base_size < 0 ||
+         (records.num_sites && records.base_size > m_map_size / records.num_sites)) {
+        throw error();
+      }
+
+      records.occupation = section(dir.uint(), records.base_size * records.num_sites, 1);
+      records.selected = section(dir.uint(), records.base_size, 1);
+      records.blob_id = section(dir.uint(), records.base_size, sizeof(std::uint64_t));
+      records.blob_count = dir.uint();
+      records.blob_offset = section(dir.uint(), records.blob_count + 1, sizeof(std::uint64_t));
+
+      Index blob_data_offset = dir.uint();
+      for(Index b = 0; b < records.blob_count; b++) {
+        if(_get_uint(records.blob_offset, b) > _get_uint(records.blob_offset, b + 1)) {
+          throw error();
+        }
+      }
+      records.blob_data = section(blob_data_offset, _get_uint(records.blob_offset, records.blob_count), 1);
+
+      for(Index id = 0; id < records.base_size; id++) {
+        Index b = _get_uint(records.blob_id, id);
+        if(b < 0 || b >= records.blob_count) {
+          throw error();
+        }
+      }
+      records.parsed_blob.resize(records.blob_count);
+    }
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_read_journal() {
+
+    std::string contents;
+    {
+      fs::ifstream file(m_journal_path, std::ios::binary);
+      std::stringstream ss;
+      ss << file.rdbuf();
+      contents = ss.str();
+    }
+
+    Reader reader(contents.data(), contents.data() + contents.size(), m_journal_path);
+    Index valid_size = 0;
+    while(reader.remaining() > 0) {
+
+      // an incomplete record at the end is left by an interrupted commit
+      if(reader.remaining() < sizeof(std::uint64_t)) {
+        break;
+      }
+      Index record_size = reader.uint();
+      if(record_size < 0 || reader.remaining() < record_size) {
+        break;
+      }
+
+      const char *begin = reader.bytes(record_size);
+      Reader record(begin, begin + record_size, m_journal_path);
+
+      std::string scelname = record.string();
+      Index id = record.uint();
+      JournalRecord value;
+      value.occupation = record.string();
+      value.selected = (*record.bytes(1) != 0);
+      value.data = record.string();
+
+      SupercellRecords &records = m_scel[scelname];
+      if(records.size() == 0) {
+        records.num_sites = value.occupation.size();
+      }
+      if(value.occupation.size() != records.num_sites || id < 0 || id > records.size()) {
+        throw std::runtime_error(std::string("Error in ConfigDatabase: invalid file ") + m_journal_path.string());
+      }
+      records.journal[id] = value;
+
+      valid_size += sizeof(std::uint64_t) + record_size;
+    }
+
+    if(valid_size != contents.size()) {
+      std::cerr << "WARNING: Ignoring incomplete record at the end of " << m_journal_path << std::endl;
+      fs::resize_file(m_journal_path, valid_size);
+    }
+    m_journal_size = valid_size;
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_insert(const std::string &scelname, Index num_sites, Index id,
+                               const std::string &occupation, bool selected, const std::string &data) {
+
+    SupercellRecords &records = m_scel[scelname];
+    if(records.size() == 0) {
+      records.num_sites = num_sites;
+    }
+
+    if(occupation.size() != records.num_sites) {
+      std::stringstream ss;
+      ss << "Error in ConfigDatabase::insert: configuration " << scelname << "/" << id << " has "
+         << occupation.size() << " occupants, expected " << records.num_sites;
+      throw std::runtime_error(ss.str());
+    }
+
+    if(id < 0 || id > records.size()) {
+      std::stringstream ss;
+      ss << "Error in ConfigDatabase::insert: configuration " << scelname << "/" << id
+         << " can not be added after configuration " << records.size() - 1;
+      throw std::runtime_error(ss.str());
+    }
+
+    if(id < records.size()) {
+      std::string stored_occupation, stored_data;
+      bool stored_selected;
+      _record(records, id, stored_occupation, stored_selected, stored_data);
+      if(stored_occupation == occupation && stored_selected == selected && stored_data == data) {
+        return;
+      }
+    }
+
+    JournalRecord &value = records.journal[id];
+    value.occupation = occupation;
+    value.selected = selected;
+    value.data = data;
+    value.parsed.reset();
+
+    std::stringstream ss;
+    _write_string(ss, scelname);
+    _write_uint(ss, id);
+    _write_string(ss, occupation);
+    ss.put(selected ? 1 : 0);
+    _write_string(ss, data);
+
+    std::string record = ss.str();
+    std::stringstream header;
+    _write_uint(header, record.size());
+    m_pending += header.str();
+    m_pending += record;
+  }
+
+  //*******************************************************************************************
+
+  void ConfigDatabase::_record(const SupercellRecords &records, Index id,
+                               std::string &occupation, bool &selected, std::string &data) const {
+
+    auto it = records.journal.find(id);
+    if(it != records.journal.end()) {
+      occupation = it->second.occupation;
+      selected = it->second.selected;
+      data = it->second.data;
+      return;
+    }
+
+    occupation.assign(records.occupation + id * records.num_sites, records.num_sites);
+    selected = (records.selected[id] != 0);
+    Index b = _get_uint(records.blob_id, id);
+    Index begin = _get_uint(records.blob_offset, b);
+    data.assign(records.blob_data + begin, _get_uint(records.blob_offset, b + 1) - begin);
+  }
+
+  //*******************************************************************************************
+
+  const jsonParser &ConfigDatabase::_parsed(const SupercellRecords &records, Index id) const {
+
+    auto it = records.journal.find(id);
+    if(it != records.journal.end()) {
+      const JournalRecord &value = it->second;
+      if(!value.parsed) {
+        value.parsed = _parse(value.data.data(), value.data.size());
+      }
+      return *value.parsed;
+    }
+
+    Index b = _get_uint(records.blob_id, id);
+    if(!records.parsed_blob[b]) {
+      Index begin = _get_uint(records.blob_offset, b);
+      records.parsed_blob[b] = _parse(records.blob_data + begin, _get_uint(records.blob_offset, b + 1) - begin);
+    }
+    return *records.parsed_blob[b];
+  }
+
+  //*******************************************************************************************
+
+  const ConfigDatabase::SupercellRecords &ConfigDatabase::_find(const std::string &scelname) const {
+    auto it = m_scel.find(scelname);
+    if(it == m_scel.end()) {
+      throw std::runtime_error(std::string("Error in ConfigDatabase: no configurations for supercell ") + scelname);
+    }
+    return it->second;
+  }
+
+}
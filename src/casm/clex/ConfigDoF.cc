@@ -4,6 +4,9 @@
 #include "casm/clex/Correlation.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/Supercell.hh"
+#include "casm/system/TaskScheduler.hh"
+
+#include <boost/functional/hash.hpp>
 
 
 namespace CASM {
@@ -696,6 +699,12 @@ namespace CASM {
     A.swap(B);
   }
 
+  //*******************************************************************************
+
+  std::size_t hash_value(const ConfigDoF &configdof) {
+    return boost::hash_range(configdof.occupation().begin(), configdof.occupation().end());
+  }
+
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
   Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator) {
 
@@ -718,7 +727,7 @@ namespace CASM {
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
+      clexulator.set_nlist(scel.get_nlist(v));
 
       //Fill up contributions
       clexulator.calc_global_corr_contribution(&tcorr[0]);
@@ -738,6 +747,124 @@ namespace CASM {
     return correlations;
   }
 
+  //*******************************************************************************
+
+  /// \brief Returns correlations for each of 'configdof_list', which must all be configurations of 'scel'
+  ///
+  /// Occupations are copied into a structure-of-arrays block, so that the Clexulator batch kernel can loop
+  /// over configurations innermost.
+  std::vector<Correlation> correlations(const std::vector<const ConfigDoF *> &configdof_list,
+                                        const Supercell &scel,
+                                        Clexulator &clexulator,
+                                        Index batch_size) {
+
+    Index scel_vol = scel.volume();
+    Index N_site = scel.num_sites();
+    Index corr_size = clexulator.corr_size();
+    Index nlist_size = clexulator.nlist_size();
+
+    // row-major scel_vol x nlist_size neighbor list table, copied only if the Clexulator uses a
+    // smaller neighborhood than the Supercell
+    const long int *nlist_begin = scel.nlist_table();
+    std::vector<long int> nlist;
+    if(nlist_size != scel.nlist_size()) {
+      nlist.resize(scel_vol * nlist_size);
+      for(Index v = 0; v < scel_vol; v++) {
+        std::copy(scel.get_nlist(v), scel.get_nlist(v) + nlist_size, nlist.begin() + v * nlist_size);
+      }
+      nlist_begin = nlist.data();
+    }
+
+    std::vector<Correlation> result;
+    result.reserve(configdof_list.size());
+
+    std::vector<int> occ(N_site * batch_size);
+    std::vector<double> corr(batch_size * corr_size);
+
+    for(Index begin = 0; begin < configdof_list.size(); begin += batch_size) {
+      Index N_config = std::min(batch_size, Index(configdof_list.size()) - begin);
+
+      // occ[l*N_config + k] is the occupant of site 'l' in configuration 'k'
+      for(Index k = 0; k < N_config; k++) {
+        const Array<int> &config_occ = configdof_list[begin + k]->occupation();
+        for(Index l = 0; l < N_site; l++) {
+          occ[l * N_config + k] = config_occ[l];
+        }
+      }
+
+      clexulator.calc_global_corr_batch(occ.data(), N_config, N_site, nlist_begin, scel_vol, corr.data());
+
+      for(Index k = 0; k < N_config; k++) {
+        result.push_back(Correlation(corr_size));
+        std::copy(corr.begin() + k * corr_size, corr.begin() + (k + 1) * corr_size, result.back().begin());
+      }
+    }
+
+    return result;
+  }
+
+  //*******************************************************************************
+
+  namespace {
+
+    /// Unit cells are summed in blocks of this size, so that multi-threaded results do not depend on the number of threads
+    const Index corr_block_size = 32;
+
+    /// Add contributions to global correlations from unit cells [v_begin, v_end) to 'corr_begin'
+    void _accumulate_correlations(const ConfigDoF &configdof,
+                                  const Supercell &scel,
+                                  Clexulator &clexulator,
+                                  Index v_begin,
+                                  Index v_end,
+                                  double *corr_begin) {
+
+      clexulator.set_config_occ(configdof.occupation().begin());
+
+      std::vector<double> tcorr(clexulator.corr_size(), 0.0);
+
+      for(Index v = v_begin; v < v_end; v++) {
+        clexulator.set_nlist(scel.get_nlist(v));
+        clexulator.calc_global_corr_contribution(&tcorr[0]);
+        for(Index i = 0; i < tcorr.size(); i++) {
+          corr_begin[i] += tcorr[i];
+        }
+      }
+    }
+  }
+
+  /// \brief Returns correlations using 'clexulator', dividing the unit cells of 'scel' among the threads of 'scheduler'
+  ///
+  /// Unit cells are divided into fixed size blocks, each summed with its own copy of 'clexulator'.
+  /// The block sums are then added in order.
+  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, const Clexulator &clexulator, TaskScheduler &scheduler) {
+
+    Index scel_vol = scel.volume();
+    Index corr_size = clexulator.corr_size();
+
+    auto block_sum = [&](Index v_begin, Index v_end) {
+      Clexulator tclexulator(clexulator);
+      Correlation block_corr(corr_size, 0.0);
+      _accumulate_correlations(configdof, scel, tclexulator, v_begin, v_end, &block_corr[0]);
+      return block_corr;
+    };
+
+    auto add = [&](Correlation & lhs, const Correlation & rhs) {
+      for(Index i = 0; i < corr_size; i++) {
+        lhs[i] += rhs[i];
+      }
+      return lhs;
+    };
+
+    Correlation correlations = scheduler.parallel_reduce(0, scel_vol, Correlation(corr_size, 0.0), block_sum, add, corr_block_size);
+
+    // normalize by supercell volume
+    for(Index i = 0; i < corr_size; i++) {
+      correlations[i] /= (double) scel_vol;
+    }
+
+    return correlations;
+  }
+
 
 
   //ConfigDoF &apply(const Permutation &perm, ConfigDoF &dof) {
@@ -0,0 +1,338 @@
+#include "casm/clex/ConfigEnumShards.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "casm/casm_io/SafeOfstream.hh"
+#include "casm/clex/ConfigCanonicalizer.hh"
+#include "casm/clex/ConfigEnum.hh"
+#include "casm/clex/ConfigEnumIterator.hh"
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/Supercell.hh"
+#include "casm/container/Counter.hh"
+#include "casm/system/TaskScheduler.hh"
+
+namespace CASM {
+
+  namespace {
+
+    void _write_shard_uint(std::ostream &sout, Index value) {
+      std::uint64_t v = value;
+      sout.write(reinterpret_cast<const char *>(&v), sizeof(v));
+    }
+
+    /// Read a uint64 at 'pos' of 'data', returning false if it runs past the end
+    bool _read_shard_uint(const std::string &data, Index pos, Index &value) {
+      std::uint64_t v;
+      if(pos < 0 || data.size() < pos + sizeof(v)) {
+        return false;
+      }
+      std::memcpy(&v, data.data() + pos, sizeof(v));
+      value = v;
+      return true;
+    }
+
+    std::string _read_file(const fs::path &path) {
+      fs::ifstream file(path, std::ios::binary);
+      std::stringstream ss;
+      ss << file.rdbuf();
+      return ss.str();
+    }
+
+    /// Enumerates the configurations stored in completed shards, in shard order
+    class ShardReader : public ConfigEnum<Configuration> {
+
+    public:
+
+      ShardReader(Supercell &scel, const std::vector<std::pair<fs::path, std::pair<Index, Index> > > &shards) :
+        ConfigEnum<Configuration>(Configuration(scel), Configuration(scel), -1),
+        m_shards(shards),
+        m_shard(-1),
+        m_config(0),
+        m_occ(scel.num_sites(), 0) {
+
+        _source() = "occupation_enumeration";
+
+        _step() = -1;
+        if(_next()) {
+          _step() = 0;
+        }
+      }
+
+      const value_type &increment() {
+        if(_next()) {
+          _step()++;
+        }
+        else {
+          _step() = -1;
+        }
+        return current();
+      }
+
+      const value_type &goto_step(step_type _step) {
+        std::cerr << "CRITICAL ERROR: ShardReader does not implement a goto_step() method. \n"
+                  << "                You may be using a ConfigEnumIterator in an unsafe way!\n"
+                  << "                Exiting...\n";
+        assert(0);
+        exit(1);
+        return current();
+      }
+
+    private:
+
+      /// Set current() to the next stored configuration, return false if there are none left
+      bool _next() {
+        Index N = m_occ.size();
+        while(m_shard < 0 || m_config * N >= m_data.size()) {
+          if(++m_shard >= m_shards.size()) {
+            return false;
+          }
+          const auto &shard = m_shards[m_shard];
+          fs::ifstream file(shard.first, std::ios::binary);
+          file.seekg(shard.second.first);
+          m_data.resize(shard.second.second * N);
+          file.read(&m_data[0], m_data.size());
+          if(!file) {
+            throw std::runtime_error(std::string("Error in ConfigEnumShards: could not read ") + shard.first.string());
+          }
+          m_config = 0;
+        }
+
+        for(Index i = 0; i < N; i++) {
+          m_occ[i] = static_cast<unsigned char>(m_data[m_config * N + i]);
+        }
+        _current().set_occupation(m_occ);
+        m_config++;
+        return true;
+      }
+
+      /// file, offset, and number of configurations of each shard
+      std::vector<std::pair<fs::path, std::pair<Index, Index> > > m_shards;
+
+      Index m_shard;
+      Index m_config;
+      std::string m_data;
+      Array<int> m_occ;
+    };
+
+  }
+
+  //*******************************************************************************************
+
+  ConfigEnumShards::ConfigEnumShards(Supercell &scel, const fs::path &dir, Index target_shards) :
+    m_scel(&scel),
+    m_dir(dir),
+    m_max_occupation(scel.max_allowed_occupation()),
+    m_fixed_sites(0),
+    m_num_shards(1) {
+
+    for(Index i = 0; i < m_max_occupation.size(); i++) {
+      if(m_max_occupation[i] > 255) {
+        throw std::runtime_error("Error in ConfigEnumShards: occupant indices can not be stored in one byte");
+      }
+    }
+
+    // fix the outer loop sites of the counter until there are enough shards
+    while(m_num_shards < target_shards && m_fixed_sites < m_max_occupation.size()) {
+      m_fixed_sites++;
+      m_num_shards *= m_max_occupation[m_max_occupation.size() - m_fixed_sites] + 1;
+    }
+
+    fs::create_directories(m_dir);
+    _read_layout(0);
+    _read_shards(fs::path());
+  }
+
+  //*******************************************************************************************
+
+  Index ConfigEnumShards::num_configs() const {
+    Index result = 0;
+    for(const auto &shard : m_complete) {
+      result += shard.second.count;
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  void ConfigEnumShards::enumerate(TaskScheduler &scheduler, Index part, Index num_parts) {
+
+    if(num_parts < 1 || part < 0 || part >= num_parts) {
+      std::stringstream ss;
+      ss << "Error in ConfigEnumShards::enumerate: invalid part " << part << " of " << num_parts;
+      throw std::runtime_error(ss.str());
+    }
+
+    std::stringstream ss;
+    ss << "part_" << part << "_of_" << num_parts << ".bin";
+    fs::path path = m_dir / ss.str();
+
+    // re-read, to pick up shards completed by other processes and clean up our own file
+    _read_shards(path);
+
+    std::vector<Index> todo;
+    for(Index shard = part; shard < m_num_shards; shard += num_parts) {
+      if(!m_complete.count(shard)) {
+        todo.push_back(shard);
+      }
+    }
+    if(todo.empty()) {
+      return;
+    }
+
+    // build the canonicalizer before the threads use it
+    m_scel->canonicalizer();
+
+    Index offset = fs::exists(path) ? fs::file_size(path) : 0;
+    fs::ofstream file(path, std::ios::binary | std::ios::app);
+    std::mutex file_mutex;
+
+    scheduler.parallel_for(0, todo.size(), [&](Index begin, Index end) {
+      for(Index i = begin; i < end; i++) {
+        std::string occ = _enumerate_shard(todo[i]);
+        Index count = occ.size() / m_max_occupation.size();
+
+        std::unique_lock<std::mutex> lock(file_mutex);
+        _write_shard_uint(file, 2 * sizeof(std::uint64_t) + occ.size());
+        _write_shard_uint(file, todo[i]);
+        _write_shard_uint(file, count);
+        file.write(occ.data(), occ.size());
+        file.flush();
+        if(!file) {
+          throw std::runtime_error(std::string("Error in ConfigEnumShards: could not write ") + path.string());
+        }
+
+        ShardRecord record;
+        record.path = path;
+        record.offset = offset + 3 * sizeof(std::uint64_t);
+        record.count = count;
+        m_complete[todo[i]] = record;
+        offset += 3 * sizeof(std::uint64_t) + occ.size();
+      }
+    }, 1);
+  }
+
+  //*******************************************************************************************
+
+  void ConfigEnumShards::merge() {
+
+    if(!complete()) {
+      std::stringstream ss;
+      ss << "Error in ConfigEnumShards::merge: only " << num_complete() << " of " << size()
+         << " shards are complete for " << m_scel->get_name();
+      throw std::runtime_error(ss.str());
+    }
+
+    std::vector<std::pair<fs::path, std::pair<Index, Index> > > shards;
+    for(const auto &shard : m_complete) {
+      shards.push_back(std::make_pair(shard.second.path, std::make_pair(shard.second.offset, shard.second.count)));
+    }
+
+    ShardReader reader(*m_scel, shards);
+    m_scel->add_enumerated_configurations(reader);
+  }
+
+  //*******************************************************************************************
+
+  void ConfigEnumShards::_read_layout(Index part) {
+
+    jsonParser layout;
+    layout["supercell"] = m_scel->get_name();
+    layout["max_occupation"] = m_max_occupation;
+    layout["fixed_sites"] = m_fixed_sites;
+    layout["shards"] = m_num_shards;
+
+    fs::path path = m_dir / "shards.json";
+    if(fs::exists(path)) {
+      jsonParser existing(path);
+      if(existing != layout) {
+        throw std::runtime_error(std::string("Error in ConfigEnumShards: ") + path.string() +
+                                 " does not match this enumeration. Remove " + m_dir.string() + " to restart it.");
+      }
+      return;
+    }
+
+    SafeOfstream file;
+    std::stringstream ext;
+    ext << "tmp." << part;
+    file.open(path, ext.str());
+    layout.print(file.ofstream());
+    file.close();
+  }
+
+  //*******************************************************************************************
+
+  void ConfigEnumShards::_read_shards(const fs::path &own_file) {
+
+    m_complete.clear();
+
+    Index N = m_max_occupation.size();
+    fs::directory_iterator it(m_dir), end;
+    for(; it != end; ++it) {
+      if(it->path().extension() != ".bin") {
+        continue;
+      }
+
+      std::string data = _read_file(it->path());
+      Index pos = 0, record_size, shard, count;
+      while(_read_shard_uint(data, pos, record_size) &&
+            record_size >= 2 * sizeof(std::uint64_t) &&
+            data.size() - pos - sizeof(std::uint64_t) >= record_size) {
+
+        _read_shard_uint(data, pos + sizeof(std::uint64_t), shard);
+        _read_shard_uint(data, pos + 2 * sizeof(std::uint64_t), count);
+        if(shard < 0 || shard >= m_num_shards || count * N != record_size - 2 * sizeof(std::uint64_t)) {
+          throw std::runtime_error(std::string("Error in ConfigEnumShards: invalid file ") + it->path().string());
+        }
+
+        ShardRecord record;
+        record.path = it->path();
+        record.offset = pos + 3 * sizeof(std::uint64_t);
+        record.count = count;
+        m_complete[shard] = record;
+
+        pos += sizeof(std::uint64_t) + record_size;
+      }
+
+      // an incomplete record at the end is left by an interrupted enumeration
+      if(pos != data.size() && it->path() == own_file) {
+        std::cerr << "WARNING: Ignoring incomplete record at the end of " << it->path() << std::endl;
+        fs::resize_file(it->path(), pos);
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  std::string ConfigEnumShards::_enumerate_shard(Index shard) const {
+
+    Index N = m_max_occupation.size();
+    Array<int> initial(N, 0);
+    Array<int> final(m_max_occupation);
+
+    // the fixed sites, with the last site as the most significant digit, as in Counter
+    for(Index i = N - m_fixed_sites; i < N; i++) {
+      initial[i] = final[i] = shard % (m_max_occupation[i] + 1);
+      shard /= (m_max_occupation[i] + 1);
+    }
+
+    const ConfigCanonicalizer &canonicalizer = m_scel->canonicalizer();
+    Counter<Array<int> > counter(initial, final, Array<int>(N, 1));
+    ConfigDoF dof(N);
+    std::string result;
+
+    for(; counter.valid(); ++counter) {
+      dof.set_occupation(counter());
+      if(canonicalizer.is_canonical(dof) && canonicalizer.is_primitive(dof)) {
+        for(Index i = 0; i < N; i++) {
+          result.push_back(static_cast<char>(static_cast<unsigned char>(counter()[i])));
+        }
+      }
+    }
+    return result;
+  }
+
+}
@@ -82,16 +82,40 @@ namespace CASM {
       return std::abs(_config.deformation().determinant()) - 1.0;
     }
 
+    // Values used by several formatters are computed once per row, see DataFormatterContext
+
+    Correlation row_correlations(const Configuration &_config, Clexulator &_clexulator) {
+      return DataFormatterContext::get<Correlation>("corr(" + _clexulator.name() + ")", [&]()->Correlation {
+        return correlations(_config, _clexulator);
+      });
+    }
+
+    Eigen::VectorXd row_param_composition(const Configuration &_config) {
+      return DataFormatterContext::get<Eigen::VectorXd>("comp", [&]()->Eigen::VectorXd {
+        return _config.get_param_composition();
+      });
+    }
+
+    Array<double> row_true_composition(const Configuration &_config) {
+      return DataFormatterContext::get<Array<double> >("site_frac", [&]()->Array<double> {
+        return _config.get_true_composition();
+      });
+    }
+
+    Array<double> row_composition(const Configuration &_config) {
+      return DataFormatterContext::get<Array<double> >("atom_frac", [&]()->Array<double> {
+        return _config.get_composition();
+      });
+    }
+
 
     //****************************************************************************************
 
     std::string CorrConfigFormatter::long_header(const Configuration &_tmplt) const {
 
-      Correlation corr = correlations(_tmplt, m_clexulator);
-
       std::stringstream ss, word_ss;
       if(_index_rules().size() == 0) {
-        for(Index lin_ind = 0; lin_ind < corr.size(); lin_ind++) {
+        for(Index lin_ind = 0; lin_ind < m_clexulator.corr_size(); lin_ind++) {
           word_ss.str(std::string());
           word_ss.clear();
           word_ss << "corr(" << lin_ind << ")";
@@ -114,7 +138,7 @@ namespace CASM {
 
     void CorrConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      Correlation corr = row_correlations(_config, m_clexulator);
 
       //Cases
       if(_index_rules().size() == 0) {
@@ -138,7 +162,7 @@ namespace CASM {
 
     void CorrConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      Correlation corr = row_correlations(_config, m_clexulator);
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
@@ -164,7 +188,7 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &CorrConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = correlations(_config, m_clexulator);
+      json = row_correlations(_config, m_clexulator);
       return json;
     }
 
@@ -186,15 +210,24 @@ namespace CASM {
     //****************************************************************************************
 
     void ClexConfigFormatter::init(const Configuration &_tmplt) const {
-      if(!m_clexulator.initialized()) {
-        m_clexulator = _tmplt.get_primclex().global_clexulator();
+      Clexulator clexulator = m_clex.clexulator();
+      if(!clexulator.initialized()) {
+        clexulator = _tmplt.get_primclex().eci_clexulator(m_clex_name);
       }
 
-      m_eci = _tmplt.get_primclex().global_eci(m_clex_name);
+      m_clex = ClexEvaluator(clexulator, _tmplt.get_primclex().global_eci(m_clex_name));
     };
 
     //****************************************************************************************
 
+    double ClexConfigFormatter::_row_value(const Configuration &_config) const {
+      return DataFormatterContext::get<double>(short_header(_config), [&]()->double {
+        return m_clex(_config);
+      });
+    }
+
+    //****************************************************************************************
+
     std::string ClexConfigFormatter::short_header(const Configuration &_tmplt) const {
       return "clex(" + m_clex_name + ")";
     }
@@ -202,7 +235,7 @@ namespace CASM {
     //****************************************************************************************
 
     void ClexConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << _row_value(_config);
     }
 
     //****************************************************************************************
@@ -211,14 +244,14 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << _row_value(_config);
 
     }
 
     //****************************************************************************************
 
     jsonParser &ClexConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = m_eci * correlations(_config, m_clexulator);
+      json = _row_value(_config);
       return json;
     }
 
@@ -266,7 +299,7 @@ namespace CASM {
     //****************************************************************************************
 
     void SiteFracConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      auto comp = _config.get_true_composition();
+      Array<double> comp = row_true_composition(_config);
 
       for(Index c = 0; c < _index_rules().size(); c++) {
         _stream << comp[_index_rules()[c][0]];
@@ -277,7 +310,7 @@ namespace CASM {
     //****************************************************************************************
 
     void SiteFracConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
-      auto comp = _config.get_true_composition();
+      Array<double> comp = row_true_composition(_config);
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
@@ -295,7 +328,7 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &SiteFracConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = _config.get_true_composition();
+      json = row_true_composition(_config);
       return json;
     }
 
@@ -346,7 +379,7 @@ namespace CASM {
     //****************************************************************************************
 
     void AtomFracConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      auto comp = _config.get_composition();
+      Array<double> comp = row_composition(_config);
 
       for(Index c = 0; c < _index_rules().size(); c++) {
         _stream << comp[_index_rules()[c][0]];
@@ -357,7 +390,7 @@ namespace CASM {
     //****************************************************************************************
 
     void AtomFracConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
-      auto comp = _config.get_composition();
+      Array<double> comp = row_composition(_config);
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
@@ -375,7 +408,7 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &AtomFracConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = _config.get_composition();
+      json = row_composition(_config);
       return json;
     }
     //****************************************************************************************
@@ -428,7 +461,7 @@ namespace CASM {
     //****************************************************************************************
 
     void CompConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      Eigen::VectorXd p_comp = _config.get_param_composition();
+      Eigen::VectorXd p_comp = row_param_composition(_config);
 
       for(Index c = 0; c < _index_rules().size(); c++) {
         _stream << p_comp(_index_rules()[c][0]);
@@ -439,7 +472,7 @@ namespace CASM {
     //****************************************************************************************
 
     void CompConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
-      Eigen::VectorXd p_comp = _config.get_param_composition();
+      Eigen::VectorXd p_comp = row_param_composition(_config);
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
@@ -456,7 +489,7 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &CompConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = _config.get_param_composition();
+      json = row_param_composition(_config);
       return json;
     }
 
@@ -70,34 +70,63 @@ namespace CASM {
       Eigen::MatrixXd reduced_mat(m_projection * mat_wrapper.matrix().transpose());
       //std::cout << "Size after: " << reduced_mat.rows() << ", " << reduced_mat.cols() << "\n";
       //std::cout << "reduced_mat is \n" << reduced_mat.transpose() << "\n\n and projection is \n" << m_projection << "\n\n";
-      m_hull.set_verbosity(0);
 
-      //(using check_for_repeats=false doesn't seem to be an improvement)
-      m_hull.reset_points(reduced_mat, true);
+      // HullCache expects the energy first, so that it defines which direction is down
+      Eigen::MatrixXd points(rank + 1, reduced_mat.cols());
+      points << reduced_mat.bottomRows(1), reduced_mat.topRows(rank);
 
-      if(!m_hull.calc_CH()) { //calculates hull
+      // each combination of selection and properties has its own cache
+      std::stringstream t_ss;
+      t_ss << m_selection << ";" << m_dependent_prop;
+      for(Index i = 0; i < m_independent_props.size(); i++)
+        t_ss << ";" << m_independent_props[i];
+      const DirectoryStructure &dir = _tmplt.get_primclex().dir();
+      fs::path cache_file = dir.hull_cache_query(t_ss.str());
+
+      m_hull = std::make_shared<HullCache>();
+      m_hull->read(cache_file);
+      if(!m_hull->update(mat_wrapper.labels(), points)) { //calculates hull
         throw std::runtime_error("Failure to construct convex hull from selection " + m_selection
                                  + " for formatted output!\n");
       }
+      if(m_hull->changed()) {
+        m_hull->write(cache_file);
+        HullCache::prune(dir.hull_cache_dir(), HullCache::max_cached);
+      }
 
-      // define which direction is down
-      Eigen::VectorXd down = Eigen::VectorXd::Zero(rank + 1);
-      down(rank) = -1;
-      m_hull.CH_bottom(down);
+      // record names of on-hull configs
+      m_on_hull.clear();
+      auto hull_inds = m_hull->vertices();
+      for(Index i = 0; i < hull_inds.size(); i++) {
+        m_on_hull[mat_wrapper.labels()[hull_inds[i]]] = true;
+      }
 
+    }
 
-      /*
-      for(Index i=0; i<m_hull.size(); i++){
-        std::cout << "  i" << i<<":  " << reduced_mat.col(i).transpose() << "   " << mat_wrapper.matrix().row(i) << "   " <<m_hull.pos(i).transpose() << "   " << m_hull.CH_dist_to_hull(m_hull.pos(i)) << "\n";
-        }*/
+    //****************************************************************************************
 
+    double BaseHullConfigFormatter::_dist_to_hull(const Configuration &_config, const Eigen::MatrixXd &_data) const {
+      Eigen::VectorXd reduced(_projection() * _data.transpose());
+      Index rank = reduced.size() - 1;
+      Eigen::VectorXd point(rank + 1);
+      point << reduced(rank), reduced.head(rank);
 
-      // record names of on-hull configs
-      auto hull_inds = m_hull.CH_verts_indices();
-      for(Index i = 0; i < hull_inds.size(); i++) {
-        m_on_hull[mat_wrapper.labels()[hull_inds[i]]] = true;
+      Index i = _hull().find(_config.name());
+      if(i < _hull().size() && _hull().points().col(i) == point) {
+        return _hull().dist_to_hull(i);
       }
+      return _hull().dist_to_hull(Eigen::MatrixXd(point))(0);
+    }
 
+    //****************************************************************************************
+    double BaseHullConfigFormatter::_row_dist_to_hull(const Configuration &_config) const {
+      return DataFormatterContext::get<double>(short_header(_config), [&]()->double {
+        MatrixXdDataStream mat_wrapper;
+        mat_wrapper << _format()(_config);
+        if(mat_wrapper.fail())
+          return NAN;
+        return _dist_to_hull(_config, mat_wrapper.matrix());
+      });
     }
 
     //****************************************************************************************
@@ -156,12 +185,11 @@ namespace CASM {
     //****************************************************************************************
 
     void HullDistConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      if(mat_wrapper.fail())
+      double dist = _row_dist_to_hull(_config);
+      if(std::isnan(dist))
         _stream << DataStream::failbit << double(NAN);
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
@@ -170,26 +198,21 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      //std::cout << "mat_wrapper.matrix() is " << mat_wrapper.matrix() << "\n";
-      //std::cout << "rotated, is " << (_projection()*mat_wrapper.matrix().transpose()).transpose() << "\n";
-      //std::cout << "projection is \n" << _projection() << "\n";
-      if(mat_wrapper.fail())
+      double dist = _row_dist_to_hull(_config);
+      if(std::isnan(dist))
         _stream << "unknown";
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
 
     jsonParser &HullDistConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      if(mat_wrapper.fail())
+      double dist = _row_dist_to_hull(_config);
+      if(std::isnan(dist))
         json = "unknown";
       else
-        json = _hull().CH_dist_to_hull(Eigen::VectorXd(_projection() * mat_wrapper.matrix().transpose()));
+        json = dist;
       return json;
     }
   }
@@ -3,9 +3,13 @@
 #include "casm/strain/StrainConverter.hh"
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/LatticeMap.hh"
+#include "casm/crystallography/PeriodicCellList.hh"
 #include "casm/crystallography/SupercellEnumerator.hh"
+#include "casm/misc/SparseAssignment.hh"
+#include "casm/system/TaskScheduler.hh"
 
 namespace CASM {
+
   //*******************************************************************************************
   namespace ConfigMapping {
     double strain_cost(const Lattice &relaxed_lat, const ConfigDoF &_dof) {
@@ -20,6 +24,33 @@ namespace CASM {
     }
   }
 
+  //*******************************************************************************************
+
+  MappingCandidates::MappingCandidates(PrimClex &_pclex, double _tol) :
+    m_pclex(&_pclex),
+    m_tol(_tol) {
+    // the point group is generated on first use, so do it now, before any structures are mapped in parallel
+    m_pclex->get_prim().point_group();
+  }
+
+  //*******************************************************************************************
+
+  const std::vector<std::shared_ptr<const Supercell> > &MappingCandidates::supercells(Index vol) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_supercells.find(vol);
+    if(it != m_supercells.end()) {
+      return it->second;
+    }
+
+    std::vector<std::shared_ptr<const Supercell> > &result = m_supercells[vol];
+    const Structure &prim = m_pclex->get_prim();
+    SupercellEnumerator<Lattice> enumerator(prim.lattice(), prim.point_group(), vol, vol + 1);
+    for(auto lat_it = enumerator.begin(); lat_it != enumerator.end(); ++lat_it) {
+      result.push_back(std::make_shared<Supercell>(m_pclex, niggli(*lat_it, prim.point_group(), m_tol)));
+    }
+    return result;
+  }
+
 
   //*******************************************************************************************
 
@@ -91,16 +122,40 @@ namespace CASM {
                                    double lattice_weight,
                                    double vol_tol) {
 
-    //Indices for Configuration index and permutation operation index
     ConfigDoF tconfigdof;
     Lattice mapped_lat;
-    bool new_config_flag;
-
-    relaxation_properties.put_obj();
 
     if(!struc_to_configdof(_struc, pclex, tconfigdof, mapped_lat, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol))
       throw std::runtime_error("Structure is incompatible with PRIM.");
 
+    return import_mapped_occupation(_struc,
+                                    tconfigdof,
+                                    mapped_lat,
+                                    hint_ptr,
+                                    pclex,
+                                    imported_name,
+                                    relaxation_properties,
+                                    strict_flag,
+                                    _tol);
+  }
+
+  //*******************************************************************************************
+
+  bool import_mapped_occupation(const BasicStructure<Site> &_struc,
+                                const ConfigDoF &tconfigdof,
+                                const Lattice &mapped_lat,
+                                const Configuration *hint_ptr,
+                                PrimClex &pclex,
+                                std::string &imported_name,
+                                jsonParser &relaxation_properties,
+                                bool strict_flag,
+                                double _tol) {
+
+    //Indices for Configuration index and permutation operation index
+    bool new_config_flag;
+
+    relaxation_properties.put_obj();
+
     relaxation_properties["basis_deformation"] = ConfigMapping::basis_cost(tconfigdof);
     relaxation_properties["lattice_deformation"] = ConfigMapping::strain_cost(_struc.lattice(), tconfigdof);
     relaxation_properties["volume_relaxation"] = tconfigdof.deformation().determinant();
@@ -161,6 +216,39 @@ namespace CASM {
 
   //*******************************************************************************************
 
+  std::vector<ConfigMapping::MappedStructure> map_structures(const std::vector<BasicStructure<Site> > &strucs,
+                                                             const MappingCandidates &candidates,
+                                                             bool robust_flag,
+                                                             bool rotate_flag,
+                                                             double _tol,
+                                                             double lattice_weight,
+                                                             double vol_tol) {
+    // each structure only writes its own result, and mapping is by far the most expensive part of an import
+    std::vector<ConfigMapping::MappedStructure> result(strucs.size());
+    parallel_for(0, strucs.size(), [&](Index begin, Index end) {
+      for(Index i = begin; i < end; i++) {
+        try {
+          result[i].valid = struc_to_configdof(strucs[i],
+                                               candidates,
+                                               result[i].configdof,
+                                               result[i].lat,
+                                               robust_flag,
+                                               rotate_flag,
+                                               _tol,
+                                               lattice_weight,
+                                               vol_tol);
+        }
+        catch(const std::exception &ex) {
+          result[i].valid = false;
+          result[i].error = ex.what();
+        }
+      }
+    });
+    return result;
+  }
+
+  //*******************************************************************************************
+
   bool import_structure(const fs::path &pos_path,
                         PrimClex &pclex,
                         std::string &imported_name,
@@ -284,7 +372,30 @@ namespace CASM {
                           double _tol,
                           double lattice_weight,
                           double vol_tol) {
+    return struc_to_configdof(struc,
+                              MappingCandidates(pclex, max(_tol, 1e-12)),
+                              mapped_configdof,
+                              mapped_lat,
+                              robust_flag,
+                              rotate_flag,
+                              _tol,
+                              lattice_weight,
+                              vol_tol);
+  }
 
+  //*******************************************************************************************
+
+  bool struc_to_configdof(const BasicStructure<Site> &struc,
+                          const MappingCandidates &candidates,
+                          ConfigDoF &mapped_configdof,
+                          Lattice &mapped_lat,
+                          bool robust_flag,
+                          bool rotate_flag,
+                          double _tol,
+                          double lattice_weight,
+                          double vol_tol) {
+
+    PrimClex &pclex(candidates.primclex());
     bool valid_mapping(false);
     // If structure's lattice is a supercell of the primitive lattice, then import as ideal_structure
     if(!robust_flag && struc.lattice().is_supercell_of(pclex.get_prim().lattice(), _tol)) {
@@ -295,7 +406,7 @@ namespace CASM {
 
     // If structure's lattice is not a supercell of the primitive lattice, then import as deformed_structure
     if(!valid_mapping) // if not a supercell or robust_flag=true, treat as deformed
-      valid_mapping = deformed_struc_to_configdof(struc,  pclex, mapped_configdof, mapped_lat, rotate_flag, _tol, lattice_weight, vol_tol);
+      valid_mapping = deformed_struc_to_configdof(struc, candidates, mapped_configdof, mapped_lat, rotate_flag, _tol, lattice_weight, vol_tol);
 
     return valid_mapping;
   }
@@ -362,6 +473,31 @@ namespace CASM {
                                    double _tol,
                                    double lattice_weight,
                                    double vol_tol) {
+    return deformed_struc_to_configdof(struc,
+                                       MappingCandidates(pclex, max(_tol, 1e-12)),
+                                       mapped_configdof,
+                                       mapped_lat,
+                                       rotate_flag,
+                                       _tol,
+                                       lattice_weight,
+                                       vol_tol);
+  }
+
+  //*******************************************************************************************
+  /*
+   * The candidate supercells of each volume are taken from 'candidates', which should have been
+   * constructed with tolerance max(_tol, 1e-12), so that they are the same as would be enumerated here.
+   */
+  //*******************************************************************************************
+  bool deformed_struc_to_configdof(const BasicStructure<Site> &struc,
+                                   const MappingCandidates &candidates,
+                                   ConfigDoF &mapped_configdof,
+                                   Lattice &mapped_lat,
+                                   bool rotate_flag,
+                                   double _tol,
+                                   double lattice_weight,
+                                   double vol_tol) {
+    const PrimClex &pclex(candidates.primclex());
     //squeeze lattice_weight into [0,1] if necessary
     double lw = max(min(lattice_weight, 1.0), 1e-9);
     double bw = 1.0 - lw;
@@ -399,7 +535,22 @@ namespace CASM {
     //std::cout << "First pass: ";
     for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
       //std::cout << "v=" << i_vol << "   ";
-      tlat = find_nearest_super_lattice(pclex.get_prim().lattice(), struc.lattice(), pclex.get_prim().point_group(), tF, ttrans_mat, i_vol, i_vol, _tol);
+      // same as find_nearest_super_lattice, for the candidate supercells of this volume
+      const Supercell *nearest_scel(nullptr);
+      double nearest_cost = 10e10;
+      for(const auto &cand : candidates.supercells(i_vol)) {
+        LatticeMap strainmap(cand->get_real_super_lattice(), struc.lattice(), 1, _tol, 1);
+        if(strainmap.best_strain_mapping().strain_cost() < nearest_cost) {
+          ttrans_mat = strainmap.matrixN();
+          tF = strainmap.matrixF();
+          nearest_cost = strainmap.strain_cost();
+          nearest_scel = cand.get();
+        }
+      }
+      if(nearest_scel == nullptr)
+        continue;
+      const Supercell &scel(*nearest_scel);
+      tlat = scel.get_real_super_lattice();
       strain_cost = lw * LatticeMap::calc_strain_cost(tF, struc.lattice().vol() / num_atoms);
 
       if(best_cost < strain_cost)
@@ -414,8 +565,6 @@ namespace CASM {
         tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), FRAC);
       }
 
-      Supercell scel(&pclex, tlat);
-
       if(!struc_to_configdof(scel, tstruc, tdof, true, _tol))
         continue;
       basis_cost = bw * ConfigMapping::basis_cost(tdof);
@@ -437,11 +586,11 @@ namespace CASM {
     //std::cout << "Second pass:\n";
     for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
       //std::cout << "  vol = " << i_vol << "\n";
-      SupercellEnumerator<Lattice> enumerator(pclex.get_prim().lattice(), pclex.get_prim().point_group(), i_vol, i_vol + 1);
+      const std::vector<std::shared_ptr<const Supercell> > &scels(candidates.supercells(i_vol));
       bool break_early(false);
-      for(auto it = enumerator.begin(); it != enumerator.end() && !break_early; ++it) {
-        tlat = niggli(*it, pclex.get_prim().point_group(), _tol);
-        Supercell scel(&pclex, tlat);
+      for(auto it = scels.begin(); it != scels.end() && !break_early; ++it) {
+        const Supercell &scel(**it);
+        tlat = scel.get_real_super_lattice();
 
         //Determine best mapping for this supercell
 
@@ -657,14 +806,65 @@ namespace CASM {
 
     //Initialize everything
 
-    Eigen::MatrixXd cost_matrix(scel.num_sites(), scel.num_sites());
-    std::vector<Index> optimal_assignments(scel.num_sites()), best_assignments(scel.num_sites());
+    Index N = scel.num_sites();
+    Index Na = rstruc.basis.size();
+    if(Na > N)
+      return false;
+
+    std::vector<Index> optimal_assignments(N), best_assignments(N);
     //BasicStructure<Site> best_ideal_struc(rstruc);
     Coordinate ttrans(Vector3<double>(0, 0, 0), rstruc.lattice(), FRAC), best_trans(Vector3<double>(0, 0, 0), rstruc.lattice(), FRAC);
-    Array<int> assignment_bitstring(scel.num_sites());
+    Array<int> assignment_bitstring(N);
     double min_mean = 10E10;
     double trans_dist;
 
+    // The cost matrix is the same as from calc_cost_matrix, except that only the (site, atom)
+    // pairs closer than 'cutoff' are included, so that it can be built using a cell list and
+    // solved as a sparse assignment problem. The cutoff starts at about the distance between
+    // sites, and is doubled until the dual variables of the solution show that none of the
+    // excluded pairs could improve it.
+
+    // allowed[j][b]: atom j is allowed on prim basis site b; va_allowed[b]: vacancies are allowed on b
+    const Structure &prim(scel.get_prim());
+    std::vector<std::vector<bool> > allowed(Na, std::vector<bool>(prim.basis.size()));
+    std::vector<bool> va_allowed(prim.basis.size());
+    for(Index b = 0; b < prim.basis.size(); b++) {
+      for(Index j = 0; j < Na; j++) {
+        allowed[j][b] = prim.basis[b].contains(rstruc.basis[j].occ_name());
+      }
+      va_allowed[b] = prim.basis[b].contains("Va");
+    }
+    for(Index j = 0; j < Na; j++) {
+      if(std::find(allowed[j].begin(), allowed[j].end(), true) == allowed[j].end())
+        return false;
+    }
+    if(Na < N && std::find(va_allowed.begin(), va_allowed.end(), true) == va_allowed.end())
+      return false;
+
+    // fractional coordinates, in the ideal supercell lattice, of the sites and the relaxed atoms
+    Eigen::Matrix3d lat_mat(scel.get_real_super_lattice().lat_column_mat());
+    Eigen::Matrix3d inv_lat_mat(scel.get_real_super_lattice().inv_lat_column_mat());
+    Eigen::MatrixXd site_frac(3, N), atom_frac(3, Na);
+    std::vector<Vector3<double> > site_frac_list(N);
+    for(Index i = 0; i < N; i++) {
+      Vector3<double> cart(scel.coord(i)(CART));
+      site_frac.col(i) = inv_lat_mat * Eigen::Vector3d(cart[0], cart[1], cart[2]);
+      site_frac_list[i] = Vector3<double>(site_frac(0, i), site_frac(1, i), site_frac(2, i));
+    }
+    for(Index j = 0; j < Na; j++) {
+      const Vector3<double> &cart(rstruc.basis[j](CART));
+      atom_frac.col(j) = inv_lat_mat * Eigen::Vector3d(cart[0], cart[1], cart[2]);
+    }
+
+    // every distance is at most max_cutoff, because each fractional coordinate of a displacement is in [-0.5, 0.5]
+    double max_cutoff = 0.5 * (lat_mat.col(0).norm() + lat_mat.col(1).norm() + lat_mat.col(2).norm());
+    double start_cutoff = min(pow(std::abs(lat_mat.determinant()) / double(N), 1.0 / 3.0), max_cutoff);
+    // cell lists for cutoff start_cutoff * 2^k, constructed as needed
+    std::vector<std::shared_ptr<PeriodicCellList> > cells;
+
+    SparseAssignment assignment;
+    std::vector<Index> near, order(Na), marker(N, -1);
+
     // We want to get rid of translations.
     // trans_coord is a vector from IDEAL to RELAXED
     // Subtract this from every rstruc coordinate
@@ -698,16 +898,84 @@ namespace CASM {
       ttrans.set_lattice(rstruc.lattice(), CART);
       trans_dist = ttrans(CART).length();
       //shift_struc -= ttrans;
-      if(!calc_cost_matrix(scel, rstruc, ttrans, cost_matrix)) {
+
+      const Vector3<double> &trans_cart(ttrans(CART));
+      Eigen::Vector3d shift = inv_lat_mat * Eigen::Vector3d(trans_cart[0], trans_cart[1], trans_cart[2]);
+
+      // The mapping routine is called here
+      double cutoff = start_cutoff;
+      bool feasible = false;
+      for(Index level = 0; true; level++) {
+        if(level == cells.size())
+          cells.push_back(std::make_shared<PeriodicCellList>(scel.get_real_super_lattice(), site_frac_list, cutoff));
+        assignment.reset(N);
+        for(Index j = 0; j < Na; j++) {
+          Eigen::Vector3d pos = atom_frac.col(j) + shift;
+          cells[level]->near(Vector3<double>(pos(0), pos(1), pos(2)), near);
+          for(Index i : near) {
+            if(!allowed[j][scel.get_b(i)])
+              continue;
+            // same as Coordinate::min_dist
+            Eigen::Vector3d diff = site_frac.col(i) - pos;
+            for(Index k = 0; k < 3; k++)
+              diff(k) -= round(diff(k));
+            double dist = (lat_mat * diff).norm();
+            if(dist <= cutoff)
+              assignment.add(i, j, dist * dist);
+          }
+        }
+        for(Index i = 0; i < N; i++) {
+          if(va_allowed[scel.get_b(i)]) {
+            for(Index j = Na; j < N; j++)
+              assignment.add(i, j, 0.0);
+          }
+        }
+
+        bool complete = (cutoff >= max_cutoff);
+        if(assignment.solve()) {
+          feasible = true;
+          if(complete)
+            break;
+
+          // An excluded pair (i, j) has cost > cutoff^2, so it can not improve the solution if
+          //   row_dual[i] + col_dual[j] <= cutoff^2. For each site, check the excluded atom with
+          //   the largest col_dual.
+          const std::vector<double> &u(assignment.row_dual());
+          const std::vector<double> &v(assignment.col_dual());
+          for(Index j = 0; j < Na; j++)
+            order[j] = j;
+          std::sort(order.begin(), order.end(), [&](Index a, Index b) {
+            return v[a] > v[b];
+          });
+          bool optimal = true;
+          for(Index i = 0; i < N && optimal; i++) {
+            for(const auto &entry : assignment.row(i))
+              marker[entry.first] = i;
+            for(Index j : order) {
+              if(marker[j] == i || !allowed[j][scel.get_b(i)])
+                continue;
+              optimal = (u[i] + v[j] <= cutoff * cutoff);
+              break;
+            }
+          }
+          std::fill(marker.begin(), marker.end(), -1);
+          if(optimal)
+            break;
+        }
+        else if(complete) {
+          break;
+        }
+        cutoff = min(2.0 * cutoff, max_cutoff);
+      }
+
+      if(!feasible) {
         //std::cerr << "In Supercell::struc_to_config. Cannot construct cost matrix." << std::endl;
         //std::cerr << "This message is probably OK, if you are using translate_flag == true." << std::endl;
-        //continue;
-        return false;
+        continue;
       }
 
-      //std::cout << "cost_matrix is\n" << cost_matrix <<  "\n\n";
-      // The mapping routine is called here
-      mean = hungarian_method(cost_matrix, optimal_assignments, _tol);
+      optimal_assignments = assignment.assignment();
+      mean = assignment.cost();
       //std::cout << "mean is " << mean << " and stddev is " << stddev << "\n";
       // add small penalty (~_tol) for larger translation distances, so that shortest equivalent translation is used
       mean += _tol * trans_dist / 10.0;
@@ -725,6 +993,10 @@ namespace CASM {
       }
     }
 
+    // no translation allows an assignment
+    if(min_mean >= 10E10)
+      return false;
+
     // Now we are filling up displacements
     //
     // Make zero_vector for special vacancy cases.
@@ -67,6 +67,13 @@ namespace CASM {
    */
   //***********************************************************
   bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool init_selection) {
+    ClexEvaluatorCache clex_cache;
+    return get_selection(criteria, config, init_selection, clex_cache);
+  }
+
+  //***********************************************************
+  bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool init_selection,
+                     ClexEvaluatorCache &clex_cache) {
 
     using namespace ConfigSelection_impl;
 
@@ -121,7 +128,7 @@ namespace CASM {
         }
       }
       else {
-        stack.push_back(convert_variable(q, config));
+        stack.push_back(convert_variable(q, config, clex_cache));
       }
     }
 
@@ -278,6 +285,12 @@ namespace CASM {
      */
     //***********************************************************
     std::string convert_variable(const std::string &q, const Configuration &config) {
+      ClexEvaluatorCache clex_cache;
+      return convert_variable(q, config, clex_cache);
+    }
+
+    //***********************************************************
+    std::string convert_variable(const std::string &q, const Configuration &config, ClexEvaluatorCache &clex_cache) {
 
       const Supercell &scel = config.get_supercell();
       const PrimClex &primclex = scel.get_primclex();
@@ -332,9 +345,11 @@ namespace CASM {
       std::regex_match(q, sm, clex_e);
       if(sm.size()) {
         std::string ss = sm[1];
-        Clexulator clexulator = primclex.global_clexulator();
-        ECIContainer eci = primclex.global_eci(ss);
-        return std::to_string(eci * correlations(config, clexulator));
+        auto it = clex_cache.find(ss);
+        if(it == clex_cache.end()) {
+          it = clex_cache.insert(std::make_pair(ss, ClexEvaluator(primclex.eci_clexulator(ss), primclex.global_eci(ss)))).first;
+        }
+        return std::to_string(it->second(config));
       }
 
       // parametric composition
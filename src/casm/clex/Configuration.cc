@@ -5,6 +5,8 @@
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/clex/ConfigCanonicalizer.hh"
+#include "casm/system/TaskScheduler.hh"
 #include "casm/crystallography/jsonStruc.hh"
 
 
@@ -30,6 +32,23 @@ namespace CASM {
     read(json);
   }
 
+  //*********************************************************************************
+  /// Construct from data stored in a ConfigDatabase
+  Configuration::Configuration(const jsonParser &json_config, const Array<int> &_occupation, bool _selected, Supercell &_supercell, Index _id)
+    : supercell(&_supercell), source_updated(false), multiplicity(-1), dof_updated(false),
+      m_configdof(_supercell.num_sites()), prop_updated(false), corr_updated(false) {
+
+    std::stringstream ss;
+    ss << _id;
+    id = ss.str();
+
+    read_dof(json_config);
+    m_configdof.set_occupation(_occupation);
+    m_selected = _selected;
+
+    read_curr_properties(json_config);
+  }
+
   //*********************************************************************************
   /*
   /// Construct a Configuration with occupation specified by string 'con_name'
@@ -169,12 +188,26 @@ namespace CASM {
 
   Configuration Configuration::canonical_form(PermuteIterator it_begin, PermuteIterator it_end, PermuteIterator &it_canon, double tol) const {
     Configuration tconfig(*this);
-    tconfig.m_configdof = m_configdof.canonical_form(it_begin, it_end, it_canon, tol);
+    if(it_begin == get_supercell().permute_begin() && it_end == get_supercell().permute_end()) {
+      tconfig.m_configdof = get_supercell().canonicalizer().canonical_form(m_configdof, it_canon, tol);
+    }
+    else {
+      tconfig.m_configdof = m_configdof.canonical_form(it_begin, it_end, it_canon, tol);
+    }
     return tconfig;
   }
 
   //*********************************************************************************
 
+  bool Configuration::is_canonical(PermuteIterator it_begin, PermuteIterator it_end, double tol) const {
+    if(it_begin == get_supercell().permute_begin() && it_end == get_supercell().permute_end()) {
+      return get_supercell().canonicalizer().is_canonical(m_configdof, tol);
+    }
+    return m_configdof.is_canonical(it_begin, it_end, tol);
+  }
+
+  //*********************************************************************************
+
   void Configuration::set_reference(const Properties &ref) {
     prop_updated = true;
     reference = ref;
@@ -275,42 +308,7 @@ namespace CASM {
 
     corr_updated = true;
 
-    const Supercell &scel = get_supercell();
-    //Size of the supercell will be used for normalizing correlations to a per primitive cell value
-    int scel_vol = scel.volume();
-
-    correlations.resize(clexulator.corr_size());
-
-    //Inform Clexulator of the bitstring
-
-    //TODO: This will probably get more complicated with displacements and stuff
-    clexulator.set_config_occ(m_configdof.occupation().begin());
-    //mc_clexor.set_config_disp(mc_confdof.m_displacements.begin());   //or whatever
-    //mc_clexor.set_config_strain(mc_confdof.m_strain.begin());   //or whatever
-
-    //Holds contribution to global correlations from a particular neighborhood
-    std::vector<double> tcorr(clexulator.corr_size(), 0.0);
-    std::vector<double> corr(clexulator.corr_size(), 0.0);
-
-    for(int v = 0; v < scel_vol; v++) {
-
-      //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
-
-      //Fill up contributions
-      clexulator.calc_global_corr_contribution(&tcorr[0]);
-
-      //Add contributions to total correlations
-      for(int i = 0; i < tcorr.size(); i++) {
-        corr[i] += tcorr[i];
-      }
-
-    }
-
-    // normalize by supercell volume
-    for(int i = 0; i < clexulator.corr_size(); i++) {
-      correlations[i] /= (double) scel_vol;
-    }
+    correlations = CASM::correlations(m_configdof, get_supercell(), clexulator);
 
     return;
   }
@@ -802,11 +800,6 @@ namespace CASM {
 
     //std::cout << "begin  Configuration::read()" << std::endl;
 
-    const ProjectSettings &set = get_primclex().settings();
-
-    std::string calc_string = "calctype." + set.calctype();
-    std::string ref_string = "ref." + set.ref();
-
     // read dof
     if(!json.contains("supercells"))
       return;
@@ -819,6 +812,22 @@ namespace CASM {
 
     read_dof(json_config);
 
+    read_curr_properties(json_config);
+
+    //std::cout << "finish Configuration::read()" << std::endl;
+  }
+
+  //*********************************************************************************
+
+  /// Read properties for the current calctype and ref
+  ///   location: json = supercells/SCEL_NAME/CONFIG_ID
+  ///
+  void Configuration::read_curr_properties(const jsonParser &json_config) {
+
+    const ProjectSettings &set = get_primclex().settings();
+
+    std::string calc_string = "calctype." + set.calctype();
+    std::string ref_string = "ref." + set.ref();
 
     // read correlations
     /*
@@ -842,8 +851,6 @@ namespace CASM {
 
     read_properties(json_prop);
 
-
-    //std::cout << "finish Configuration::read()" << std::endl;
   }
 
   //*********************************************************************************
@@ -1405,7 +1412,7 @@ namespace CASM {
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
+      clexulator.set_nlist(scel.get_nlist(v));
 
       //Fill up contributions
       clexulator.calc_global_corr_contribution(&tcorr[0]);
@@ -1426,6 +1433,32 @@ namespace CASM {
     */
   }
 
+  //*********************************************************************************
+  /// \brief Returns correlations using 'clexulator', dividing the unit cells among the threads of 'scheduler'
+  Correlation correlations(const Configuration &config, const Clexulator &clexulator, TaskScheduler &scheduler) {
+    return correlations(config.configdof(), config.get_supercell(), clexulator, scheduler);
+  }
+
+  //*********************************************************************************
+  /// \brief Call Configuration::set_correlations for each Configuration in 'config_list'
+  ///
+  /// Configurations are divided among the threads of 'scheduler'. Each group of configurations
+  /// uses its own copy of 'clexulator'. Supercell neighbor lists must already be populated, they
+  /// are not modified here.
+  ///
+  void set_correlations(const std::vector<Configuration *> &config_list, const Clexulator &clexulator, TaskScheduler &scheduler) {
+
+    // configurations per copy of 'clexulator'
+    const Index grain = 16;
+
+    scheduler.parallel_for(0, config_list.size(), [&](Index begin, Index end) {
+      Clexulator tclexulator(clexulator);
+      for(Index i = begin; i < end; i++) {
+        config_list[i]->set_correlations(tclexulator);
+      }
+    }, grain);
+  }
+
 }
 
 
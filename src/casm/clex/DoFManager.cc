@@ -88,6 +88,18 @@ namespace CASM {
 
   //************************************************************
 
+  ReturnArray<FunctionVisitor *> DoFManager::get_batch_function_label_visitors() const {
+    Array<FunctionVisitor *> tlabels;
+    for(Index i = 0; i < m_environs.size(); i++) {
+      tlabels.push_back(m_environs[i]->get_batch_function_label_visitor());
+      if(!tlabels.back())
+        tlabels.pop_back();
+    }
+    return tlabels;
+  }
+
+  //************************************************************
+
   void DoFManager::print_clexulator_member_definitions(std::ostream &stream, const PrimClex &primclex, const std::string &indent) const {
     for(Index i = 0; i < m_environs.size(); i++) {
       m_environs[i]->print_clexulator_member_definitions(stream, primclex, indent);
@@ -166,6 +178,19 @@ namespace CASM {
       }
       stream << '\n';
     }
+
+    for(Index b = 0; b < primclex.get_prim().basis.size(); b++) {
+      if(!primclex.get_prim().basis[b].occupant_basis().size())
+        continue;
+
+      stream <<
+             indent << "// Occupation Function accessors for basis site " << b << ", for configuration 'k' of a batch:\n";
+      for(Index f = 0; f < primclex.get_prim().basis[b].occupant_basis().size(); f++) {
+        stream <<
+               indent << "const double &occ_func_" << b << '_' << f << "(const int &nlist_ind, size_type k)const{return " << "m_occ_func_" << b << '_' << f << "[m_batch_occ_ptr[m_batch_nlist_ptr[nlist_ind]*m_batch_size + k]];}\n";
+      }
+      stream << '\n';
+    }
   }
 
   //************************************************************
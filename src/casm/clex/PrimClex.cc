@@ -1,11 +1,18 @@
 #include "casm/clex/PrimClex.hh"
 
+#include <map>
+#include <mutex>
+#include <regex>
+#include <tuple>
 #include <boost/algorithm/string.hpp>
 
 #include "casm/clex/ConfigIterator.hh"
+#include "casm/clex/ConfigDatabase.hh"
+#include "casm/clex/ClexEvaluator.hh"
 #include "casm/clex/ECIContainer.hh"
 #include "casm/clusterography/jsonClust.hh"
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/system/TaskScheduler.hh"
 #include "casm/casm_io/SafeOfstream.hh"
 
 
@@ -83,10 +90,17 @@ namespace CASM {
     }
 
     // read config_list
-    if(fs::is_regular_file(get_config_list_path())) {
+    if(fs::is_regular_file(m_dir.config_db())) {
+
+      any_print = true;
+      sout << "  Read " << m_dir.config_db() << std::endl;
+      read_config_list();
+    }
+    else if(fs::is_regular_file(get_config_list_path())) {
 
       any_print = true;
       sout << "  Read " << get_config_list_path() << std::endl;
+      sout << "  Convert to " << m_dir.config_db() << std::endl;
       read_config_list();
     }
 
@@ -404,33 +418,25 @@ namespace CASM {
   // **** IO ****
   //*******************************************************************************************
   /**
-   * Re-write config_list.json, updating all the data
+   * Update the configuration database with new and changed configurations
    */
 
   void PrimClex::write_config_list() {
 
     if(supercell_list.size() == 0) {
+      fs::remove(m_dir.config_db());
+      fs::remove(m_dir.config_journal());
       fs::remove(get_config_list_path());
       return;
     }
 
-    jsonParser json;
-
-    if(fs::exists(get_config_list_path())) {
-      json.read(get_config_list_path());
-    }
-    else {
-      json.put_obj();
-    }
+    ConfigDatabase db(m_dir.config_db(), m_dir.config_journal());
 
     for(Index s = 0; s < supercell_list.size(); s++) {
-      supercell_list[s].write_config_list(json);
+      supercell_list[s].write_config_list(db);
     }
 
-    SafeOfstream file;
-    file.open(get_config_list_path());
-    json.print(file.ofstream());
-    file.close();
+    db.commit();
 
     return;
   }
@@ -693,7 +699,7 @@ namespace CASM {
     global_orbitree.min_num_components = 2;
     global_orbitree.min_length = 0.0001;
     in_clust.close();
-    global_orbitree.generate_orbitree(prim);
+    global_orbitree.generate_orbitree(prim, global_scheduler());
     global_orbitree.collect_basis_info(prim);
     //std::cout << "----------------------------------------------\n\t\tGLOBAL ORBITREE\n----------------------------------------------\n ";
     //global_orbitree.print_full_clust(std::cout);
@@ -995,22 +1001,24 @@ namespace CASM {
 
   //*******************************************************************************************
   /**
-   *   Read the config_list file at 'file_name' and adds config
+   *   Read the configuration database and adds config
    *   to supercell, assuming it is already canonical.
-   *   If 'print_dirs', call Supercell::print_clex_configuration()
-   *   for each config to be made.
+   *
+   *   If there is no configuration database yet, it is created
+   *   from config_list.json, which is left in place.
    */
   //*******************************************************************************************
   void PrimClex::read_config_list() {
 
-    jsonParser json(get_config_list_path());
+    ConfigDatabase db(m_dir.config_db(), m_dir.config_journal());
 
-    if(!json.contains("supercells")) {
-      return;
+    if(!fs::exists(m_dir.config_db())) {
+      db.insert(jsonParser(get_config_list_path()));
+      db.commit();
     }
 
     for(Index i = 0; i < supercell_list.size(); i++) {
-      supercell_list[i].read_config_list(json);
+      supercell_list[i].read_config_list(db);
     }
   }
 
@@ -1316,8 +1324,16 @@ namespace CASM {
     return;
   }
 
+  //*******************************************************************************************
+  /// Guards loading Clexulators, which may be first used by DataFormatter rows formatted in parallel
+  static std::mutex &clexulator_mutex() {
+    static std::mutex m;
+    return m;
+  }
+
   //*******************************************************************************************
   Clexulator PrimClex::global_clexulator() const {
+    std::lock_guard<std::mutex> lock(clexulator_mutex());
     if(!m_global_clexulator.initialized()) {
       if(!fs::exists(dir().clexulator_src(settings().name(), settings().bset()))) {
         throw std::runtime_error(
@@ -1340,6 +1356,45 @@ namespace CASM {
                                       settings().eci()));
   }
 
+  //*******************************************************************************************
+  /// The Clexulator printed by 'casm bset --eci clex_name' is a superset of the global Clexulator,
+  /// with calc_global_energy_contribution and calc_delta_point_energy using the ECI from eci.out
+  /// at the time it was printed. It is only returned if those ECI still match global_eci(clex_name),
+  /// and its neighbor list and correlations have the same size as the global Clexulator's.
+  Clexulator PrimClex::eci_clexulator(std::string clex_name) const {
+    fs::path src = dir().eci_clexulator_src(settings().name(),
+                                            clex_name,
+                                            settings().calctype(),
+                                            settings().ref(),
+                                            settings().bset(),
+                                            settings().eci());
+    Clexulator global = global_clexulator();
+    if(!fs::exists(src)) {
+      return global;
+    }
+
+    Clexulator folded;
+    {
+      std::lock_guard<std::mutex> lock(clexulator_mutex());
+      auto it = m_eci_clexulator.find(src.string());
+      if(it == m_eci_clexulator.end()) {
+        it = m_eci_clexulator.insert(std::make_pair(src.string(),
+                                                    Clexulator(settings().eci_clexulator(clex_name),
+                                                               src.parent_path(),
+                                                               settings().compile_options(),
+                                                               settings().so_options()))).first;
+      }
+      folded = it->second;
+    }
+
+    if(folded.corr_size() != global.corr_size() ||
+       folded.nlist_size() != global.nlist_size() ||
+       !has_folded_eci(folded, global_eci(clex_name))) {
+      return global;
+    }
+    return folded;
+  }
+
   //*******************************************************************************************
   /// \brief Make orbitree. For now specifically global.
   ///
@@ -1371,7 +1426,7 @@ namespace CASM {
       }
       tree.max_num_sites = tree.max_length.size() - 1;
 
-      tree.generate_orbitree(prim);
+      tree.generate_orbitree(prim, global_scheduler());
 
       // --- then add custom orbits --------------------
 
@@ -1464,6 +1519,64 @@ namespace CASM {
     }
   }
 
+  namespace PrimClex_impl {
+
+    /// \brief ECI as a literal that reads back to the same double
+    std::string eci_literal(double value) {
+      std::stringstream ss;
+      ss.precision(17);
+      ss << value;
+      return ss.str();
+    }
+
+    /// \brief Replace occupation function lookups, 'occ_func_b_f(n)', by local variables
+    ///
+    /// Declarations of the local variables are written to 'decl', first the occupant index at
+    /// each neighbor list index, then each occupation function value, so that every lookup is done
+    /// once no matter how many clusters use it.
+    std::string hoist_occ_lookups(const std::string &expr, std::ostream &decl, const std::string &indent) {
+
+      std::regex occ_func_e("occ_func_(\\d+)_(\\d+)\\((\\d+)\\)");
+
+      std::map<int, std::string> occ_vars;
+      std::map<std::tuple<int, int, int>, std::string> func_vars;
+
+      std::string result;
+      auto last = expr.cbegin();
+      for(std::sregex_iterator it(expr.begin(), expr.end(), occ_func_e), end; it != end; ++it) {
+        const std::smatch &m = *it;
+        int b = std::stoi(m[1].str());
+        int f = std::stoi(m[2].str());
+        int n = std::stoi(m[3].str());
+        std::string var = "occ_func_" + m[1].str() + "_" + m[2].str() + "_at_" + m[3].str();
+        occ_vars[n] = "occ_at_" + m[3].str();
+        func_vars[std::make_tuple(n, b, f)] = var;
+
+        result.append(last, m[0].first);
+        result += var;
+        last = m[0].second;
+      }
+      result.append(last, expr.cend());
+
+      for(const auto &occ : occ_vars) {
+        decl << indent << "const int " << occ.second << " = *(m_occ_ptr + *(m_nlist_ptr + " << occ.first << "));\n";
+      }
+      for(const auto &func : func_vars) {
+        decl << indent << "const double " << func.second << " = m_occ_func_" << std::get<1>(func.first) << "_" << std::get<2>(func.first)
+             << "[" << occ_vars[std::get<0>(func.first)] << "];\n";
+      }
+      return result;
+    }
+
+    /// \brief Print clexulator, with fused ECI kernels if 'eci' is not null
+    void print_clexulator(const Structure &prim,
+                          SiteOrbitree &tree,
+                          const Array<UnitCellCoord> &nlist,
+                          std::string class_name,
+                          const ECIContainer *eci,
+                          std::ostream &stream);
+  }
+
   //*******************************************************************************************
   /// \brief Print clexulator
   void print_clexulator(const Structure &prim,
@@ -1471,6 +1584,27 @@ namespace CASM {
                         const Array<UnitCellCoord> &nlist,
                         std::string class_name,
                         std::ostream &stream) {
+    PrimClex_impl::print_clexulator(prim, tree, nlist, class_name, nullptr, stream);
+  }
+
+  //*******************************************************************************************
+  /// \brief Print clexulator, with fused kernels that evaluate a cluster expansion with fixed ECI
+  void print_clexulator(const Structure &prim,
+                        SiteOrbitree &tree,
+                        const Array<UnitCellCoord> &nlist,
+                        std::string class_name,
+                        const ECIContainer &eci,
+                        std::ostream &stream) {
+    PrimClex_impl::print_clexulator(prim, tree, nlist, class_name, &eci, stream);
+  }
+
+  //*******************************************************************************************
+  void PrimClex_impl::print_clexulator(const Structure &prim,
+                                       SiteOrbitree &tree,
+                                       const Array<UnitCellCoord> &nlist,
+                                       std::string class_name,
+                                       const ECIContainer *eci,
+                                       std::ostream &stream) {
 
     DoFManager dof_manager;
 
@@ -1493,6 +1627,14 @@ namespace CASM {
     Index N_corr(tree.basis_set_size());
     std::stringstream private_def_stream, public_def_stream, interface_imp_stream, bfunc_imp_stream;
 
+    // basis function implementations, one function (or orbit comment) per entry, which are split
+    //   into translation units
+    std::vector<std::string> bfunc_imp;
+    auto end_bfunc_imp = [&]() {
+      bfunc_imp.push_back(bfunc_imp_stream.str());
+      bfunc_imp_stream.str("");
+    };
+
     std::string uclass_name;
     for(Index i = 0; i < class_name.size(); i++)
       uclass_name.push_back(std::toupper(class_name[i]));
@@ -1514,6 +1656,17 @@ namespace CASM {
                        indent << "  // array of pointers to member functions for calculating basis functions\n" <<
                        indent << "  BasisFuncPtr m_orbit_func_list[" << N_corr << "];\n\n" <<
 
+                       indent << "  // typedef for method pointers\n" <<
+                       indent << "  typedef void (" << class_name << "::*BatchBasisFuncPtr)(double *) const;\n\n" <<
+
+                       indent << "  // array of pointers to member functions for calculating basis functions for a batch of configurations\n" <<
+                       indent << "  BatchBasisFuncPtr m_orbit_batch_func_list[" << N_corr << "];\n\n" <<
+
+                       indent << "  // state used by batch basis functions, set in calc_global_corr_batch\n" <<
+                       indent << "  const int *m_batch_occ_ptr;\n" <<
+                       indent << "  const long int *m_batch_nlist_ptr;\n" <<
+                       indent << "  size_type m_batch_size;\n\n" <<
+
                        indent << "  // array of pointers to member functions for calculating flower functions\n" <<
                        indent << "  BasisFuncPtr m_flower_func_lists[" << prim.basis.size() << "][" << N_corr << "];\n\n" <<
 
@@ -1549,7 +1702,8 @@ namespace CASM {
     private_def_stream <<
                        indent << "  //default functions for basis function evaluation \n" <<
                        indent << "  double zero_func() const{ return 0.0;};\n" <<
-                       indent << "  double zero_func(int,int) const{ return 0.0;};\n\n";
+                       indent << "  double zero_func(int,int) const{ return 0.0;};\n" <<
+                       indent << "  void zero_batch_func(double *) const{};\n\n";
 
     public_def_stream <<
                       indent << "  " << class_name << "();\n\n" <<
@@ -1566,6 +1720,9 @@ namespace CASM {
                       indent << "  /// \\brief Calculate contribution to select global correlations from one unit cell\n" <<
                       indent << "  void calc_restricted_global_corr_contribution(double *corr_begin, size_type const* ind_list_begin, size_type const* ind_list_end) const override;\n\n" <<
 
+                      indent << "  /// \\brief Calculate global correlations for a batch of configurations of the same supercell\n" <<
+                      indent << "  void calc_global_corr_batch(const int *occ_begin, size_type N_config, size_type N_site, const long int *nlist_begin, size_type N_unitcell, double *corr_begin) override;\n\n" <<
+
                       indent << "  /// \\brief Calculate point correlations about basis site 'b_index'\n" <<
                       indent << "  void calc_point_corr(int b_index, double *corr_begin) const override;\n\n" <<
 
@@ -1585,15 +1742,21 @@ namespace CASM {
     Index lf = 0, tlf;
 
     Array<FunctionVisitor *> labelers(dof_manager.get_function_label_visitors());
+    Array<FunctionVisitor *> batch_labelers(dof_manager.get_batch_function_label_visitors());
     //std::cout << "Initialized " << labelers.size() << " labelers \n";
 
     Array<std::string> orbit_method_names(N_corr);
+    Array<std::string> orbit_batch_method_names(N_corr);
     Array<Array<std::string> > flower_method_names(prim.basis.size(), Array<std::string>(N_corr));
     //Array< Array<Array<std::string> > > dflower_method_names(N_corr, Array<Array<std::string> >(prim.basis.size()));
 
     //this is very configuration-centric
     Array<Array<std::string> > dflower_method_names(prim.basis.size(), Array<std::string>(N_corr));
 
+    // formulae of every orbit and DELTA flower function, used for the fused ECI kernels
+    Array<std::string> orbit_formulae(N_corr);
+    Array<Array<std::string> > dflower_formulae(prim.basis.size(), Array<std::string>(N_corr));
+
     // temporary storage for formula
     Array<std::string> formulae, tformulae;
 
@@ -1614,6 +1777,9 @@ namespace CASM {
 
         formulae = tree[np][no].orbit_function_cpp_strings(labelers);
         tlf = formulae.size();
+        for(Index nf = 0; nf < formulae.size(); nf++) {
+          orbit_formulae[lf + nf] = formulae[nf];
+        }
 
         make_newline = false;
         for(Index nf = 0; nf < formulae.size(); nf++) {
@@ -1628,6 +1794,32 @@ namespace CASM {
                            indent << "double " << class_name << "::" << orbit_method_names[lf + nf] << "() const{\n" <<
                            indent << "  return " << formulae[nf] << ";\n" <<
                            indent << "}\n";
+          end_bfunc_imp();
+        }
+        if(make_newline) {
+          bfunc_imp_stream << '\n';
+          private_def_stream << '\n';
+        }
+        make_newline = false;
+
+        // batch versions of the orbit functions, with configurations in the innermost loop
+        //   this must be done before the flower functions, which change the nlist_inds of the cluster
+        formulae = tree[np][no].orbit_function_cpp_strings(batch_labelers);
+        for(Index nf = 0; nf < formulae.size(); nf++) {
+          if(!formulae[nf].size())
+            continue;
+          make_newline = true;
+          orbit_batch_method_names[lf + nf] = "eval_batch_bfunc_" + std::to_string(np) + "_" + std::to_string(no) + "_" + std::to_string(nf);
+          private_def_stream <<
+                             indent << "  void " << orbit_batch_method_names[lf + nf] << "(double *corr_k) const;\n";
+
+          bfunc_imp_stream <<
+                           indent << "void " << class_name << "::" << orbit_batch_method_names[lf + nf] << "(double *corr_k) const{\n" <<
+                           indent << "  for(size_type k=0; k<m_batch_size; k++){\n" <<
+                           indent << "    corr_k[k] += " << formulae[nf] << ";\n" <<
+                           indent << "  }\n" <<
+                           indent << "}\n";
+          end_bfunc_imp();
         }
         if(make_newline) {
           bfunc_imp_stream << '\n';
@@ -1650,6 +1842,7 @@ namespace CASM {
                              indent << "double " << class_name << "::" << flower_method_names[nb][lf + nf] << "() const{\n" <<
                              indent << "  return " << formulae[nf] << ";\n" <<
                              indent << "}\n";
+            end_bfunc_imp();
 
             //dflower_method_names[nb][lf + nf].resize(prim.basis[nb].occupant_basis().size());
           }
@@ -1684,6 +1877,7 @@ namespace CASM {
             }
           }
           for(Index nf = 0; nf < formulae.size(); nf++) {
+            dflower_formulae[nb][lf + nf] = formulae[nf];
             if(!formulae[nf].size())
               continue;
             make_newline = true;
@@ -1696,6 +1890,7 @@ namespace CASM {
                              indent << "double " << class_name << "::" << dflower_method_names[nb][lf + nf] << "(int occ_i, int occ_f) const{\n" <<
                              indent << "  return " << formulae[nf] << ";\n" <<
                              indent << "}\n";
+            end_bfunc_imp();
           }
           if(make_newline) {
             bfunc_imp_stream << '\n';
@@ -1706,6 +1901,8 @@ namespace CASM {
         // \End Configuration specific part
 
         lf += tlf;
+
+        end_bfunc_imp();
       }
     }//Finished writing method definitions and implementations for basis functions
 
@@ -1713,6 +1910,151 @@ namespace CASM {
     for(Index nl = 0; nl < labelers.size(); nl++)
       delete labelers[nl];
     labelers.clear();
+    for(Index nl = 0; nl < batch_labelers.size(); nl++)
+      delete batch_labelers[nl];
+    batch_labelers.clear();
+
+    // Fused ECI kernels: one method for the energy of a unit cell, and one method per basis site for
+    //   the change in energy due to changing an occupant, instead of a method call per basis function.
+    //   Basis functions with zero ECI are left out.
+    Array<std::string> delta_energy_method_names;
+    std::stringstream fused_imp_stream;
+    if(eci) {
+      std::vector<ECIContainer::size_type> folded_index;
+      std::vector<double> folded_value;
+      for(Index i = 0; i < eci->eci_index_list().size(); i++) {
+        if(eci->eci_index_list()[i] >= N_corr) {
+          throw std::runtime_error("Error in print_clexulator: ECI index " + std::to_string(eci->eci_index_list()[i])
+                                   + " is out of range for a basis set with " + std::to_string(N_corr) + " basis functions");
+        }
+        if(eci->eci_list()[i] != 0.0) {
+          folded_index.push_back(eci->eci_index_list()[i]);
+          folded_value.push_back(eci->eci_list()[i]);
+        }
+      }
+
+      private_def_stream <<
+                         indent << "  // typedef for method pointers\n" <<
+                         indent << "  typedef double (" << class_name << "::*DeltaEnergyFuncPtr)(int, int) const;\n\n" <<
+
+                         indent << "  // array of pointers to member functions for calculating the change in energy at each basis site\n" <<
+                         indent << "  DeltaEnergyFuncPtr m_delta_energy_func_list[" << prim.basis.size() << "];\n\n";
+
+      public_def_stream <<
+                        indent << "  /// \\brief Number of ECI folded into calc_global_energy_contribution and calc_delta_point_energy\n" <<
+                        indent << "  size_type folded_eci_size() const override {\n" <<
+                        indent << "    return " << folded_index.size() << ";\n" <<
+                        indent << "  }\n\n" <<
+
+                        indent << "  /// \\brief Indices of the correlations of the folded ECI\n" <<
+                        indent << "  size_type const *folded_eci_index() const override;\n\n" <<
+
+                        indent << "  /// \\brief Values of the folded ECI\n" <<
+                        indent << "  double const *folded_eci_value() const override;\n\n" <<
+
+                        indent << "  /// \\brief Calculate contribution to the cluster expansion value from one unit cell, using the folded ECI\n" <<
+                        indent << "  double calc_global_energy_contribution() const override;\n\n" <<
+
+                        indent << "  /// \\brief Calculate the change in the cluster expansion value due to changing an occupant, using the folded ECI\n" <<
+                        indent << "  double calc_delta_point_energy(int b_index, int occ_i, int occ_f) const override;\n\n";
+
+      fused_imp_stream <<
+                       indent << "/// \\brief Indices of the correlations of the folded ECI\n" <<
+                       indent << "Clexulator_impl::Base::size_type const *" << class_name << "::folded_eci_index() const {\n";
+      if(folded_index.size()) {
+        fused_imp_stream <<
+                         indent << "  static const size_type index[] = {";
+        for(Index k = 0; k < folded_index.size(); k++) {
+          fused_imp_stream << (k ? ", " : "") << folded_index[k];
+        }
+        fused_imp_stream << "};\n" <<
+                         indent << "  return index;\n";
+      }
+      else {
+        fused_imp_stream <<
+                         indent << "  return nullptr;\n";
+      }
+      fused_imp_stream <<
+                       indent << "}\n\n" <<
+
+                       indent << "/// \\brief Values of the folded ECI\n" <<
+                       indent << "double const *" << class_name << "::folded_eci_value() const {\n";
+      if(folded_value.size()) {
+        fused_imp_stream <<
+                         indent << "  static const double value[] = {";
+        for(Index k = 0; k < folded_value.size(); k++) {
+          fused_imp_stream << (k ? ", " : "") << eci_literal(folded_value[k]);
+        }
+        fused_imp_stream << "};\n" <<
+                         indent << "  return value;\n";
+      }
+      else {
+        fused_imp_stream <<
+                         indent << "  return nullptr;\n";
+      }
+      fused_imp_stream <<
+                       indent << "}\n\n" <<
+
+                       indent << "/// \\brief Calculate the change in the cluster expansion value due to changing an occupant, using the folded ECI\n" <<
+                       indent << "double " << class_name << "::calc_delta_point_energy(int b_index, int occ_i, int occ_f) const {\n" <<
+                       indent << "  return (this->*m_delta_energy_func_list[b_index])(occ_i, occ_f);\n" <<
+                       indent << "}\n\n";
+
+      // sum of eci*formula over the folded ECI, with one term per line
+      auto fused_expr = [&](const Array<std::string> &func_formulae) {
+        std::string expr;
+        for(Index k = 0; k < folded_index.size(); k++) {
+          const std::string &formula = func_formulae[folded_index[k]];
+          if(!formula.size())
+            continue;
+          if(expr.size())
+            expr += "\n" + indent + "    + ";
+          expr += eci_literal(folded_value[k]) + " * (" + formula + ")";
+        }
+        return expr.size() ? expr : std::string("0.0");
+      };
+
+      std::stringstream decl_stream;
+      std::string expr = hoist_occ_lookups(fused_expr(orbit_formulae), decl_stream, indent + "  ");
+      bfunc_imp_stream <<
+                       indent << "/// \\brief Calculate contribution to the cluster expansion value from one unit cell, using the folded ECI\n" <<
+                       indent << "double " << class_name << "::calc_global_energy_contribution() const {\n" <<
+                       decl_stream.str() <<
+                       indent << "  return " << expr << ";\n" <<
+                       indent << "}\n\n";
+      end_bfunc_imp();
+
+      delta_energy_method_names.resize(prim.basis.size());
+      for(Index nb = 0; nb < prim.basis.size(); nb++) {
+        expr = fused_expr(dflower_formulae[nb]);
+
+        // the change in each site basis function is shared by all the clusters
+        decl_stream.str("");
+        for(Index nsbf = 0; nsbf < prim.basis[nb].occupant_basis().size(); nsbf++) {
+          std::string func = "m_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf);
+          std::string delta_prefix = "(" + func + "[occ_f] - " + func + "[occ_i])";
+          std::string delta_var = "delta_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf);
+          if(expr.find(delta_prefix) == std::string::npos)
+            continue;
+          boost::replace_all(expr, delta_prefix, delta_var);
+          decl_stream <<
+                      indent << "  const double " << delta_var << " = " << func << "[occ_f] - " << func << "[occ_i];\n";
+        }
+        expr = hoist_occ_lookups(expr, decl_stream, indent + "  ");
+
+        delta_energy_method_names[nb] = "delta_energy_at_" + std::to_string(nb);
+        private_def_stream <<
+                           indent << "  double " << delta_energy_method_names[nb] << "(int occ_i, int occ_f) const;\n";
+
+        bfunc_imp_stream <<
+                         indent << "double " << class_name << "::" << delta_energy_method_names[nb] << "(int occ_i, int occ_f) const{\n" <<
+                         decl_stream.str() <<
+                         indent << "  return " << expr << ";\n" <<
+                         indent << "}\n\n";
+        end_bfunc_imp();
+      }
+      private_def_stream << '\n';
+    }
 
 
     // Write constructor
@@ -1732,6 +2074,16 @@ namespace CASM {
     }
     interface_imp_stream << "\n\n";
 
+    for(Index nf = 0; nf < orbit_batch_method_names.size(); nf++) {
+      if(orbit_batch_method_names[nf].size() == 0)
+        interface_imp_stream <<
+                             indent << "  m_orbit_batch_func_list[" << nf << "] = &" << class_name << "::zero_batch_func;\n";
+      else
+        interface_imp_stream <<
+                             indent << "  m_orbit_batch_func_list[" << nf << "] = &" << class_name << "::" << orbit_batch_method_names[nf] << ";\n";
+    }
+    interface_imp_stream << "\n\n";
+
     for(Index nb = 0; nb < flower_method_names.size(); nb++) {
       for(Index nf = 0; nf < flower_method_names[nb].size(); nf++) {
         if(flower_method_names[nb][nf].size() == 0)
@@ -1755,6 +2107,13 @@ namespace CASM {
       }
       interface_imp_stream << "\n\n";
     }
+
+    for(Index nb = 0; nb < delta_energy_method_names.size(); nb++) {
+      interface_imp_stream <<
+                           indent << "  m_delta_energy_func_list[" << nb << "] = &" << class_name << "::" << delta_energy_method_names[nb] << ";\n";
+    }
+    if(delta_energy_method_names.size())
+      interface_imp_stream << "\n\n";
     interface_imp_stream <<
                          indent << "}\n\n";
 
@@ -1784,6 +2143,25 @@ namespace CASM {
                          indent << "  }\n" <<
                          indent << "}\n\n" <<
 
+                         indent << "/// \\brief Calculate global correlations for a batch of configurations of the same supercell\n" <<
+                         indent << "void " << class_name << "::calc_global_corr_batch(const int *occ_begin, size_type N_config, size_type N_site, const long int *nlist_begin, size_type N_unitcell, double *corr_begin) {\n" <<
+                         indent << "  // batch_corr[i*N_config + k] is correlation 'i' of configuration 'k'\n" <<
+                         indent << "  std::vector<double> batch_corr(corr_size()*N_config, 0.0);\n" <<
+                         indent << "  m_batch_occ_ptr = occ_begin;\n" <<
+                         indent << "  m_batch_size = N_config;\n" <<
+                         indent << "  for(size_type v=0; v<N_unitcell; v++){\n" <<
+                         indent << "    m_batch_nlist_ptr = nlist_begin + v*nlist_size();\n" <<
+                         indent << "    for(size_type i=0; i<corr_size(); i++){\n" <<
+                         indent << "      (this->*m_orbit_batch_func_list[i])(&batch_corr[i*N_config]);\n" <<
+                         indent << "    }\n" <<
+                         indent << "  }\n" <<
+                         indent << "  for(size_type k=0; k<N_config; k++){\n" <<
+                         indent << "    for(size_type i=0; i<corr_size(); i++){\n" <<
+                         indent << "      *(corr_begin + k*corr_size() + i) = batch_corr[i*N_config + k]/((double) N_unitcell);\n" <<
+                         indent << "    }\n" <<
+                         indent << "  }\n" <<
+                         indent << "}\n\n" <<
+
                          indent << "/// \\brief Calculate point correlations about basis site 'b_index'\n" <<
                          indent << "void " << class_name << "::calc_point_corr(int b_index, double *corr_begin) const {\n" <<
                          indent << "  for(size_type i=0; i<corr_size(); i++){\n" <<
@@ -1812,12 +2190,45 @@ namespace CASM {
                          indent << "  }\n" <<
                          indent << "}\n\n";
 
+    interface_imp_stream << fused_imp_stream.str();
+
+
+    // Split the basis function implementations into translation units that RuntimeLibrary
+    //   compiles in parallel. Translation unit 0 has everything else.
+    Index bfunc_size = 0;
+    for(const std::string &imp : bfunc_imp) {
+      bfunc_size += imp.size();
+    }
+    Index N_bfunc_unit = std::min(Index(clexulator_max_translation_units - 1), bfunc_size / clexulator_translation_unit_size);
+
+    std::vector<std::string> unit_imp(N_bfunc_unit + 1);
+    Index unit_size = 0;
+    for(const std::string &imp : bfunc_imp) {
+      Index unit = N_bfunc_unit ? 1 + std::min(N_bfunc_unit - 1, unit_size * N_bfunc_unit / bfunc_size) : 0;
+      unit_imp[unit] += imp;
+      unit_size += imp.size();
+    }
+    unit_imp[0] = interface_imp_stream.str() + unit_imp[0];
+
+    auto unit_begin = [&](Index unit) {
+      return N_bfunc_unit ? "#if !defined(CASM_TRANSLATION_UNIT) || CASM_TRANSLATION_UNIT == " + std::to_string(unit) + "\n" : std::string();
+    };
+    auto unit_end = [&]() {
+      return N_bfunc_unit ? std::string("#endif\n\n") : std::string();
+    };
 
     // PUT EVERYTHING TOGETHER
     stream <<
            "#include <cstddef>\n" <<
            "#include \"casm/clex/Clexulator.hh\"\n" <<
-           "\n\n\n" <<
+           "\n";
+    if(N_bfunc_unit) {
+      stream <<
+             "// Compiled as separate translation units by RuntimeLibrary, or all at once if CASM_TRANSLATION_UNIT is not defined\n" <<
+             "#define CASM_NUM_TRANSLATION_UNITS " << N_bfunc_unit + 1 << "\n";
+    }
+    stream <<
+           "\n\n" <<
            "/****** CLEXULATOR CLASS FOR PRIM ******" << std::endl;
 
     prim.print(stream);
@@ -1843,18 +2254,23 @@ namespace CASM {
 
            indent <<
 
-           "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n" <<
+           "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n";
 
-           interface_imp_stream.str() <<
-           bfunc_imp_stream.str() <<
+    for(Index unit = 0; unit < unit_imp.size(); unit++) {
+      stream << unit_begin(unit) << unit_imp[unit] << unit_end();
+    }
+
+    stream <<
            "}\n\n\n" <<      // close namespace
 
+           unit_begin(0) <<
            "extern \"C\" {\n" <<
            indent << "/// \\brief Returns a Clexulator_impl::Base* owning a " << class_name << "\n" <<
            indent << "CASM::Clexulator_impl::Base* make_" + class_name << "() {\n" <<
            indent << "  return new CASM::" + class_name + "();\n" <<
            indent << "}\n\n" <<
            "}\n" <<
+           unit_end() <<
 
            "\n";
     // EOF
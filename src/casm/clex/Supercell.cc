@@ -1,7 +1,10 @@
 #include "casm/clex/Supercell.hh"
 
 #include <math.h>
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <stdlib.h>
 
@@ -12,6 +15,8 @@
 #include "casm/clex/ConfigEnumAllOccupations.hh"
 #include "casm/clex/ConfigEnumInterpolation.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/clex/ConfigDatabase.hh"
+#include "casm/clex/ConfigCanonicalizer.hh"
 
 namespace CASM {
 
@@ -27,23 +32,60 @@ namespace CASM {
   // ARN 082513
   /*****************************************************************/
 
+  namespace {
+
+    /// Neighbor tables shared by Supercells with the same PrimClex, transformation matrix, and
+    /// neighborhood. Entries expire with the last Supercell using them.
+    std::mutex nlist_cache_mutex;
+    std::map<std::vector<long int>, std::weak_ptr<const std::vector<long int> > > nlist_cache;
+
+  }
+
   void Supercell::generate_neighbor_list() {
 
-    nlists.resize(num_sites());
+    m_nlist_size = get_primclex().get_nlist_size();
 
-    //Use the bijk->l map to populate the linear index
-    for(Index i = 0; i < num_sites(); i++) {
+    std::vector<long int> key;
+    key.push_back(reinterpret_cast<std::intptr_t>(primclex));
+    for(Index i = 0; i < 3; i++) {
+      for(Index j = 0; j < 3; j++) {
+        key.push_back(transf_mat(i, j));
+      }
+    }
+    for(Index j = 0; j < m_nlist_size; j++) {
+      const UnitCellCoord &delta = get_primclex().get_nlist_uccoord(j);
+      key.insert(key.end(), {delta[0], delta[1], delta[2], delta[3]});
+    }
 
-      nlists[i].resize(get_primclex().get_nlist_size());
+    std::unique_lock<std::mutex> lock(nlist_cache_mutex);
+    auto it = nlist_cache.find(key);
+    if(it != nlist_cache.end() && (m_nlist = it->second.lock())) {
+      return;
+    }
 
-      for(Index j = 0; j < nlists[i].size(); j++) {
+    //Use the bijk->l map to populate the linear index
+    std::shared_ptr<std::vector<long int> > nlist = std::make_shared<std::vector<long int> >(num_sites() * m_nlist_size);
+    for(Index i = 0; i < num_sites(); i++) {
+      for(Index j = 0; j < m_nlist_size; j++) {
 
         const UnitCellCoord &delta = get_primclex().get_nlist_uccoord(j);
 
-        nlists[i][j] = find(uccoord(i) + delta);
+        (*nlist)[i * m_nlist_size + j] = find(uccoord(i) + delta);
 
       }
     }
+    m_nlist = nlist;
+
+    // drop expired entries, then remember this one
+    for(auto expired = nlist_cache.begin(); expired != nlist_cache.end();) {
+      if(expired->second.expired()) {
+        expired = nlist_cache.erase(expired);
+      }
+      else {
+        ++expired;
+      }
+    }
+    nlist_cache[key] = m_nlist;
 
     return;
   }
@@ -69,7 +111,8 @@ namespace CASM {
       //loop over the first N sites in the list of site i and check for repeated values
       for(Index j = 0; j < basis_size(); j++) {
         //if the neighbor appears more than once, then you have periodicity issues
-        if(nlists[i].reverse_find(nlists[i][j]) != j) {
+        const long int *nlist = get_nlist(i);
+        if(std::find(nlist + j + 1, nlist + m_nlist_size, nlist[j]) != nlist + m_nlist_size) {
           return true;
         }
       }
@@ -210,9 +253,9 @@ namespace CASM {
 
   /*****************************************************************/
 
-  // permutation_symrep() populates permutation symrep if needed
+  // grid_permute() constructs the permutation if needed
   const Permutation &Supercell::factor_group_permute(Index i) const {
-    return *(permutation_symrep()->get_permutation(factor_group()[i]));
+    return grid_permute().factor_group_permute(i);
   }
   /*****************************************************************/
 
@@ -235,20 +278,34 @@ namespace CASM {
    *  ConfigDoF my_dof=my_config.configdof();
    *  my_dof.is_canonical(my_supercell.permute_begin(),my_supercell.permute_end());
    */
+  const PrimGridPermute &Supercell::grid_permute() const {
+    return m_grid_permute.get([&]() {
+      return std::make_shared<PrimGridPermute>(m_prim_grid, factor_group(), get_prim().basis_permutation_symrep_ID());
+    });
+  }
+
+  /*****************************************************************/
+
   Supercell::permute_const_iterator Supercell::permute_begin() const {
-    return permute_const_iterator(SymGroupRep::RemoteHandle(this->factor_group(), this->permutation_symrep_ID()),
-                                  m_prim_grid,
+    return permute_const_iterator(grid_permute(),
                                   0, 0); // starting indices
   }
 
   /*****************************************************************/
 
   Supercell::permute_const_iterator Supercell::permute_end() const {
-    return permute_const_iterator(SymGroupRep::RemoteHandle(factor_group(), permutation_symrep_ID()),
-                                  m_prim_grid,
+    return permute_const_iterator(grid_permute(),
                                   factor_group().size(), 0); // one past final indices
   }
 
+  /*****************************************************************/
+
+  const ConfigCanonicalizer &Supercell::canonicalizer() const {
+    return m_canonicalizer.get([&]() {
+      return std::make_shared<ConfigCanonicalizer>(permute_begin(), permute_end());
+    });
+  }
+
 
   /*****************************************************************/
 
@@ -282,13 +339,11 @@ namespace CASM {
 
       bool add = true;
       if(N_existing_enumerated != N_existing) {
-        for(Index i = 0; i < N_existing; i++) {
-          if(config_list[i].configdof() == it_begin->configdof()) {
-            config_list[i].push_back_source(it_begin.source());
-            add = false;
-            N_existing_enumerated++;
-            break;
-          }
+        Index i;
+        if(contains_config(*it_begin, i) && i < N_existing) {
+          config_list[i].push_back_source(it_begin.source());
+          add = false;
+          N_existing_enumerated++;
         }
       }
       if(add) {
@@ -296,6 +351,7 @@ namespace CASM {
         // get source info from enumerator
         config_list.back().set_source(it_begin.source());
         config_list.back().set_id(config_list.size() - 1);
+        _index_config(config_list.size() - 1);
       }
     }
 
@@ -653,16 +709,21 @@ namespace CASM {
    *     Does not check for symmetrically equivalent Configurations, so put your
    *     'config' in canonical form first.
    *
+   *   Candidates are looked up by hash_value(ConfigDoF) in m_config_index, so
+   *     only Configurations with the same occupation are compared.
+   *
    *   If equivalent found, 'index' contains it's index into config_list, else
    *     'index' = config_list.size().
    */
   //*******************************************************************************
   bool Supercell::contains_config(const Configuration &config, Index &index) const {
-    for(Index i = 0; i < config_list.size(); i++)
-      if(config.configdof() == config_list[i].configdof()) {
-        index = i;
+    auto range = m_config_index.equal_range(hash_value(config.configdof()));
+    for(auto it = range.first; it != range.second; ++it) {
+      if(config.configdof() == config_list[it->second].configdof()) {
+        index = it->second;
         return true;
       }
+    }
 
     index = config_list.size();
     return false;
@@ -711,6 +772,7 @@ namespace CASM {
       //std::cout << "new config" << std::endl;
       config_list.push_back(canon_config);
       config_list.back().set_id(config_list.size() - 1);
+      _index_config(config_list.size() - 1);
       return true;
       //std::cout << "    added" << std::endl;
     }
@@ -749,10 +811,46 @@ namespace CASM {
         config_list.push_back(Configuration(json, *this, configid));
       }
       else {
-        return;
+        break;
       }
       configid++;
     }
+
+    rebuild_config_index();
+  }
+
+  //*******************************************************************************
+
+  void Supercell::read_config_list(const ConfigDatabase &db) {
+
+    // Provide an error check
+    if(config_list.size() != 0) {
+      std::cerr << "Error in Supercell::read_configuration." << std::endl;
+      std::cerr << "  config_list.size() != 0, only use this once" << std::endl;
+      exit(1);
+    }
+
+    for(Index configid = 0; configid < db.size(get_name()); configid++) {
+      config_list.push_back(db.configuration(*this, configid));
+    }
+
+    rebuild_config_index();
+  }
+
+  //*******************************************************************************
+
+  void Supercell::rebuild_config_index() {
+    m_config_index.clear();
+    m_config_index.reserve(config_list.size());
+    for(Index i = 0; i < config_list.size(); i++) {
+      _index_config(i);
+    }
+  }
+
+  //*******************************************************************************
+
+  void Supercell::_index_config(Index index) {
+    m_config_index.insert(std::make_pair(hash_value(config_list[index].configdof()), index));
   }
 
 
@@ -767,8 +865,10 @@ namespace CASM {
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
     m_perm_symrep_ID(-1),
     name(RHS.name),
-    nlists(RHS.nlists),
+    m_nlist(RHS.m_nlist),
+    m_nlist_size(RHS.m_nlist_size),
     config_list(RHS.config_list),
+    m_config_index(RHS.m_config_index),
     transf_mat(RHS.transf_mat),
     scaling(RHS.scaling),
     m_id(RHS.m_id) {
@@ -783,6 +883,7 @@ namespace CASM {
     m_prim_grid((*primclex).get_prim().lattice(), real_super_lattice, (*primclex).get_prim().basis.size()),
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
     m_perm_symrep_ID(-1),
+    m_nlist_size(0),
     transf_mat(transf_mat_init) {
     scaling = 1.0;
     generate_name();
@@ -799,6 +900,7 @@ namespace CASM {
     m_prim_grid((*primclex).get_prim().lattice(), real_super_lattice, (*primclex).get_prim().basis.size()),
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
     m_perm_symrep_ID(-1),
+    m_nlist_size(0),
     transf_mat(primclex->calc_transf_mat(superlattice)) {
     /*std::cerr << "IN SUPERCELL CONSTRUCTOR:\n"
               << "transf_mat is\n" << transf_mat << '\n'
@@ -922,6 +1024,14 @@ namespace CASM {
     return json;
   }
 
+  //*******************************************************************************
+
+  void Supercell::write_config_list(ConfigDatabase &db) {
+    for(Index c = 0; c < config_list.size(); c++) {
+      db.insert(config_list[c]);
+    }
+  }
+
 
   //*******************************************************************************
 
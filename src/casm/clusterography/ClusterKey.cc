@@ -0,0 +1,95 @@
+#include "casm/clusterography/ClusterKey.hh"
+
+#include <algorithm>
+#include <functional>
+
+#include "casm/crystallography/Structure.hh"
+
+namespace CASM {
+
+  namespace {
+
+    bool _ucc_less(const UnitCellCoord &A, const UnitCellCoord &B) {
+      return std::lexicographical_compare(A.coord, A.coord + 4, B.coord, B.coord + 4);
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  ClusterKey::ClusterKey(const std::vector<UnitCellCoord> &sites) {
+    std::vector<UnitCellCoord> sorted(sites);
+    std::sort(sorted.begin(), sorted.end(), _ucc_less);
+
+    m_key.reserve(4 * sorted.size());
+    for(const UnitCellCoord &ucc : sorted) {
+      m_key.push_back(ucc[0]);
+      for(int i = 1; i < 4; i++) {
+        m_key.push_back(ucc[i] - sorted[0][i]);
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  std::size_t ClusterKey::hash() const {
+    std::size_t result = m_key.size();
+    std::hash<long int> hasher;
+    for(long int value : m_key) {
+      result ^= hasher(value) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  FactorGroupSiteMap::FactorGroupSiteMap(const Structure &prim) :
+    m_basis_size(prim.basis.size()) {
+
+    const MasterSymGroup &group = prim.factor_group();
+    Index basis_permute_ID = prim.basis_permutation_symrep_ID();
+
+    for(Index ng = 0; ng < group.size(); ng++) {
+      SymOp op(group[ng]);
+      op.set_lattice(prim.lattice(), CART);
+      Matrix3<int> frac_ijk = round(op.get_matrix(FRAC));
+      for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+          m_rotation.push_back(frac_ijk(i, j));
+        }
+      }
+
+      Array<UnitCellCoord> const *b_permute = op.get_basis_permute_rep(basis_permute_ID);
+      if(!b_permute) {
+        std::cerr << "CRITICAL ERROR: In FactorGroupSiteMap, BasisPermute representation is incorrectly initialized!\n"
+                  << "                Exiting...\n";
+        exit(1);
+      }
+      m_basis_image.insert(m_basis_image.end(), b_permute->begin(), b_permute->end());
+    }
+  }
+
+  //*******************************************************************************************
+
+  UnitCellCoord FactorGroupSiteMap::apply(Index op, const UnitCellCoord &ucc) const {
+    const long int *R = &m_rotation[9 * op];
+    UnitCellCoord result = m_basis_image[op * m_basis_size + ucc[0]];
+    for(int i = 0; i < 3; i++) {
+      result[i + 1] += R[3 * i] * ucc[1] + R[3 * i + 1] * ucc[2] + R[3 * i + 2] * ucc[3];
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  void FactorGroupSiteMap::insert_orbit(const std::vector<UnitCellCoord> &sites, ClusterKeySet &keys) const {
+    std::vector<UnitCellCoord> image(sites.size());
+    for(Index op = 0; op < size(); op++) {
+      for(Index i = 0; i < sites.size(); i++) {
+        image[i] = apply(op, sites[i]);
+      }
+      keys.insert(ClusterKey(image));
+    }
+  }
+
+}
@@ -1,5 +1,8 @@
 #include "casm/crystallography/Lattice.hh"
 
+#include <map>
+#include <mutex>
+
 #include "casm/crystallography/SupercellEnumerator.hh"
 
 namespace CASM {
@@ -278,6 +281,110 @@ namespace CASM {
   }
   //********************************************************************
 
+  namespace {
+
+    /// \brief Integer matrices, in fractional coordinates of the reduced cell 'tlat_reduced', that may be
+    /// point group operations
+    ///
+    /// These are the matrices with elements equal to -1, 0, or 1 and determinant +/-1 that, as
+    /// operations, map the lattice vectors onto lattice vectors with nearly the same lengths and
+    /// angles. Each column, the image of a lattice vector, is chosen from the vectors of about the
+    /// right length, so only a few of the 3^9 matrices are checked.
+    ///
+    /// An operation that passes the test in Lattice::generate_point_group has metric
+    /// M^T*G*M - G = L^T*D, where G = L^T*L, L is the lattice column matrix, and each column of D is
+    /// shorter than 2*sqrt(3)*pg_tol. So |(M^T*G*M - G)(i, j)| < 2*sqrt(3)*pg_tol*min(|a_i|, |a_j|)
+    /// for such operations, which is checked here with some leeway.
+    ///
+    /// The matrices are returned in the order of Counter<Matrix3<int> >(-1, 1, 1).
+    std::vector<Matrix3<int> > _point_group_candidates(const Lattice &tlat_reduced, double pg_tol) {
+
+      Matrix3<double> G = tlat_reduced.lat_column_mat().transpose() * tlat_reduced.lat_column_mat();
+      double len[3];
+      for(int i = 0; i < 3; i++) {
+        len[i] = sqrt(G(i, i));
+      }
+      auto bound = [&](int i, int j) {
+        return 4.0 * pg_tol * std::min(len[i], len[j]) + 1e-8 * len[i] * len[j];
+      };
+      auto dot = [&](const Vector3<int> &u, const Vector3<int> &v) {
+        double result = 0.0;
+        for(int i = 0; i < 3; i++) {
+          for(int j = 0; j < 3; j++) {
+            result += u[i] * G(i, j) * v[j];
+          }
+        }
+        return result;
+      };
+
+      // images of each lattice vector
+      std::vector<Vector3<int> > image[3];
+      Vector3<int> v;
+      for(v[0] = -1; v[0] <= 1; v[0]++) {
+        for(v[1] = -1; v[1] <= 1; v[1]++) {
+          for(v[2] = -1; v[2] <= 1; v[2]++) {
+            double len2 = dot(v, v);
+            for(int i = 0; i < 3; i++) {
+              if(std::abs(len2 - G(i, i)) < bound(i, i)) {
+                image[i].push_back(v);
+              }
+            }
+          }
+        }
+      }
+
+      std::vector<Matrix3<int> > result;
+      Matrix3<int> M;
+      for(const Vector3<int> &v0 : image[0]) {
+        for(const Vector3<int> &v1 : image[1]) {
+          if(std::abs(dot(v0, v1) - G(0, 1)) >= bound(0, 1)) {
+            continue;
+          }
+          for(const Vector3<int> &v2 : image[2]) {
+            if(std::abs(dot(v0, v2) - G(0, 2)) >= bound(0, 2) || std::abs(dot(v1, v2) - G(1, 2)) >= bound(1, 2)) {
+              continue;
+            }
+            for(int i = 0; i < 3; i++) {
+              M(i, 0) = v0[i];
+              M(i, 1) = v1[i];
+              M(i, 2) = v2[i];
+            }
+            if(std::abs(M.determinant()) == 1) {
+              result.push_back(M);
+            }
+          }
+        }
+      }
+
+      // Counter increments element 0 first, so the last element is the most significant
+      std::sort(result.begin(), result.end(), [](const Matrix3<int> &A, const Matrix3<int> &B) {
+        for(int i = 8; i >= 0; i--) {
+          if(A[i] != B[i]) {
+            return A[i] < B[i];
+          }
+        }
+        return false;
+      });
+      return result;
+    }
+
+    /// Cartesian matrix and map error of each operation of the point groups that have been generated,
+    /// keyed by the lattice column matrix and tolerance
+    typedef std::map<std::vector<double>, std::vector<std::pair<Matrix3<double>, double> > > PointGroupCache;
+
+    std::mutex point_group_cache_mutex;
+    PointGroupCache point_group_cache;
+
+    /// The cache is cleared when it reaches this size, to bound memory use when enumerating
+    /// very many lattices
+    const Index max_point_group_cache_size = 10000;
+
+  }
+
+  //********************************************************************
+
+  /// The point group is cached for each set of lattice vectors and tolerance, so repeated calls for
+  /// the same lattice, such as for each Supercell of a PrimClex, only construct the SymOps
   void Lattice::generate_point_group(SymGroup &point_group, double pg_tol) const {
 
     if(point_group.size() != 0) {
@@ -286,28 +393,65 @@ namespace CASM {
       point_group.clear();
     }
 
-    //Enumerate all possible matrices with elements equal to -1, 0, or 1
+    std::vector<double> key;
+    for(Index i = 0; i < lat_column_mat().size(); i++) {
+      key.push_back(lat_column_mat()[i]);
+    }
+    key.push_back(pg_tol);
+
+    std::vector<std::pair<Matrix3<double>, double> > ops;
+    bool found;
+    {
+      std::lock_guard<std::mutex> lock(point_group_cache_mutex);
+      PointGroupCache::const_iterator it = point_group_cache.find(key);
+      found = (it != point_group_cache.end());
+      if(found) {
+        ops = it->second;
+      }
+    }
+
+    if(!found) {
+      SymGroup tgroup;
+      _generate_point_group(tgroup, pg_tol);
+      for(Index i = 0; i < tgroup.size(); i++) {
+        ops.push_back(std::make_pair(tgroup[i].get_matrix(CART), tgroup[i].get_map_error()));
+      }
+
+      std::lock_guard<std::mutex> lock(point_group_cache_mutex);
+      if(point_group_cache.size() >= max_point_group_cache_size) {
+        point_group_cache.clear();
+      }
+      point_group_cache[key] = ops;
+    }
+
+    for(Index i = 0; i < ops.size(); i++) {
+      point_group.push_back(SymOp(ops[i].first, *this, CART, ops[i].second));
+      point_group.back().get_sym_type();
+    }
+
+    return;
+  }
+
+  //********************************************************************
+
+  void Lattice::_generate_point_group(SymGroup &point_group, double pg_tol) const {
+
+    //Check the matrices with elements equal to -1, 0, or 1 that may be point group operations
     //These represent operations that reorder lattice vectors or replace one
     //or more lattice vectors with a face or body diagonal.
     Matrix3<double> tMat, tOp_cart;
-    Counter<Matrix3<int> > pg_count(Matrix3<int>(-1),
-                                    Matrix3<int>(1),
-                                    Matrix3<int>(1));
 
     //For this algorithm to work, lattice needs to be in reduced form.
     Lattice tlat_reduced(get_reduced_cell());
-    do {
-
-      //continue if determinant is not 1, because it doesn't preserve volume
-      if(std::abs(pg_count().determinant()) != 1) continue;
+    for(const Matrix3<int> &pg_op : _point_group_candidates(tlat_reduced, pg_tol)) {
 
-      tOp_cart = (tlat_reduced.coord_trans_mat[FRAC] * pg_count()) * tlat_reduced.coord_trans_mat[CART];
+      tOp_cart = (tlat_reduced.coord_trans_mat[FRAC] * pg_op) * tlat_reduced.coord_trans_mat[CART];
 
       //Find the effect of applying symmetry to the lattice vectors
       //The following is equivalent to point_group[i].get_matrix(CART).transpose()*tlat_reduced.coord_trans_mat[FRAC]*point_group[i].get_matrix(FRAC)
-      tMat = tOp_cart.transpose() * (tlat_reduced.coord_trans_mat[FRAC] * pg_count());
+      tMat = tOp_cart.transpose() * (tlat_reduced.coord_trans_mat[FRAC] * pg_op);
 
-      //If pg_count() is a point_group operation, tMat should be equal to tlat_reduced.coord_trans_mat[FRAC].  We check by first taking the difference...
+      //If pg_op is a point_group operation, tMat should be equal to tlat_reduced.coord_trans_mat[FRAC].  We check by first taking the difference...
       tMat = (tMat - tlat_reduced.coord_trans_mat[FRAC]) / 2.0;
 
       //... and then multiplying by the transpose...
@@ -324,16 +468,7 @@ namespace CASM {
 
         point_group.push_back(SymOp(tOp_cart, *this, CART, sqrt(diags.max())));
       }
-
-      /*** Old way of checking pg_count()
-
-      if(tOp_cart.is_unitary(pg_tol)) {
-      point_group.push_back(SymOp(tOp_cart, *this, CART));
-      point_group.back().get_sym_type();
-      }
-      **/
     }
-    while(++pg_count);
 
     if(!point_group.is_group(pg_tol)) {
       std::cerr << "*** WARNING *** \n"
@@ -347,10 +482,6 @@ namespace CASM {
     //Sort point_group by trace/conjugacy class
     point_group.sort_by_class();
 
-    for(Index i = 0; i < point_group.size(); i++) {
-      point_group[i].get_sym_type();
-    }
-
     return;
   }
 
@@ -0,0 +1,86 @@
+#include "casm/crystallography/PeriodicCellList.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "casm/crystallography/Lattice.hh"
+
+namespace CASM {
+
+  PeriodicCellList::PeriodicCellList(const Lattice &lat, const std::vector<Vector3<double> > &frac, double radius) {
+
+    // don't use more cells than needed for a few points per cell
+    int max_n = std::max(1, int(std::ceil(2.0 * std::cbrt(double(frac.size())))));
+
+    // a displacement of 'radius' changes fractional coordinate i by at most radius * |row i of inverse lattice|
+    const Matrix3<double> &inv_lat = lat.coord_trans(CART);
+    for(int i = 0; i < 3; i++) {
+      double frac_radius = 1.01 * radius * std::sqrt(inv_lat(i, 0) * inv_lat(i, 0) + inv_lat(i, 1) * inv_lat(i, 1) + inv_lat(i, 2) * inv_lat(i, 2));
+      m_n[i] = max_n;
+      if(frac_radius > 0.0 && 1.0 / frac_radius < max_n) {
+        m_n[i] = std::max(1, int(std::floor(1.0 / frac_radius)));
+      }
+    }
+
+    // counting sort of the points by cell
+    std::vector<Index> cell(frac.size());
+    m_cell_begin.assign(m_n[0] * m_n[1] * m_n[2] + 1, 0);
+    for(Index p = 0; p < frac.size(); p++) {
+      Vector3<int> c = _cell(frac[p]);
+      cell[p] = _linear(c[0], c[1], c[2]);
+      m_cell_begin[cell[p] + 1]++;
+    }
+    for(Index c = 1; c < m_cell_begin.size(); c++) {
+      m_cell_begin[c] += m_cell_begin[c - 1];
+    }
+    m_index.resize(frac.size());
+    std::vector<Index> next(m_cell_begin.begin(), m_cell_begin.end() - 1);
+    for(Index p = 0; p < frac.size(); p++) {
+      m_index[next[cell[p]]++] = p;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicCellList::near(const Vector3<double> &frac, std::vector<Index> &result) const {
+    result.clear();
+
+    // cells to check along each lattice vector
+    Vector3<int> c = _cell(frac);
+    std::vector<int> range[3];
+    for(int i = 0; i < 3; i++) {
+      if(m_n[i] < 3) {
+        for(int j = 0; j < m_n[i]; j++) {
+          range[i].push_back(j);
+        }
+      }
+      else {
+        for(int j = -1; j <= 1; j++) {
+          range[i].push_back((c[i] + j + m_n[i]) % m_n[i]);
+        }
+      }
+    }
+
+    for(int i : range[0]) {
+      for(int j : range[1]) {
+        for(int k : range[2]) {
+          Index l = _linear(i, j, k);
+          result.insert(result.end(), m_index.begin() + m_cell_begin[l], m_index.begin() + m_cell_begin[l + 1]);
+        }
+      }
+    }
+    std::sort(result.begin(), result.end());
+  }
+
+  //*******************************************************************************************
+
+  Vector3<int> PeriodicCellList::_cell(const Vector3<double> &frac) const {
+    Vector3<int> result;
+    for(int i = 0; i < 3; i++) {
+      double f = frac[i] - std::floor(frac[i]);
+      result[i] = std::min(m_n[i] - 1, std::max(0, int(std::floor(f * m_n[i]))));
+    }
+    return result;
+  }
+
+}
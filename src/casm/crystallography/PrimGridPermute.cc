@@ -0,0 +1,150 @@
+#include "casm/crystallography/PrimGridPermute.hh"
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
+#include "casm/symmetry/SymGroup.hh"
+
+namespace CASM {
+
+  PrimGridPermute::PrimGridPermute(const PrimGrid &prim_grid, const SymGroup &group, Index basis_permute_ID) :
+    m_prim_grid(&prim_grid),
+    m_group(&group),
+    m_vol(prim_grid.size()),
+    m_fg_permute(group.size()) {
+
+    for(int i = 0; i < 3; i++) {
+      m_S[i] = prim_grid.S(i);
+    }
+    m_NB = 0;
+
+    for(Index ng = 0; ng < group.size(); ng++) {
+      SymOp op(group[ng]);
+      op.set_lattice(prim_grid.prim_lattice(), CART);
+
+      Array<UnitCellCoord> const *b_permute = op.get_basis_permute_rep(basis_permute_ID);
+      if(!b_permute) {
+        std::cerr << "CRITICAL ERROR: In PrimGridPermute::PrimGridPermute, BasisPermute representation is incorrectly initialized!\n"
+                  << "                basis_permute_ID is " << basis_permute_ID << " and op index is " << op.index() << '\n'
+                  << "                Exiting...\n";
+        exit(1);
+      }
+      m_NB = b_permute->size();
+
+      // As in PrimGrid::make_permutation_representation, the operation takes the site at (nb, mnp)
+      // to (b_permute[nb][0], frac_mnp*mnp + shift(nb)), so the site at (b, mnp) came from
+      // (nb, F*(mnp - shift(nb))), with F the inverse of frac_mnp
+      Matrix3<int> frac_ijk = round(op.get_matrix(FRAC));
+      Matrix3<int> frac_mnp = prim_grid.invU() * frac_ijk * prim_grid.matrixU();
+      Matrix3<int> F = frac_mnp.inverse();
+      for(int r = 0; r < 3; r++) {
+        for(int c = 0; c < 3; c++) {
+          F(r, c) = ((F(r, c) % m_S[r]) + m_S[r]) % m_S[r];
+        }
+      }
+      m_F.push_back(F);
+
+      Index sublat_begin = m_sublat.size();
+      m_sublat.resize(sublat_begin + m_NB);
+      m_shift.resize(3 * (sublat_begin + m_NB));
+      for(Index nb = 0; nb < m_NB; nb++) {
+        const UnitCellCoord &bijk = b_permute->at(nb);
+        Index b = bijk[0];
+        m_sublat[sublat_begin + b] = nb;
+
+        Vector3<int> shift;
+        for(int r = 0; r < 3; r++) {
+          long int sum = 0;
+          for(int c = 0; c < 3; c++) {
+            sum += long(prim_grid.invU()(r, c)) * bijk[c + 1];
+          }
+          shift[r] = ((sum % m_S[r]) + m_S[r]) % m_S[r];
+        }
+
+        for(int r = 0; r < 3; r++) {
+          long int sum = 0;
+          for(int c = 0; c < 3; c++) {
+            sum -= long(F(r, c)) * shift[c];
+          }
+          m_shift[3 * (sublat_begin + b) + r] = ((sum % m_S[r]) + m_S[r]) % m_S[r];
+        }
+      }
+    }
+
+    m_N = m_NB * m_vol;
+  }
+
+  //*******************************************************************************************
+
+  Index PrimGridPermute::permute_ind(Index f, Index t, Index i) const {
+    Index b = i / m_vol;
+    int mnp[3], mnp_t[3];
+    _mnp(i % m_vol, mnp);
+    _mnp(t, mnp_t);
+
+    const Matrix3<int> &F = m_F[f];
+    int y[3];
+    for(int r = 0; r < 3; r++) {
+      long int sum = m_shift[3 * (f * m_NB + b) + r];
+      for(int c = 0; c < 3; c++) {
+        sum += long(F(r, c)) * (mnp[c] - mnp_t[c]);
+      }
+      y[r] = ((sum % m_S[r]) + m_S[r]) % m_S[r];
+    }
+    return m_sublat[f * m_NB + b] * m_vol + y[0] + m_S[0] * (y[1] + m_S[1] * Index(y[2]));
+  }
+
+  //*******************************************************************************************
+
+  void PrimGridPermute::permute_ind_block(Index f, Index t, Index begin, Index end, Index *result) const {
+    _for_each(f, t, begin, end, [&](Index i, Index source) {
+      result[i - begin] = source;
+    });
+  }
+
+  //*******************************************************************************************
+
+  Permutation PrimGridPermute::permutation(Index f, Index t) const {
+    Array<Index> perm_array(m_N);
+    permute_ind_block(f, t, 0, m_N, perm_array.begin());
+    return Permutation(perm_array);
+  }
+
+  //*******************************************************************************************
+
+  const Permutation &PrimGridPermute::factor_group_permute(Index f) const {
+    std::lock_guard<std::mutex> lock(m_fg_permute_mutex);
+    if(!m_fg_permute[f]) {
+      m_fg_permute[f].reset(new Permutation(permutation(f, 0)));
+    }
+    return *m_fg_permute[f];
+  }
+
+  //*******************************************************************************************
+
+  /// Translation 't' takes the site at mnp to mnp + mnp(t), as in PrimGrid::make_translation_permutations,
+  /// so combined with operation f the site at (b, mnp) came from
+  /// (m_sublat[f*m_NB + b], F*(mnp - mnp(t)) + m_shift(f, b)). Only -F*mnp(t) depends on t.
+  PrimGridPermute::AffineOp PrimGridPermute::_affine_op(Index f, Index t) const {
+    AffineOp op;
+    const Matrix3<int> &F = m_F[f];
+    for(int r = 0; r < 3; r++) {
+      for(int c = 0; c < 3; c++) {
+        op.F[r][c] = F(r, c);
+      }
+    }
+
+    int mnp_t[3];
+    _mnp(t, mnp_t);
+
+    for(int r = 0; r < 3; r++) {
+      long int sum = 0;
+      for(int c = 0; c < 3; c++) {
+        sum -= long(op.F[r][c]) * mnp_t[c];
+      }
+      op.shift_t[r] = ((sum % m_S[r]) + m_S[r]) % m_S[r];
+    }
+    return op;
+  }
+
+}
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "casm/hull/GeometryPieces.hh"
+#include "casm/hull/HullCache.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/ConfigSelection.hh"
 #include "casm/clex/ConfigIterator.hh"
@@ -40,6 +41,7 @@ namespace CASM {
   jsonParser update_hull_props(PrimClex &primclex,
                                ConfigSelectionIterator<false, false> begin,
                                ConfigSelectionIterator<false, false> end,
+                               const std::string &selection,
                                double geo_tol) {
 
     //Return this
@@ -48,21 +50,26 @@ namespace CASM {
     //some energies might not be set. We keep track of the configurations that have relaxed_energy
     std::vector<ConfigSelectionIterator<false, false> > valid_config;
 
-    BP::Geo hull;
-
     //We should have the tolerance set in .casmroot
     //std::cerr << "WARNING in PrimClex::update_hull_props" << std::endl;
     //std::cerr << "Setting hull tolerance to 0.5meV. This might not be what you want!" << std::endl;
 
-    //hull.set_Geo_tol(geo_tol);
-    bool hull_found = populate_convex_hull(hull, begin, end, std::back_inserter(valid_config));
+    Eigen::MatrixXd enercomps = hull_points(begin, end, std::back_inserter(valid_config));
 
-    //All configurations have the same size parametric composition vector (right?). +1 for the energy row.
-    Index rows = begin->get_param_composition().size() + 1;
     //The columns correspond to the number of configurations;
     Index cols = valid_config.size();
 
-    BP::BP_Vec<int> hull_indices;     //Perhaps we can generalize BP_Vec into a CASM::stable_array?
+    std::vector<std::string> names;
+    for(Index i = 0; i < cols; i++) {
+      names.push_back(valid_config[i].name());
+    }
+
+    //The hull from the last update is brought up to date, and only rebuilt if the new or changed
+    //configurations change it
+    HullCache cache;
+    fs::path cache_file = primclex.dir().hull_cache(primclex.get_curr_calctype(), primclex.get_curr_ref(), selection);
+    cache.read(cache_file);
+    bool hull_found = cache.update(names, enercomps);
 
     if(hull_found) {
 
@@ -72,32 +79,25 @@ namespace CASM {
         it->clear_hull_data();
       }
 
-      //Set value to -1 to only get bottom of hull. It's what happens in EnergySet::calc_hull
-      Eigen::VectorXd bottom_vector = Eigen::VectorXd::Zero(rows);
-      bottom_vector(0) = -1;
-      hull.CH_bottom(bottom_vector);
-      hull_indices = hull.CH_verts_indices();
+      //The hull of just the hull vertices, with the bottom already selected as in EnergySet::calc_hull
+      std::vector<Index> geo_index;
+      BP::Geo &hull = cache.geo(geo_index);
+      BP::BP_Vec<int> hull_indices = hull.CH_verts_indices();
       hulljson = hull_data(hull);
 
+      //Add the config names to the jsonParser that has the hull info
+      for(Index v = 0; v < hull_indices.size(); v++) {
+        hulljson["vertices"][v]["name"] = valid_config[geo_index[hull_indices[v]]].name();
+      }
+
       //Go through the configurations and set delta properties for is_groundstate and dist_from_hull
       for(Index i = 0; i < cols; i++) {
+        valid_config[i]->set_hull_data(cache.is_vertex(i), cache.dist_to_hull(i));
+      }
 
-        //Determine if configuration i is groundstate or not
-        bool is_groundstate = false;
-        ulint vertex_col_index;
-
-        if(hull_indices.find_first(i, vertex_col_index)) {
-          is_groundstate = true;
-          //Add the config name to the jsonParser that has the hull info
-          hulljson["vertices"][vertex_col_index]["name"] = valid_config[i].name();
-
-        }
-
-        //Calculate distance from the hull for configuration i
-        double dist_from_hull = hull.CH_dist_to_hull(i);
-
-        //set distance from hull and whether it's a groundstate or not
-        valid_config[i]->set_hull_data(is_groundstate, dist_from_hull);
+      if(cache.changed()) {
+        cache.write(cache_file);
+        HullCache::prune(primclex.dir().hull_cache_dir(), HullCache::max_cached);
       }
     }
 
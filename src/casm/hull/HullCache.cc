@@ -0,0 +1,466 @@
+#include "casm/hull/HullCache.hh"
+
+#include <algorithm>
+#include <ctime>
+#include <stdexcept>
+
+#include "casm/casm_io/jsonParser.hh"
+
+namespace CASM {
+
+  namespace {
+
+    /// Points are treated as unchanged if no value differs by more than this. Values are written
+    /// with 17 decimal places, so this only absorbs the difference between a value and its
+    /// round trip through a cache file.
+    const double key_tol = 1e-12;
+
+    /// Distances are found for this many points at a time, to limit the size of the matrix of
+    /// facet energies
+    const Index batch_size = 4096;
+  }
+
+  HullCache::HullCache(double _tol) :
+    m_tol(_tol),
+    m_incremental(true),
+    m_rebuilt(false),
+    m_rebuild_size(0),
+    m_changed(false) {}
+
+  //*******************************************************************************************
+
+  /// Each point in '_points' is compared with the point of the same name in the cache. Points
+  /// that are new or changed are inserted without rebuilding the hull if they lie above it. The
+  /// hull is rebuilt from the current hull vertices and the new points that do not if necessary,
+  /// and from all points if a hull vertex was removed or changed.
+  bool HullCache::update(const std::vector<std::string> &_names, const Eigen::MatrixXd &_points) {
+    if(_names.size() != _points.cols()) {
+      throw std::runtime_error("Error in HullCache::update: " + std::to_string(_names.size()) + " names for "
+                               + std::to_string(_points.cols()) + " points");
+    }
+
+    Index N = _names.size();
+    std::map<std::string, Index> index;
+    for(Index i = 0; i < N; i++) {
+      if(!index.insert(std::make_pair(_names[i], i)).second) {
+        throw std::runtime_error("Error in HullCache::update: repeated name '" + _names[i] + "'");
+      }
+    }
+
+    m_rebuilt = false;
+    m_rebuild_size = 0;
+    m_changed = (N != size());
+
+    bool full = !m_incremental || facets_size() == 0 || _points.rows() != m_points.rows();
+
+    // find the unchanged points, and the old index of each
+    std::vector<Index> old_to_new(size(), -1);
+    std::vector<Index> inserted;
+    Eigen::VectorXd dist = Eigen::VectorXd::Zero(N);
+    for(Index i = 0; i < N; i++) {
+      auto it = m_index.find(_names[i]);
+      if(!full && it != m_index.end() &&
+         (m_points.col(it->second) - _points.col(i)).cwiseAbs().maxCoeff() <= key_tol) {
+        old_to_new[it->second] = i;
+        dist(i) = m_dist(it->second);
+      }
+      else {
+        inserted.push_back(i);
+        m_changed = true;
+      }
+    }
+
+    // removing a hull vertex, or moving it other than down, may raise the hull; a vertex that only
+    // moved down is one of the inserted points, and is a candidate vertex of the new hull
+    std::vector<Index> vertices;
+    std::vector<Index> lowered;
+    for(Index i = 0; !full && i < m_vertices.size(); i++) {
+      Index v = m_vertices[i];
+      if(old_to_new[v] != -1) {
+        vertices.push_back(old_to_new[v]);
+        continue;
+      }
+      auto it = index.find(m_names[v]);
+      if(it == index.end() ||
+         _points(0, it->second) > m_points(0, v) + key_tol ||
+         (m_points.col(v).tail(m_points.rows() - 1) - _points.col(it->second).tail(m_points.rows() - 1)).cwiseAbs().maxCoeff() > key_tol) {
+        full = true;
+      }
+      else {
+        lowered.push_back(it->second);
+      }
+    }
+
+    // insert the points that lie above the hull, and collect the rest
+    std::vector<Index> candidates;
+    if(!full && inserted.size()) {
+      Eigen::MatrixXd inserted_points(_points.rows(), inserted.size());
+      for(Index k = 0; k < inserted.size(); k++) {
+        inserted_points.col(k) = _points.col(inserted[k]);
+      }
+
+      Eigen::VectorXd energy;
+      std::vector<Index> facet;
+      _hull_energy(inserted_points, energy, facet);
+
+      for(Index k = 0; k < inserted.size(); k++) {
+        double d = inserted_points(0, k) - energy(k);
+        bool is_lowered = std::find(lowered.begin(), lowered.end(), inserted[k]) != lowered.end();
+        if(!is_lowered && d > m_tol && _in_facet(inserted_points.col(k), facet[k])) {
+          dist(inserted[k]) = d;
+        }
+        else {
+          candidates.push_back(inserted[k]);
+        }
+      }
+    }
+
+    // keep the BP::Geo only if all of its points are still present
+    for(Index i = 0; m_geo && i < m_geo_index.size(); i++) {
+      if(full || old_to_new[m_geo_index[i]] == -1) {
+        m_geo.reset();
+      }
+      else {
+        m_geo_index[i] = old_to_new[m_geo_index[i]];
+      }
+    }
+
+    m_names = _names;
+    m_index.swap(index);
+    m_points = _points;
+    m_dist = dist;
+
+    if(full) {
+      std::vector<Index> all(N);
+      for(Index i = 0; i < N; i++) {
+        all[i] = i;
+      }
+      return _build(all);
+    }
+
+    std::sort(vertices.begin(), vertices.end());
+    m_vertices = vertices;
+
+    if(candidates.empty()) {
+      return true;
+    }
+
+    candidates.insert(candidates.end(), m_vertices.begin(), m_vertices.end());
+    return _build(candidates);
+  }
+
+  //*******************************************************************************************
+
+  Index HullCache::find(const std::string &name) const {
+    auto it = m_index.find(name);
+    if(it == m_index.end()) {
+      return size();
+    }
+    return it->second;
+  }
+
+  //*******************************************************************************************
+
+  bool HullCache::is_vertex(Index i) const {
+    return std::binary_search(m_vertices.begin(), m_vertices.end(), i);
+  }
+
+  //*******************************************************************************************
+
+  Eigen::VectorXd HullCache::dist_to_hull(const Eigen::MatrixXd &_points) const {
+    if(facets_size() == 0) {
+      throw std::runtime_error("Error in HullCache::dist_to_hull: no hull");
+    }
+    if(_points.rows() != m_plane.cols()) {
+      throw std::runtime_error("Error in HullCache::dist_to_hull: points have dimension " + std::to_string(_points.rows())
+                               + ", hull has dimension " + std::to_string(m_plane.cols()));
+    }
+
+    Eigen::VectorXd energy;
+    std::vector<Index> facet;
+    _hull_energy(_points, energy, facet);
+    return _points.row(0).transpose() - energy;
+  }
+
+  //*******************************************************************************************
+
+  BP::Geo &HullCache::geo(std::vector<Index> &index) const {
+    if(!m_geo) {
+      if(facets_size() == 0) {
+        throw std::runtime_error("Error in HullCache::geo: no hull");
+      }
+
+      // add the highest point, in case the hull vertices alone are all on one facet
+      m_geo_index = m_vertices;
+      Index top;
+      m_points.row(0).maxCoeff(&top);
+      if(!is_vertex(top)) {
+        m_geo_index.push_back(top);
+      }
+
+      Eigen::MatrixXd sub(m_points.rows(), m_geo_index.size());
+      for(Index k = 0; k < m_geo_index.size(); k++) {
+        sub.col(k) = m_points.col(m_geo_index[k]);
+      }
+
+      m_geo = std::make_shared<BP::Geo>();
+      m_geo->set_verbosity(0);
+      m_geo->reset_points(sub, true);
+      if(!m_geo->calc_CH()) {
+        m_geo.reset();
+        throw std::runtime_error("Error in HullCache::geo: could not construct hull from hull vertices");
+      }
+
+      Eigen::VectorXd bottom = Eigen::VectorXd::Zero(m_points.rows());
+      bottom(0) = -1;
+      m_geo->CH_bottom(bottom);
+    }
+    index = m_geo_index;
+    return *m_geo;
+  }
+
+  //*******************************************************************************************
+
+  bool HullCache::read(const fs::path &file) {
+    if(!fs::exists(file)) {
+      return false;
+    }
+    try {
+      from_json(jsonParser(file));
+    }
+    catch(...) {
+      // an unreadable cache is rebuilt
+      _clear();
+      return false;
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void HullCache::write(const fs::path &file) const {
+    if(!file.parent_path().empty()) {
+      fs::create_directories(file.parent_path());
+    }
+    jsonParser json;
+    to_json(json);
+    json.write(file, 0, 17);
+  }
+
+  //*******************************************************************************************
+
+  void HullCache::prune(const fs::path &dir, Index max_size) {
+    if(!fs::is_directory(dir)) {
+      return;
+    }
+    std::vector<std::pair<std::time_t, fs::path> > cached;
+    fs::directory_iterator it(dir), end;
+    for(; it != end; ++it) {
+      if(it->path().extension() == ".json") {
+        cached.push_back(std::make_pair(fs::last_write_time(it->path()), it->path()));
+      }
+    }
+    if(cached.size() <= max_size) {
+      return;
+    }
+    std::sort(cached.begin(), cached.end());
+    for(Index i = 0; i < cached.size() - max_size; i++) {
+      // another process may have removed it already
+      boost::system::error_code ec;
+      fs::remove(cached[i].second, ec);
+    }
+  }
+
+  //*******************************************************************************************
+
+  jsonParser &HullCache::to_json(jsonParser &json) const {
+    json.put_obj();
+    json["tol"] = m_tol;
+    json["names"] = m_names;
+    // one point per row
+    json["points"] = Eigen::MatrixXd(m_points.transpose());
+    json["dist_to_hull"] = std::vector<double>(m_dist.data(), m_dist.data() + m_dist.size());
+    json["vertices"] = m_vertices;
+    json["incremental"] = m_incremental;
+    json["plane"] = m_plane;
+    json["bary"] = m_bary;
+    return json;
+  }
+
+  //*******************************************************************************************
+
+  void HullCache::from_json(const jsonParser &json) {
+    _clear();
+
+    json["tol"].get(m_tol);
+    json["names"].get(m_names);
+    for(Index i = 0; i < size(); i++) {
+      m_index[m_names[i]] = i;
+    }
+
+    if(size()) {
+      Eigen::MatrixXd points;
+      Eigen::from_json(points, json["points"]);
+      m_points = points.transpose();
+
+      std::vector<double> dist;
+      json["dist_to_hull"].get(dist);
+      m_dist = Eigen::Map<Eigen::VectorXd>(dist.data(), dist.size());
+
+      json["vertices"].get(m_vertices);
+      json["incremental"].get(m_incremental);
+      Eigen::from_json(m_plane, json["plane"]);
+      Eigen::from_json(m_bary, json["bary"]);
+    }
+
+    if(m_points.cols() != size() || m_dist.size() != size() || m_plane.cols() != m_points.rows()) {
+      _clear();
+      throw std::runtime_error("Error in HullCache::from_json: inconsistent cache");
+    }
+  }
+
+  //*******************************************************************************************
+
+  /// The hull of the points in 'subset', and the highest point, is found with BP::Geo, and the
+  /// plane and barycentric coordinate transformation of each bottom facet are found from its
+  /// vertices. Then the distance to the hull is found for all points.
+  bool HullCache::_build(const std::vector<Index> &subset) {
+    Index dim = m_points.rows();
+    m_rebuilt = true;
+    m_geo.reset();
+
+    if(subset.size() == 0) {
+      _clear();
+      return false;
+    }
+
+    // add the highest point, in case the subset is all on one facet
+    m_geo_index = subset;
+    Index top;
+    m_points.row(0).maxCoeff(&top);
+    if(std::find(subset.begin(), subset.end(), top) == subset.end()) {
+      m_geo_index.push_back(top);
+    }
+    m_rebuild_size = m_geo_index.size();
+
+    Eigen::MatrixXd sub(dim, m_geo_index.size());
+    for(Index k = 0; k < m_geo_index.size(); k++) {
+      sub.col(k) = m_points.col(m_geo_index[k]);
+    }
+
+    m_geo = std::make_shared<BP::Geo>();
+    m_geo->set_verbosity(0);
+    m_geo->reset_points(sub, true);
+    if(!m_geo->calc_CH()) {
+      _clear();
+      return false;
+    }
+
+    Eigen::VectorXd bottom = Eigen::VectorXd::Zero(dim);
+    bottom(0) = -1;
+    m_geo->CH_bottom(bottom);
+
+    BP::BP_Vec<int> verts = m_geo->CH_verts_indices();
+    m_vertices.clear();
+    for(Index i = 0; i < verts.size(); i++) {
+      m_vertices.push_back(m_geo_index[verts[i]]);
+    }
+    std::sort(m_vertices.begin(), m_vertices.end());
+
+    Index Nfacet = m_geo->CH_facets_size();
+    m_plane.resize(Nfacet, dim);
+    m_bary = Eigen::MatrixXd::Zero(Nfacet * dim, dim);
+    m_incremental = true;
+    for(Index f = 0; f < Nfacet; f++) {
+      BP::BP_Vec<int> fverts = m_geo->CH_facets_nborverts(f);
+
+      // columns are (1, x) for each vertex
+      Eigen::MatrixXd V(dim, fverts.size());
+      Eigen::VectorXd E(fverts.size());
+      for(Index k = 0; k < fverts.size(); k++) {
+        Eigen::VectorXd pos = m_geo->CH_verts_pos(fverts[k]);
+        E(k) = pos(0);
+        V(0, k) = 1.0;
+        V.col(k).tail(dim - 1) = pos.tail(dim - 1);
+      }
+
+      if(fverts.size() == dim) {
+        Eigen::FullPivLU<Eigen::MatrixXd> lu(V);
+        if(lu.isInvertible()) {
+          m_bary.block(f * dim, 0, dim, dim) = lu.inverse();
+          m_plane.row(f) = E.transpose() * m_bary.block(f * dim, 0, dim, dim);
+          continue;
+        }
+      }
+
+      // not a simplex, so the domain of the facet is not known
+      m_incremental = false;
+      m_plane.row(f) = V.transpose().jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(E).transpose();
+    }
+
+    m_dist = dist_to_hull(m_points);
+    for(Index i = 0; i < m_vertices.size(); i++) {
+      m_dist(m_vertices[i]) = 0.0;
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void HullCache::_hull_energy(const Eigen::MatrixXd &_points, Eigen::VectorXd &energy, std::vector<Index> &facet) const {
+    Index dim = m_plane.cols();
+    Index N = _points.cols();
+    energy.resize(N);
+    facet.resize(N);
+
+    Eigen::MatrixXd H;
+    for(Index begin = 0; begin < N; begin += batch_size) {
+      Index n = std::min(batch_size, N - begin);
+      H = m_plane.rightCols(dim - 1) * _points.block(1, begin, dim - 1, n);
+      H.colwise() += m_plane.col(0);
+      for(Index i = 0; i < n; i++) {
+        Index f;
+        energy(begin + i) = H.col(i).maxCoeff(&f);
+        facet[begin + i] = f;
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  bool HullCache::_in_facet(const Eigen::VectorXd &point, Index facet) const {
+    Index dim = m_plane.cols();
+    Eigen::VectorXd x(dim);
+    x(0) = 1.0;
+    x.tail(dim - 1) = point.tail(dim - 1);
+    return (m_bary.block(facet * dim, 0, dim, dim) * x).minCoeff() >= -m_tol;
+  }
+
+  //*******************************************************************************************
+
+  void HullCache::_clear() {
+    m_names.clear();
+    m_index.clear();
+    m_points.resize(0, 0);
+    m_dist.resize(0);
+    m_vertices.clear();
+    m_plane.resize(0, 0);
+    m_bary.resize(0, 0);
+    m_incremental = true;
+    m_geo.reset();
+    m_geo_index.clear();
+  }
+
+  //*******************************************************************************************
+
+  jsonParser &to_json(const HullCache &cache, jsonParser &json) {
+    return cache.to_json(json);
+  }
+
+  //*******************************************************************************************
+
+  void from_json(HullCache &cache, const jsonParser &json) {
+    cache.from_json(json);
+  }
+
+}
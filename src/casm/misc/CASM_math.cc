@@ -1,5 +1,8 @@
 #include "casm/misc/CASM_math.hh"
 
+#include <cstdint>
+#include <iomanip>
+
 namespace CASM {
   //*******************************************************************************************
 
@@ -254,6 +257,24 @@ namespace CASM {
     }
   }
 
+  //*******************************************************************************************
+
+  std::string stable_hash(const std::vector<std::string> &fields) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for(const std::string &field : fields) {
+      for(unsigned char c : field) {
+        h ^= c;
+        h *= 1099511628211ULL;
+      }
+      h ^= 0xff;
+      h *= 1099511628211ULL;
+    }
+
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+  }
+
   //*******************************************************************************************
   /**
    *
@@ -0,0 +1,159 @@
+#include "casm/misc/SparseAssignment.hh"
+
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace CASM {
+
+  void SparseAssignment::reset(Index _dim) {
+    if(_dim != m_v.size()) {
+      m_v.assign(_dim, 0.0);
+    }
+    m_row.assign(_dim, row_type());
+    m_col4row.clear();
+    m_row4col.clear();
+    m_u.clear();
+    m_cost = 0.0;
+  }
+
+  //*******************************************************************************************
+
+  /// Each row starts with dual m_u[i] = min_j (cost(i, j) - m_v[j]), and is assigned its
+  /// minimizing column if that column is free. Each remaining row is assigned by finding the
+  /// shortest path, in reduced costs, to a free column, updating the duals so that the reduced
+  /// costs stay non-negative, and swapping assignments along the path.
+  bool SparseAssignment::solve() {
+    Index N = dim();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    m_col4row.assign(N, -1);
+    m_row4col.assign(N, -1);
+    m_u.assign(N, 0.0);
+    m_cost = 0.0;
+
+    for(Index i = 0; i < N; i++) {
+      if(m_row[i].empty()) {
+        return false;
+      }
+      double best = inf;
+      Index best_col = -1;
+      for(const auto &entry : m_row[i]) {
+        double r = entry.second - m_v[entry.first];
+        if(r < best) {
+          best = r;
+          best_col = entry.first;
+        }
+      }
+      m_u[i] = best;
+      if(m_row4col[best_col] == -1) {
+        m_row4col[best_col] = i;
+        m_col4row[i] = best_col;
+      }
+    }
+
+    typedef std::pair<double, Index> heap_entry;
+    std::priority_queue<heap_entry, std::vector<heap_entry>, std::greater<heap_entry> > heap;
+
+    std::vector<double> dist(N, inf);
+    std::vector<Index> pred(N, -1);
+    std::vector<bool> scanned(N, false);
+    std::vector<Index> touched, scanned_cols, scanned_rows;
+
+    for(Index s = 0; s < N; s++) {
+      if(m_col4row[s] != -1) {
+        continue;
+      }
+
+      // Dijkstra from row 's' over reduced costs, until a free column is reached
+      Index i = s;
+      double d = 0.0;
+      Index sink = -1;
+      while(true) {
+        for(const auto &entry : m_row[i]) {
+          Index j = entry.first;
+          if(scanned[j]) {
+            continue;
+          }
+          double nd = d + entry.second - m_u[i] - m_v[j];
+          if(nd < dist[j]) {
+            if(dist[j] == inf) {
+              touched.push_back(j);
+            }
+            dist[j] = nd;
+            pred[j] = i;
+            heap.push(std::make_pair(nd, j));
+          }
+        }
+
+        Index j = -1;
+        while(!heap.empty()) {
+          heap_entry top = heap.top();
+          heap.pop();
+          if(!scanned[top.second] && top.first <= dist[top.second]) {
+            j = top.second;
+            break;
+          }
+        }
+        if(j == -1) {
+          break;
+        }
+
+        scanned[j] = true;
+        scanned_cols.push_back(j);
+        d = dist[j];
+        if(m_row4col[j] == -1) {
+          sink = j;
+          break;
+        }
+        i = m_row4col[j];
+        scanned_rows.push_back(i);
+      }
+
+      if(sink == -1) {
+        return false;
+      }
+
+      // update duals
+      double delta = dist[sink];
+      m_u[s] += delta;
+      for(Index r : scanned_rows) {
+        m_u[r] += delta - dist[m_col4row[r]];
+      }
+      for(Index j : scanned_cols) {
+        m_v[j] -= delta - dist[j];
+      }
+
+      // augment
+      Index j = sink;
+      while(true) {
+        Index r = pred[j];
+        m_row4col[j] = r;
+        std::swap(j, m_col4row[r]);
+        if(r == s) {
+          break;
+        }
+      }
+
+      for(Index k : touched) {
+        dist[k] = inf;
+        scanned[k] = false;
+      }
+      touched.clear();
+      scanned_cols.clear();
+      scanned_rows.clear();
+      heap = decltype(heap)();
+    }
+
+    for(Index i = 0; i < N; i++) {
+      for(const auto &entry : m_row[i]) {
+        if(entry.first == m_col4row[i]) {
+          m_cost += entry.second;
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+}
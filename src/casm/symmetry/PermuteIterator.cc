@@ -1,15 +1,18 @@
 #include "casm/symmetry/PermuteIterator.hh"
 
 #include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/PrimGridPermute.hh"
 
 namespace CASM {
 
-  PermuteIterator::PermuteIterator() {}
+  PermuteIterator::PermuteIterator() :
+    m_prim_grid(NULL),
+    m_grid_permute(NULL) {}
 
   PermuteIterator::PermuteIterator(const PermuteIterator &iter) :
     m_fg_permute_rep(iter.m_fg_permute_rep),
     m_prim_grid(iter.m_prim_grid),
-    m_trans_permute(&(m_prim_grid->translation_permutations())),
+    m_grid_permute(iter.m_grid_permute),
     m_factor_group_index(iter.m_factor_group_index),
     m_translation_index(iter.m_translation_index) {
 
@@ -21,7 +24,17 @@ namespace CASM {
                                    Index _translation_index) :
     m_fg_permute_rep(_fg_permute_rep),
     m_prim_grid(&_prim_grid),
-    m_trans_permute(&(m_prim_grid->translation_permutations())),
+    m_grid_permute(NULL),
+    m_factor_group_index(_factor_group_index),
+    m_translation_index(_translation_index) {
+  }
+
+  PermuteIterator::PermuteIterator(const PrimGridPermute &grid_permute,
+                                   Index _factor_group_index,
+                                   Index _translation_index) :
+    m_fg_permute_rep(grid_permute.factor_group()),
+    m_prim_grid(&grid_permute.prim_grid()),
+    m_grid_permute(&grid_permute),
     m_factor_group_index(_factor_group_index),
     m_translation_index(_translation_index) {
   }
@@ -33,12 +46,21 @@ namespace CASM {
 
   /// Returns the combination of factor_group permutation and translation permutation
   Permutation PermuteIterator::operator*() const {
+    if(m_grid_permute)
+      return m_grid_permute->permutation(m_factor_group_index, m_translation_index);
     return translation_permute() * factor_group_permute();
   }
 
   /// Apply the combined factor_group permutation and translation permutation being pointed at
   template<typename T>
   ReturnArray<T> PermuteIterator::permute(const Array<T> &before_array) const {
+    if(m_grid_permute) {
+      assert(before_array.size() == m_grid_permute->size() && "WARNING: You're trying to permute an Array with an incompatible permutation!");
+      Array<T> after_array(before_array.size());
+      m_grid_permute->permute(m_factor_group_index, m_translation_index, before_array.begin(), after_array.begin());
+      return after_array;
+    }
+
     assert(before_array.size() == factor_group_permute().size() && "WARNING: You're trying to permute an Array with an incompatible permutation!");
 
     Array<T> after_array;
@@ -62,12 +84,14 @@ namespace CASM {
 
   /// Return the factor group permutation being pointed at
   const Permutation &PermuteIterator::factor_group_permute() const {
+    if(m_grid_permute)
+      return m_grid_permute->factor_group_permute(m_factor_group_index);
     return *(m_fg_permute_rep[m_factor_group_index]->get_permutation());
   }
 
   /// Return the translation permutation being pointed at
   const Permutation &PermuteIterator::translation_permute() const {
-    return m_trans_permute->at(m_translation_index);
+    return m_prim_grid->translation_permutation(m_translation_index);
   }
 
   SymOp PermuteIterator::sym_op()const {
@@ -75,18 +99,21 @@ namespace CASM {
   }
 
   Index PermuteIterator::permute_ind(Index i) const {
+    if(m_grid_permute)
+      return m_grid_permute->permute_ind(m_factor_group_index, m_translation_index, i);
     return factor_group_permute()[ translation_permute()[i] ];
   }
 
   /// Return after_array[i], given i and before_array
   template<typename T>
   const T &PermuteIterator::permute_by_bit(Index i, const Array<T> &before_array) const {
-    return before_array[ factor_group_permute()[ translation_permute()[i] ] ];
+    return before_array[permute_ind(i)];
   }
 
   bool PermuteIterator::operator==(const PermuteIterator &iter) {
     if(m_fg_permute_rep == iter.m_fg_permute_rep &&
        m_prim_grid == iter.m_prim_grid &&
+       m_grid_permute == iter.m_grid_permute &&
        m_factor_group_index == iter.m_factor_group_index &&
        m_translation_index == iter.m_translation_index)
       return true;
@@ -100,7 +127,7 @@ namespace CASM {
   // prefix ++PermuteIterator
   PermuteIterator &PermuteIterator::operator++() {
     m_translation_index++;
-    if(m_translation_index == m_trans_permute->size()) {
+    if(m_translation_index == m_prim_grid->size()) {
       m_translation_index = 0;
       m_factor_group_index++;
     }
@@ -118,7 +145,7 @@ namespace CASM {
   PermuteIterator &PermuteIterator::operator--() {
     if(m_translation_index == 0) {
       m_factor_group_index--;
-      m_translation_index = m_trans_permute->size();
+      m_translation_index = m_prim_grid->size();
     }
     m_translation_index--;
     return *this;
@@ -184,7 +211,7 @@ namespace CASM {
   void swap(PermuteIterator &a, PermuteIterator &b) {
     std::swap(a.m_fg_permute_rep, b.m_fg_permute_rep);
     std::swap(a.m_prim_grid, b.m_prim_grid);
-    std::swap(a.m_trans_permute, b.m_trans_permute);
+    std::swap(a.m_grid_permute, b.m_grid_permute);
     std::swap(a.m_factor_group_index, b.m_factor_group_index);
     std::swap(a.m_translation_index, b.m_translation_index);
   }
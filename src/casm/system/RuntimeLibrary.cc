@@ -0,0 +1,165 @@
+#include "casm/system/RuntimeLibrary.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/misc/CASM_math.hh"
+#include "casm/system/TaskScheduler.hh"
+
+namespace CASM {
+
+  namespace {
+
+    std::string _read_source(const std::string &path) {
+      std::ifstream file(path);
+      if(!file) {
+        throw std::runtime_error(std::string("Error in RuntimeLibrary: could not read ") + path);
+      }
+      std::stringstream ss;
+      ss << file.rdbuf();
+      return ss.str();
+    }
+
+    /// Number of translation units requested by the source, 1 if none are requested
+    int _num_translation_units(const std::string &source) {
+      const std::string key = "#define CASM_NUM_TRANSLATION_UNITS ";
+      std::string::size_type pos = source.find(key);
+      if(pos == std::string::npos) {
+        return 1;
+      }
+      int N = std::atoi(source.c_str() + pos + key.size());
+      return N > 1 ? N : 1;
+    }
+
+    /// Run 'command', throwing if it fails
+    void _run(const std::string &command) {
+      Popen p(Popen::default_popen_handler, [&](int status) {
+        if(status != 0) {
+          throw std::runtime_error(std::string("Error in RuntimeLibrary: command failed:\n  ") + command);
+        }
+      });
+      p.popen(command);
+    }
+
+    /// Remove all but the 'max_size' most recently written libraries in 'cache_dir'
+    void _prune_cache(const fs::path &cache_dir, int max_size) {
+      std::vector<std::pair<std::time_t, fs::path> > cached;
+      fs::directory_iterator it(cache_dir), end;
+      for(; it != end; ++it) {
+        if(it->path().extension() == ".so") {
+          cached.push_back(std::make_pair(fs::last_write_time(it->path()), it->path()));
+        }
+      }
+      if(cached.size() <= max_size) {
+        return;
+      }
+      std::sort(cached.begin(), cached.end());
+      for(Index i = 0; i < cached.size() - max_size; i++) {
+        fs::remove(cached[i].second);
+      }
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  void RuntimeLibrary::compile(std::string _filename_base) {
+    if(m_handle != nullptr) {
+      close();
+    }
+
+    m_filename_base = _filename_base;
+
+    std::string source = _read_source(m_filename_base + ".cc");
+    int N = _num_translation_units(source);
+
+    // compile the source code into object files, in parallel
+    std::vector<std::string> object(N, m_filename_base + ".o");
+    global_scheduler().parallel_for(0, N, [&](Index begin, Index end) {
+      for(Index i = begin; i < end; i++) {
+        std::string define;
+        if(N > 1) {
+          object[i] = m_filename_base + "_" + std::to_string(i) + ".o";
+          define = " -DCASM_TRANSLATION_UNIT=" + std::to_string(i);
+        }
+        _run(m_compile_options + define + " -o " + object[i] + " -c " + m_filename_base + ".cc");
+      }
+    }, 1);
+
+    // link into a dynamic library, replacing any existing library only once complete
+    std::string tmp_so = m_filename_base + ".so.tmp." + std::to_string(getpid());
+    std::string objects;
+    for(const std::string &obj : object) {
+      objects += " " + obj;
+    }
+    _run(m_so_options + " -o " + tmp_so + objects);
+    fs::rename(tmp_so, m_filename_base + ".so");
+
+    std::ofstream hash_file(m_filename_base + ".so.hash");
+    hash_file << stable_hash({source, m_compile_options, m_so_options, m_interface_version}) << "\n";
+  }
+
+  //*******************************************************************************************
+
+  bool RuntimeLibrary::compile_if_stale(std::string _filename_base, std::string cache_dir) {
+
+    if(!is_stale(_filename_base)) {
+      return false;
+    }
+
+    std::string hash = source_hash(_filename_base);
+    fs::path cached;
+    if(!cache_dir.empty()) {
+      cached = fs::path(cache_dir) / (hash + ".so");
+      if(fs::exists(cached)) {
+        fs::path tmp_so(_filename_base + ".so.tmp." + std::to_string(getpid()));
+        fs::copy_file(cached, tmp_so);
+        fs::rename(tmp_so, _filename_base + ".so");
+        std::ofstream hash_file(_filename_base + ".so.hash");
+        hash_file << hash << "\n";
+        return true;
+      }
+    }
+
+    compile(_filename_base);
+
+    if(!cache_dir.empty()) {
+      fs::create_directories(cache_dir);
+      fs::path tmp_so(cached.string() + ".tmp." + std::to_string(getpid()));
+      fs::copy_file(_filename_base + ".so", tmp_so);
+      fs::rename(tmp_so, cached);
+      _prune_cache(cache_dir, max_cached_libraries);
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  bool RuntimeLibrary::is_stale(std::string _filename_base) const {
+    if(!fs::exists(_filename_base + ".so")) {
+      return true;
+    }
+    if(!fs::exists(_filename_base + ".cc")) {
+      return false;
+    }
+
+    std::ifstream hash_file(_filename_base + ".so.hash");
+    std::string hash;
+    hash_file >> hash;
+    return hash != source_hash(_filename_base);
+  }
+
+  //*******************************************************************************************
+
+  std::string RuntimeLibrary::source_hash(std::string _filename_base) const {
+    return stable_hash({_read_source(_filename_base + ".cc"), m_compile_options, m_so_options, m_interface_version});
+  }
+
+}
@@ -0,0 +1,229 @@
+#include "casm/system/TaskScheduler.hh"
+
+#include <cstdlib>
+
+namespace CASM {
+
+  namespace {
+
+    /// The TaskScheduler that owns the calling thread, and the worker index of the calling thread
+    thread_local TaskScheduler *t_scheduler = nullptr;
+    thread_local Index t_worker = -1;
+
+    std::mutex global_scheduler_mutex;
+    Index global_num_threads = 0;
+    std::unique_ptr<TaskScheduler> global_scheduler_ptr;
+
+  }
+
+  //*******************************************************************************************
+
+  TaskScheduler::TaskScheduler(Index num_threads) :
+    m_pending(0),
+    m_sleeping(0),
+    m_next(0),
+    m_stop(false) {
+
+    if(num_threads < 1) {
+      num_threads = default_num_threads();
+    }
+
+    for(Index w = 0; w < num_threads; w++) {
+      m_worker.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for(Index w = 0; w < num_threads; w++) {
+      m_thread.push_back(std::thread(&TaskScheduler::_run, this, w));
+    }
+  }
+
+  //*******************************************************************************************
+
+  TaskScheduler::~TaskScheduler() {
+    {
+      std::unique_lock<std::mutex> lock(m_sleep_mutex);
+      m_stop = true;
+    }
+    m_sleep_cond.notify_all();
+
+    for(auto &thread : m_thread) {
+      // if a task calls exit(), static destruction happens on a worker thread
+      if(thread.get_id() == std::this_thread::get_id()) {
+        thread.detach();
+      }
+      else {
+        thread.join();
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void TaskScheduler::_push(Task task) {
+    Index w = _this_worker();
+    if(w < 0) {
+      w = (m_next++) % size();
+    }
+
+    {
+      Worker &worker = *m_worker[w];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.deque.push_back(std::make_pair(worker.next_seq++, std::move(task)));
+    }
+    m_pending++;
+
+    if(m_sleeping > 0) {
+      std::unique_lock<std::mutex> lock(m_sleep_mutex);
+      m_sleep_cond.notify_one();
+    }
+  }
+
+  //*******************************************************************************************
+
+  bool TaskScheduler::_pop(Index w, Task &task) {
+    Worker &worker = *m_worker[w];
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    if(worker.deque.empty()) {
+      return false;
+    }
+    task = std::move(worker.deque.back().second);
+    worker.deque.pop_back();
+    m_pending--;
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  bool TaskScheduler::_steal(Index w, Task &task) {
+    for(Index i = 1; i < size(); i++) {
+      Worker &victim = *m_worker[(w + i) % size()];
+      std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+      if(!lock.owns_lock() || victim.deque.empty()) {
+        continue;
+      }
+      task = std::move(victim.deque.front().second);
+      victim.deque.pop_front();
+      m_pending--;
+      return true;
+    }
+    return false;
+  }
+
+  //*******************************************************************************************
+
+  void TaskScheduler::_run(Index w) {
+    t_scheduler = this;
+    t_worker = w;
+
+    Task task;
+    while(true) {
+      if(_pop(w, task) || _steal(w, task)) {
+        task();
+        task = nullptr;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(m_sleep_mutex);
+      m_sleeping++;
+      // a task may be left in a deque that was locked during _steal
+      if(m_pending > 0) {
+        m_sleeping--;
+        continue;
+      }
+      if(m_stop) {
+        m_sleeping--;
+        return;
+      }
+      m_sleep_cond.wait(lock);
+      m_sleeping--;
+    }
+  }
+
+  //*******************************************************************************************
+
+  Index TaskScheduler::_this_worker() const {
+    return (t_scheduler == this) ? t_worker : -1;
+  }
+
+  //*******************************************************************************************
+
+  Index TaskScheduler::_local_mark() {
+    Index w = _this_worker();
+    if(w < 0) {
+      return 0;
+    }
+    Worker &worker = *m_worker[w];
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    return worker.next_seq;
+  }
+
+  //*******************************************************************************************
+
+  bool TaskScheduler::_run_local_task(Index mark) {
+    Index w = _this_worker();
+    if(w < 0) {
+      return false;
+    }
+
+    Task task;
+    {
+      Worker &worker = *m_worker[w];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      if(worker.deque.empty() || worker.deque.back().first < mark) {
+        return false;
+      }
+      task = std::move(worker.deque.back().second);
+      worker.deque.pop_back();
+      m_pending--;
+    }
+    task();
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  Index default_num_threads() {
+    const char *env = std::getenv("CASM_NUM_THREADS");
+    if(env != nullptr) {
+      char *end;
+      long n = std::strtol(env, &end, 10);
+      if(end != env && *end == '\0' && n > 0) {
+        return n;
+      }
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  //*******************************************************************************************
+
+  Index num_threads() {
+    std::unique_lock<std::mutex> lock(global_scheduler_mutex);
+    if(global_scheduler_ptr) {
+      return global_scheduler_ptr->size();
+    }
+    return (global_num_threads > 0) ? global_num_threads : default_num_threads();
+  }
+
+  //*******************************************************************************************
+
+  void set_num_threads(Index num_threads) {
+    if(num_threads < 1) {
+      num_threads = default_num_threads();
+    }
+    std::unique_lock<std::mutex> lock(global_scheduler_mutex);
+    global_num_threads = num_threads;
+    if(global_scheduler_ptr && global_scheduler_ptr->size() != num_threads) {
+      global_scheduler_ptr.reset();
+    }
+  }
+
+  //*******************************************************************************************
+
+  TaskScheduler &global_scheduler() {
+    std::unique_lock<std::mutex> lock(global_scheduler_mutex);
+    if(!global_scheduler_ptr) {
+      global_scheduler_ptr.reset(new TaskScheduler(global_num_threads));
+    }
+    return *global_scheduler_ptr;
+  }
+
+}
@@ -0,0 +1,71 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/BinaryCorrelation.hh"
+
+/// What is being used to test it:
+#include <stdexcept>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(BinaryCorrelationTest)
+
+BOOST_AUTO_TEST_CASE(RoundTripTest) {
+  namespace fs = boost::filesystem;
+
+  fs::path dir = fs::temp_directory_path() / fs::unique_path("casm_corr_%%%%-%%%%");
+  fs::create_directory(dir);
+
+  // a column-major 5 x 3 matrix
+  std::uint64_t Nconfig = 5, Ncorr = 3;
+  std::vector<double> corr(Nconfig * Ncorr);
+  for(std::uint64_t i = 0; i < corr.size(); i++) {
+    corr[i] = 1.0 / (i + 1.0) - 0.25;
+  }
+
+  fs::path corr_file = dir / "corr.in.bin";
+  {
+    fs::ofstream sout(corr_file, std::ios::binary);
+    BinaryCorrelation::write(sout, Nconfig, Ncorr, corr.data());
+    sout.close();
+    BOOST_CHECK(!sout.fail());
+  }
+  BOOST_CHECK_EQUAL(fs::file_size(corr_file), BinaryCorrelation::header_size + corr.size() * sizeof(double));
+
+  {
+    std::uint64_t check_Nconfig, check_Ncorr;
+    std::shared_ptr<const double> data = BinaryCorrelation::map(corr_file.string(), check_Nconfig, check_Ncorr);
+    BOOST_CHECK_EQUAL(check_Nconfig, Nconfig);
+    BOOST_CHECK_EQUAL(check_Ncorr, Ncorr);
+    for(std::uint64_t i = 0; i < corr.size(); i++) {
+      BOOST_CHECK_EQUAL(data.get()[i], corr[i]);
+    }
+  }
+
+  // files that are truncated, too small to hold a header, wrong, or missing are rejected
+  std::uint64_t tNconfig, tNcorr;
+  fs::resize_file(corr_file, fs::file_size(corr_file) - sizeof(double));
+  BOOST_CHECK_THROW(BinaryCorrelation::map(corr_file.string(), tNconfig, tNcorr), std::runtime_error);
+
+  fs::resize_file(corr_file, BinaryCorrelation::header_size - 1);
+  BOOST_CHECK_THROW(BinaryCorrelation::map(corr_file.string(), tNconfig, tNcorr), std::runtime_error);
+
+  {
+    fs::ofstream sout(dir / "corr.in");
+    sout << "3 # basis functions\n5 # training values\nCorrelation matrix:\n";
+    for(std::uint64_t i = 0; i < 20; i++) {
+      sout << "0.0 0.0 0.0\n";
+    }
+  }
+  BOOST_CHECK_THROW(BinaryCorrelation::map((dir / "corr.in").string(), tNconfig, tNcorr), std::runtime_error);
+
+  BOOST_CHECK_THROW(BinaryCorrelation::map((dir / "missing.bin").string(), tNconfig, tNcorr), std::runtime_error);
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
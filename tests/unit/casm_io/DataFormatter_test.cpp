@@ -0,0 +1,161 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/DataFormatter.hh"
+
+/// What is being used to test it:
+#include <atomic>
+#include <thread>
+#include "casm/casm_io/DataFormatterTools.hh"
+
+using namespace CASM;
+
+namespace {
+
+  struct TestObject {
+    int value;
+  };
+
+  std::atomic<Index> square_calls(0);
+
+  /// 'value' squared, computed once per row
+  double row_square(const TestObject &obj) {
+    return DataFormatterContext::get<double>("square", [&]()->double {
+      square_calls++;
+      return obj.value * obj.value;
+    });
+  }
+
+  DataFormatter<TestObject> test_formatter() {
+    return DataFormatter<TestObject>(
+             GenericDatumFormatter<double, TestObject>("square", "value squared", row_square),
+             GenericDatumFormatter<double, TestObject>("square_plus_one", "value squared, plus one",
+    [](const TestObject & obj) {
+      return row_square(obj) + 1.0;
+    }));
+  }
+
+  std::atomic<Index> init_calls(0);
+
+  /// Prints 'value', and records the threads it was printed on
+  class ThreadFormatter : public BaseDatumFormatter<TestObject> {
+  public:
+    ThreadFormatter(bool _thread_safe_clone, std::vector<std::thread::id> &_threads) :
+      BaseDatumFormatter<TestObject>("thread", "value, printed on a recorded thread"),
+      m_thread_safe_clone(_thread_safe_clone),
+      m_threads(&_threads) {}
+
+    BaseDatumFormatter<TestObject> *clone() const override {
+      return new ThreadFormatter(*this);
+    }
+
+    void init(const TestObject &_template_obj) const override {
+      init_calls++;
+    }
+
+    bool thread_safe_clone() const override {
+      return m_thread_safe_clone;
+    }
+
+    void print(const TestObject &obj, std::ostream &_stream, Index pass_index = 0) const override {
+      if(!m_thread_safe_clone) {
+        m_threads->push_back(std::this_thread::get_id());
+      }
+      _stream << obj.value;
+    }
+
+    void inject(const TestObject &obj, DataStream &_stream, Index pass_index = 0) const override {
+      _stream << obj.value;
+    }
+
+    jsonParser &to_json(const TestObject &obj, jsonParser &json) const override {
+      return json = obj.value;
+    }
+
+  private:
+    bool m_thread_safe_clone;
+    std::vector<std::thread::id> *m_threads;
+  };
+
+}
+
+BOOST_AUTO_TEST_SUITE(DataFormatterTest)
+
+BOOST_AUTO_TEST_CASE(SharedContext) {
+
+  std::vector<TestObject> objects;
+  for(int i = 0; i < 1000; i++) {
+    objects.push_back(TestObject {i});
+  }
+
+  // each column uses the square, but it is only computed once per row (plus once for the header)
+  square_calls = 0;
+  std::stringstream ss;
+  ss << test_formatter()(objects.begin(), objects.end());
+  BOOST_CHECK_EQUAL(square_calls, objects.size() + 1);
+
+  // rows are written in order
+  std::string line;
+  std::getline(ss, line);
+  for(Index i = 0; i < objects.size(); i++) {
+    double square, square_plus_one;
+    ss >> square >> square_plus_one;
+    BOOST_CHECK_EQUAL(square, double(i * i));
+    BOOST_CHECK_EQUAL(square_plus_one, double(i * i + 1));
+  }
+
+  jsonParser json;
+  json = test_formatter()(objects.begin(), objects.end());
+  BOOST_CHECK_EQUAL(json.size(), objects.size());
+  BOOST_CHECK_EQUAL(json[999]["square"].get<double>(), 998001.0);
+
+  // outside of a DataFormatter, values are not shared
+  square_calls = 0;
+  row_square(objects[3]);
+  row_square(objects[3]);
+  BOOST_CHECK_EQUAL(square_calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadSafeClone) {
+
+  std::vector<TestObject> objects;
+  for(int i = 0; i < 1000; i++) {
+    objects.push_back(TestObject {i});
+  }
+  std::vector<std::thread::id> threads;
+
+  // formatters are initialized once, not again for each copy used by a thread
+  init_calls = 0;
+  DataFormatter<TestObject> safe_formatter(ThreadFormatter(true, threads));
+  BOOST_CHECK(safe_formatter.thread_safe_clone());
+  std::stringstream ss;
+  ss << safe_formatter(objects.begin(), objects.end());
+  BOOST_CHECK_EQUAL(init_calls, 1);
+
+  // copies are not initialized
+  DataFormatter<TestObject> copy(safe_formatter);
+  copy.validate(objects[0]);
+  BOOST_CHECK_EQUAL(init_calls, 2);
+
+  // formatters that can not be cloned for other threads format rows on the calling thread
+  DataFormatter<TestObject> unsafe_formatter(ThreadFormatter(false, threads));
+  BOOST_CHECK(!unsafe_formatter.thread_safe_clone());
+  std::stringstream unsafe_ss;
+  unsafe_ss << unsafe_formatter(objects.begin(), objects.end());
+  BOOST_CHECK_EQUAL(threads.size(), objects.size() + 1);
+  for(Index i = 0; i < threads.size(); i++) {
+    BOOST_CHECK(threads[i] == std::this_thread::get_id());
+  }
+
+  // rows are written in order
+  std::string line;
+  std::getline(unsafe_ss, line);
+  for(Index i = 0; i < objects.size(); i++) {
+    int value;
+    unsafe_ss >> value;
+    BOOST_CHECK_EQUAL(value, i);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
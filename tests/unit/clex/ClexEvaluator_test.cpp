@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ClexEvaluator.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+
+/// What is being used to test it:
+#include <fstream>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+/// Write an eci.out file and read it
+ECIContainer make_eci(const std::vector<ECIContainer::size_type> &eci_index, const std::vector<double> &eci_value) {
+  namespace fs = boost::filesystem;
+  fs::path eci_path = fs::temp_directory_path() / fs::unique_path("casm_eci_%%%%-%%%%.out");
+  {
+    std::ofstream eci_file(eci_path.string().c_str());
+    for(int i = 0; i < 7; i++) {
+      eci_file << "header\n";
+    }
+    eci_file.precision(17);
+    for(Index i = 0; i < eci_index.size(); i++) {
+      eci_file << eci_value[i] << " " << eci_value[i] << " " << eci_index[i] << "\n";
+    }
+  }
+  ECIContainer eci(eci_path);
+  fs::remove(eci_path);
+  return eci;
+}
+
+BOOST_AUTO_TEST_SUITE(ClexEvaluatorTest)
+
+BOOST_AUTO_TEST_CASE(SparseECITest) {
+  namespace fs = boost::filesystem;
+
+  Clexulator clexulator("test_Clexulator",
+                        "tests/unit/clex",
+                        RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
+                        RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+  // ECI for a few of the correlations, including a zero ECI
+  ECIContainer eci = make_eci({0, 3, 17, 40, 74}, {-1.5, 0.25, 0.0, 0.125, -0.0625});
+
+  ClexEvaluator clex(clexulator, eci);
+  BOOST_CHECK_EQUAL(clex.index_list().size(), 4);
+  BOOST_CHECK(!clex.fused());
+
+  // a 3 site supercell, where each site is its own unit cell
+  Clexulator::size_type N_site = 3;
+  std::vector<long int> nlist(N_site * clexulator.nlist_size());
+  for(Clexulator::size_type v = 0; v < N_site; v++) {
+    for(Clexulator::size_type n = 0; n < clexulator.nlist_size(); n++) {
+      nlist[v * clexulator.nlist_size() + n] = (v + n) % N_site;
+    }
+  }
+
+  std::vector<std::vector<int> > config_occ = {{0, 0, 0}, {1, 0, 2}, {2, 2, 1}, {0, 1, 2}};
+  Correlation corr(clexulator.corr_size(), 0.0);
+  std::vector<double> tcorr(clexulator.corr_size());
+  for(const auto &occ : config_occ) {
+    std::fill(corr.begin(), corr.end(), 0.0);
+    clexulator.set_config_occ(occ.data());
+    for(Clexulator::size_type v = 0; v < N_site; v++) {
+      clexulator.set_nlist(nlist.data() + v * clexulator.nlist_size());
+      clexulator.calc_global_corr_contribution(tcorr.data());
+      for(Clexulator::size_type i = 0; i < corr.size(); i++) {
+        corr[i] += tcorr[i] / N_site;
+      }
+    }
+    double check = eci * corr;
+    BOOST_CHECK_CLOSE(clex(occ.data(), nlist.data(), N_site) + 1.0, check + 1.0, 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FusedECITest) {
+  namespace fs = boost::filesystem;
+
+  // FCC, ternary
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  prim.fill_occupant_bases('c');
+
+  SiteOrbitree tree(prim.lattice());
+  tree.min_num_components = 2;
+  tree.min_length = CASM::TOL;
+  tree.max_length.push_back(0.0);
+  tree.max_length.push_back(0.0);
+  tree.max_length.push_back(6.0);
+  tree.max_length.push_back(4.5);
+  tree.max_num_sites = tree.max_length.size() - 1;
+  tree.generate_orbitree(prim);
+  tree.collect_basis_info(prim);
+  tree.generate_clust_bases();
+
+  Array<UnitCellCoord> prim_nlist;
+  expand_nlist(prim, tree, prim_nlist);
+
+  // every third basis function, with some zero ECI
+  std::vector<ECIContainer::size_type> eci_index;
+  std::vector<double> eci_value;
+  for(ECIContainer::size_type i = 0; i < tree.basis_set_size(); i += 3) {
+    eci_index.push_back(i);
+    eci_value.push_back(i % 2 ? 0.0 : 1.0 / (i + 3.0));
+  }
+  ECIContainer eci = make_eci(eci_index, eci_value);
+
+  // print and compile the Clexulator with the ECI folded in
+  fs::path dir = fs::temp_directory_path() / fs::unique_path("casm_clexulator_%%%%-%%%%");
+  fs::create_directory(dir);
+  {
+    fs::ofstream outfile(dir / "fused_Clexulator.cc");
+    print_clexulator(prim, tree, prim_nlist, "fused_Clexulator", eci, outfile);
+  }
+  Clexulator clexulator("fused_Clexulator",
+                        dir,
+                        RuntimeLibrary::default_compile_options() + " --std=c++11 -I" + fs::absolute("include").string(),
+                        RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+  BOOST_CHECK_EQUAL(clexulator.corr_size(), tree.basis_set_size());
+  BOOST_CHECK_EQUAL(clexulator.folded_eci_size(), (eci_index.size() + 1) / 2);
+
+  // an arbitrary neighbor list is fine for comparing the fused kernels with the correlations
+  Clexulator::size_type N_site = 11;
+  std::vector<long int> nlist(N_site * clexulator.nlist_size());
+  for(Clexulator::size_type v = 0; v < N_site; v++) {
+    for(Clexulator::size_type n = 0; n < clexulator.nlist_size(); n++) {
+      nlist[v * clexulator.nlist_size() + n] = (7 * v + 3 * n) % N_site;
+    }
+  }
+  std::vector<int> occ = {0, 1, 2, 2, 0, 1, 1, 0, 2, 0, 1};
+
+  Correlation corr(clexulator.corr_size(), 0.0);
+  double value = 0.0;
+  clexulator.set_config_occ(occ.data());
+  for(Clexulator::size_type v = 0; v < N_site; v++) {
+    clexulator.set_nlist(nlist.data() + v * clexulator.nlist_size());
+
+    clexulator.calc_global_corr_contribution(corr.begin());
+    double check = eci * corr;
+    value += check / N_site;
+    BOOST_CHECK_CLOSE(clexulator.calc_global_energy_contribution() + 1.0, check + 1.0, 1e-8);
+
+    int occ_i = occ[nlist[v * clexulator.nlist_size()]];
+    for(int occ_f = 0; occ_f < 3; occ_f++) {
+      clexulator.calc_delta_point_corr(0, occ_i, occ_f, corr.begin());
+      check = eci * corr;
+      BOOST_CHECK_CLOSE(clexulator.calc_delta_point_energy(0, occ_i, occ_f) + 1.0, check + 1.0, 1e-8);
+    }
+  }
+
+  ClexEvaluator clex(clexulator, eci);
+  BOOST_CHECK(clex.fused());
+  BOOST_CHECK_CLOSE(clex(occ.data(), nlist.data(), N_site) + 1.0, value + 1.0, 1e-8);
+
+  // with different ECI the fused kernel is not used
+  eci_value[0] += 1.0;
+  ECIContainer other_eci = make_eci(eci_index, eci_value);
+  ClexEvaluator other_clex(clexulator, other_eci);
+  BOOST_CHECK(!other_clex.fused());
+  BOOST_CHECK_CLOSE(other_clex(occ.data(), nlist.data(), N_site) + 1.0, value + 2.0, 1e-8);
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
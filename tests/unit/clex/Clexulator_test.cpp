@@ -5,9 +5,12 @@
 #include "casm/clex/Clexulator.hh"
 
 /// Dependencies
+#include "casm/clex/PrimClex.hh"
 
 /// What is being used to test it:
+#include <vector>
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 using namespace CASM;
 
@@ -25,4 +28,129 @@ BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
 
 }
 
+BOOST_AUTO_TEST_CASE(BatchCorrTest) {
+
+  Clexulator clexulator("test_Clexulator",
+                        "tests/unit/clex",
+                        RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
+                        RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+  // a 3 site supercell, where each site is its own unit cell
+  Clexulator::size_type N_site = 3, N_config = 4;
+  std::vector<long int> nlist(N_site * clexulator.nlist_size());
+  for(Clexulator::size_type v = 0; v < N_site; v++) {
+    for(Clexulator::size_type n = 0; n < clexulator.nlist_size(); n++) {
+      nlist[v * clexulator.nlist_size() + n] = (v + n) % N_site;
+    }
+  }
+
+  std::vector<std::vector<int> > config_occ = {{0, 0, 0}, {1, 0, 2}, {2, 2, 1}, {0, 1, 2}};
+  std::vector<int> occ(N_site * N_config);
+  for(Clexulator::size_type k = 0; k < N_config; k++) {
+    for(Clexulator::size_type l = 0; l < N_site; l++) {
+      occ[l * N_config + k] = config_occ[k][l];
+    }
+  }
+
+  std::vector<double> batch_corr(N_config * clexulator.corr_size());
+  clexulator.calc_global_corr_batch(occ.data(), N_config, N_site, nlist.data(), N_site, batch_corr.data());
+
+  std::vector<double> corr(clexulator.corr_size()), tcorr(clexulator.corr_size());
+  for(Clexulator::size_type k = 0; k < N_config; k++) {
+    std::fill(corr.begin(), corr.end(), 0.0);
+    clexulator.set_config_occ(config_occ[k].data());
+    for(Clexulator::size_type v = 0; v < N_site; v++) {
+      clexulator.set_nlist(nlist.data() + v * clexulator.nlist_size());
+      clexulator.calc_global_corr_contribution(tcorr.data());
+      for(Clexulator::size_type i = 0; i < corr.size(); i++) {
+        corr[i] += tcorr[i];
+      }
+    }
+    for(Clexulator::size_type i = 0; i < corr.size(); i++) {
+      BOOST_CHECK_CLOSE(batch_corr[k * clexulator.corr_size() + i] + 1.0, corr[i] / N_site + 1.0, 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PrintedBatchCorrTest) {
+  namespace fs = boost::filesystem;
+
+  // FCC, ternary
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  prim.fill_occupant_bases('c');
+
+  SiteOrbitree tree(prim.lattice());
+  tree.min_num_components = 2;
+  tree.min_length = CASM::TOL;
+  tree.max_length.push_back(0.0);
+  tree.max_length.push_back(0.0);
+  tree.max_length.push_back(6.0);
+  tree.max_length.push_back(4.5);
+  tree.max_num_sites = tree.max_length.size() - 1;
+  tree.generate_orbitree(prim);
+  tree.collect_basis_info(prim);
+  tree.generate_clust_bases();
+
+  Array<UnitCellCoord> prim_nlist;
+  expand_nlist(prim, tree, prim_nlist);
+
+  // print and compile a Clexulator, which has the eval_batch_bfunc_* kernels
+  fs::path dir = fs::temp_directory_path() / fs::unique_path("casm_clexulator_%%%%-%%%%");
+  fs::create_directory(dir);
+  {
+    fs::ofstream outfile(dir / "batch_Clexulator.cc");
+    print_clexulator(prim, tree, prim_nlist, "batch_Clexulator", outfile);
+  }
+  Clexulator clexulator("batch_Clexulator",
+                        dir,
+                        RuntimeLibrary::default_compile_options() + " --std=c++11 -I" + fs::absolute("include").string(),
+                        RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+  BOOST_CHECK_EQUAL(clexulator.corr_size(), tree.basis_set_size());
+
+  // an arbitrary neighbor list is fine for comparing the batch kernels with the correlations
+  Clexulator::size_type N_site = 11, N_config = 5;
+  std::vector<long int> nlist(N_site * clexulator.nlist_size());
+  for(Clexulator::size_type v = 0; v < N_site; v++) {
+    for(Clexulator::size_type n = 0; n < clexulator.nlist_size(); n++) {
+      nlist[v * clexulator.nlist_size() + n] = (7 * v + 3 * n) % N_site;
+    }
+  }
+
+  std::vector<std::vector<int> > config_occ;
+  for(Clexulator::size_type k = 0; k < N_config; k++) {
+    config_occ.push_back(std::vector<int>(N_site));
+    for(Clexulator::size_type l = 0; l < N_site; l++) {
+      config_occ[k][l] = (l * l + 2 * k * l + k) % 3;
+    }
+  }
+  std::vector<int> occ(N_site * N_config);
+  for(Clexulator::size_type k = 0; k < N_config; k++) {
+    for(Clexulator::size_type l = 0; l < N_site; l++) {
+      occ[l * N_config + k] = config_occ[k][l];
+    }
+  }
+
+  std::vector<double> batch_corr(N_config * clexulator.corr_size());
+  clexulator.calc_global_corr_batch(occ.data(), N_config, N_site, nlist.data(), N_site, batch_corr.data());
+
+  std::vector<double> corr(clexulator.corr_size()), tcorr(clexulator.corr_size());
+  for(Clexulator::size_type k = 0; k < N_config; k++) {
+    std::fill(corr.begin(), corr.end(), 0.0);
+    clexulator.set_config_occ(config_occ[k].data());
+    for(Clexulator::size_type v = 0; v < N_site; v++) {
+      clexulator.set_nlist(nlist.data() + v * clexulator.nlist_size());
+      clexulator.calc_global_corr_contribution(tcorr.data());
+      for(Clexulator::size_type i = 0; i < corr.size(); i++) {
+        corr[i] += tcorr[i];
+      }
+    }
+    for(Clexulator::size_type i = 0; i < corr.size(); i++) {
+      BOOST_CHECK_CLOSE(batch_corr[k * clexulator.corr_size() + i] + 1.0, corr[i] / N_site + 1.0, 1e-8);
+    }
+  }
+
+  fs::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
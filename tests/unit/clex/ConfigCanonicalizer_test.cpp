@@ -0,0 +1,100 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigCanonicalizer.hh"
+
+/// What is being used to test it:
+#include <random>
+#include "casm/clex/PrimClex.hh"
+#include "casm/system/TaskScheduler.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ConfigCanonicalizerTest)
+
+BOOST_AUTO_TEST_CASE(CompareTest) {
+
+  // FCC, with occupants A B C
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  // volume 4 supercell, with 4 translations and 48 factor group operations
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 2) = 1;
+  Supercell scel(&primclex, transf_mat);
+
+  const ConfigCanonicalizer &canonicalizer = scel.canonicalizer();
+  BOOST_CHECK_EQUAL(canonicalizer.size(), scel.num_sites());
+
+  std::mt19937 rng(0);
+  std::vector<ConfigDoF> dof;
+  for(Index n = 0; n < 200; n++) {
+    Array<int> occ(scel.num_sites());
+    for(Index i = 0; i < occ.size(); i++) {
+      occ[i] = rng() % 3;
+    }
+    dof.push_back(ConfigDoF(scel.num_sites()));
+    dof.back().set_occupation(occ);
+  }
+
+  std::vector<const ConfigDoF *> dof_ptr;
+  for(Index n = 0; n < dof.size(); n++) {
+    dof_ptr.push_back(&dof[n]);
+  }
+  TaskScheduler scheduler(2);
+  std::vector<bool> batch = canonicalizer.is_canonical(dof_ptr, scheduler);
+
+  // same results as ConfigDoF, including the permutation that gives the canonical form
+  for(Index n = 0; n < dof.size(); n++) {
+    PermuteIterator it_canon, check_it_canon;
+    Array<PermuteIterator> fg, check_fg;
+
+    ConfigDoF canon = canonicalizer.canonical_form(dof[n], it_canon, fg);
+    ConfigDoF check_canon = dof[n].canonical_form(scel.permute_begin(), scel.permute_end(), check_it_canon, check_fg);
+    BOOST_CHECK(canon.occupation() == check_canon.occupation());
+    BOOST_CHECK_EQUAL(it_canon.factor_group_index(), check_it_canon.factor_group_index());
+    BOOST_CHECK_EQUAL(it_canon.translation_index(), check_it_canon.translation_index());
+    BOOST_CHECK_EQUAL(fg.size(), check_fg.size());
+
+    bool check = dof[n].is_canonical(scel.permute_begin(), scel.permute_end());
+    BOOST_CHECK_EQUAL(canonicalizer.is_canonical(dof[n]), check);
+    BOOST_CHECK_EQUAL(batch[n], check);
+    BOOST_CHECK(canonicalizer.is_canonical(canon));
+    BOOST_CHECK_EQUAL(canonicalizer.is_primitive(dof[n]), dof[n].is_primitive(scel.permute_begin()));
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentFirstUse) {
+
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 2) = 2;
+  Supercell scel(&primclex, transf_mat);
+
+  // threads that use the canonicalizer at once all get the one that was constructed
+  TaskScheduler scheduler(4);
+  std::vector<const ConfigCanonicalizer *> used(16, nullptr);
+  scheduler.parallel_for(0, used.size(), [&](Index begin, Index end) {
+    for(Index i = begin; i < end; i++) {
+      used[i] = &scel.canonicalizer();
+    }
+  });
+  for(Index i = 0; i < used.size(); i++) {
+    BOOST_CHECK(used[i] == &scel.canonicalizer());
+  }
+
+  // copies construct their own
+  Supercell copy(scel);
+  BOOST_CHECK(&copy.canonicalizer() != &scel.canonicalizer());
+  BOOST_CHECK_EQUAL(copy.canonicalizer().size(), scel.num_sites());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
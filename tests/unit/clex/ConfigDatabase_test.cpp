@@ -0,0 +1,137 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigDatabase.hh"
+
+/// What is being used to test it:
+#include "casm/clex/PrimClex.hh"
+
+using namespace CASM;
+
+/// Check that 'db' contains configurations equal to 'expected', in order
+void check_configs(const ConfigDatabase &db, Supercell &scel, const std::vector<Configuration> &expected) {
+
+  BOOST_CHECK_EQUAL(db.size(scel.get_name()), expected.size());
+  for(Index i = 0; i < expected.size(); i++) {
+    Configuration config = db.configuration(scel, i);
+    BOOST_CHECK_EQUAL(config.get_id(), expected[i].get_id());
+    BOOST_CHECK(config.occupation() == expected[i].occupation());
+    BOOST_CHECK_EQUAL(config.selected(), expected[i].selected());
+    BOOST_CHECK_EQUAL(config.has_displacement(), expected[i].has_displacement());
+    if(config.has_displacement() && expected[i].has_displacement()) {
+      BOOST_CHECK(config.displacement().isApprox(expected[i].displacement()));
+    }
+    BOOST_CHECK(config.deformation().isApprox(expected[i].deformation()));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigDatabaseTest)
+
+BOOST_AUTO_TEST_CASE(ReadWriteTest) {
+
+  fs::path dir("tests/unit/clex/ConfigDatabase_test_dir");
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  fs::path db_path = dir / "config_list.bin";
+  fs::path journal_path = dir / "config_list.journal";
+
+  // FCC, with occupants A B C
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 2) = 1;
+  Supercell scel(&primclex, transf_mat);
+
+  std::vector<Configuration> expected;
+  for(Index i = 0; i < 3; i++) {
+    Array<int> occ(scel.num_sites(), 0);
+    occ[0] = i;
+    occ[1] = (i + 1) % 3;
+    Configuration config(scel);
+    config.set_occupation(occ);
+    config.set_id(i);
+    config.set_selected(i == 1);
+    expected.push_back(config);
+  }
+
+  // no base file yet, so commit writes one and no journal
+  {
+    ConfigDatabase db(db_path, journal_path);
+    BOOST_CHECK_EQUAL(db.size(scel.get_name()), 0);
+    for(const Configuration &config : expected) {
+      db.insert(config);
+    }
+    db.commit();
+  }
+  BOOST_CHECK(fs::exists(db_path));
+  BOOST_CHECK(!fs::exists(journal_path));
+
+  // unchanged configurations are not written again
+  {
+    ConfigDatabase db(db_path, journal_path);
+    check_configs(db, scel, expected);
+    for(Index i = 0; i < expected.size(); i++) {
+      db.insert(db.configuration(scel, i));
+    }
+    db.commit();
+  }
+  BOOST_CHECK(!fs::exists(journal_path));
+
+  // change occupation, selection and, for configuration 2, only displacement and deformation
+  {
+    ConfigDatabase db(db_path, journal_path);
+
+    Configuration config0 = db.configuration(scel, 0);
+    config0.set_occ(2, 2);
+    config0.set_selected(true);
+
+    Configuration config2 = db.configuration(scel, 2);
+    Configuration::displacement_matrix_t disp = Configuration::displacement_matrix_t::Zero(3, scel.num_sites());
+    disp(0, 1) = 0.1;
+    disp(2, 3) = -0.05;
+    config2.set_displacement(disp);
+    Eigen::Matrix3d deformation = Eigen::Matrix3d::Identity();
+    deformation(0, 1) = 0.01;
+    config2.set_deformation(deformation);
+
+    // and add a new configuration
+    Array<int> occ(scel.num_sites(), 1);
+    Configuration config3(scel);
+    config3.set_occupation(occ);
+    config3.set_id(3);
+
+    expected[0] = config0;
+    expected[2] = config2;
+    expected.push_back(config3);
+
+    db.insert(config0);
+    db.insert(db.configuration(scel, 1));
+    db.insert(config2);
+    db.insert(config3);
+    db.commit();
+    check_configs(db, scel, expected);
+  }
+  BOOST_CHECK(fs::exists(journal_path));
+
+  // replay the journal, then compact
+  {
+    ConfigDatabase db(db_path, journal_path);
+    check_configs(db, scel, expected);
+    db.compact();
+    check_configs(db, scel, expected);
+  }
+  BOOST_CHECK(!fs::exists(journal_path));
+
+  {
+    ConfigDatabase db(db_path, journal_path);
+    check_configs(db, scel, expected);
+  }
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
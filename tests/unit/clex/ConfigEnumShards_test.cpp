@@ -0,0 +1,57 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigEnumShards.hh"
+
+/// What is being used to test it:
+#include "casm/clex/PrimClex.hh"
+#include "casm/system/TaskScheduler.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ConfigEnumShardsTest)
+
+BOOST_AUTO_TEST_CASE(CompareTest) {
+
+  // FCC, with occupants A B C
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 2) = 1;
+  Supercell scel(&primclex, transf_mat);
+  Supercell check_scel(&primclex, transf_mat);
+  check_scel.enumerate_all_occupation_configurations();
+
+  fs::path dir("tests/unit/clex/ConfigEnumShards_test_dir");
+  fs::remove_all(dir);
+
+  // enumerate half of the shards, then resume with all of them
+  TaskScheduler scheduler(2);
+  {
+    ConfigEnumShards shards(scel, dir, 5);
+    BOOST_CHECK_EQUAL(shards.size(), 9);
+    shards.enumerate(scheduler, 0, 2);
+    BOOST_CHECK_EQUAL(shards.num_complete(), 5);
+  }
+
+  ConfigEnumShards shards(scel, dir, 5);
+  BOOST_CHECK_EQUAL(shards.num_complete(), 5);
+  shards.enumerate(scheduler);
+  BOOST_CHECK(shards.complete());
+  BOOST_CHECK_EQUAL(shards.num_configs(), check_scel.get_config_list().size());
+
+  // same configurations, in the same order
+  shards.merge();
+  BOOST_CHECK_EQUAL(scel.get_config_list().size(), check_scel.get_config_list().size());
+  for(Index i = 0; i < scel.get_config_list().size(); i++) {
+    BOOST_CHECK(scel.get_config(i).occupation() == check_scel.get_config(i).occupation());
+  }
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// Dependencies
+#include "casm/CASM_classes.hh"
+
+/// What is being tested:
+#include "casm/clex/ConfigMapping.hh"
+
+/// What is being used to test it:
+#include <random>
+#include <sstream>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ConfigMappingTest)
+
+BOOST_AUTO_TEST_CASE(DisplacedSupercell) {
+
+  // FCC, with occupants A B C
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 4;
+  transf_mat(1, 1) = 4;
+  transf_mat(2, 2) = 4;
+  Supercell scel(&primclex, transf_mat);
+  Index N = scel.num_sites();
+
+  // random occupation and displacements, and the atoms in random order
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> unif(-0.2, 0.2);
+  Structure superstruc = scel.superstructure();
+  Array<int> occ(N);
+  Eigen::MatrixXd disp(3, N);
+  for(Index i = 0; i < N; i++) {
+    occ[i] = gen() % 3;
+    superstruc.basis[i].set_occ_value(occ[i]);
+    for(Index k = 0; k < 3; k++) {
+      disp(k, i) = unif(gen);
+    }
+  }
+  disp.colwise() -= Eigen::Vector3d(disp.rowwise().mean());
+  for(Index i = 0; i < N; i++) {
+    superstruc.basis[i](CART) += Vector3<double>(disp(0, i), disp(1, i), disp(2, i));
+  }
+
+  BasicStructure<Site> rstruc(superstruc);
+  std::vector<Index> order(N);
+  for(Index i = 0; i < N; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin() + 1, order.end(), gen);
+  for(Index i = 0; i < N; i++) {
+    rstruc.basis[i] = superstruc.basis[order[i]];
+  }
+
+  ConfigDoF dof;
+  BOOST_CHECK(struc_to_configdof(scel, rstruc, dof, true, TOL));
+  BOOST_CHECK(dof.occupation() == occ);
+  for(Index i = 0; i < N; i++) {
+    BOOST_CHECK_SMALL((dof.disp(i) - disp.col(i)).norm(), 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Vacancies) {
+
+  // FCC, with occupants A Va
+  std::istringstream prim_stream("FCC\n1.0\n0 2.0 2.0\n2.0 0 2.0\n2.0 2.0 0\n1\nD\n0.00 0.00 0.00 A Va\n");
+  Structure prim;
+  prim.read(prim_stream);
+  PrimClex primclex(prim);
+
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 3;
+  transf_mat(1, 1) = 3;
+  transf_mat(2, 2) = 3;
+  Supercell scel(&primclex, transf_mat);
+  Index N = scel.num_sites();
+
+  // remove every 5th atom, and displace the rest
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> unif(-0.1, 0.1);
+  Structure superstruc = scel.superstructure();
+  BasicStructure<Site> rstruc(superstruc);
+  rstruc.basis.clear();
+  Array<int> occ(N);
+  for(Index i = 0; i < N; i++) {
+    occ[i] = (i % 5 == 1) ? 1 : 0;
+    if(occ[i] == 0) {
+      Site site(superstruc.basis[i]);
+      site.set_occ_value(0);
+      site(CART) += Vector3<double>(unif(gen), unif(gen), unif(gen));
+      rstruc.basis.push_back(site);
+    }
+  }
+
+  ConfigDoF dof;
+  BOOST_CHECK(struc_to_configdof(scel, rstruc, dof, true, TOL));
+  BOOST_CHECK(dof.occupation() == occ);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clusterography/Orbitree.hh"
+
+/// What is being used to test it:
+#include "casm/clex/PrimClex.hh"
+#include "casm/system/TaskScheduler.hh"
+
+using namespace CASM;
+
+/// Check that generate_orbitree gives the same orbitree with and without a TaskScheduler
+void check_generate_orbitree(const Structure &prim, const Array<double> &max_length) {
+
+  SiteOrbitree expected(prim.lattice()), result(prim.lattice());
+  for(SiteOrbitree *tree : {&expected, &result}) {
+    tree->min_num_components = 2;
+    tree->min_length = CASM::TOL;
+    tree->max_length = max_length;
+    tree->max_num_sites = max_length.size() - 1;
+  }
+
+  expected.generate_orbitree(prim);
+
+  TaskScheduler scheduler(4);
+  result.generate_orbitree(prim, scheduler);
+
+  BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+  for(Index np = 0; np < expected.size(); np++) {
+    BOOST_REQUIRE_EQUAL(result.size(np), expected.size(np));
+    for(Index no = 0; no < expected.size(np); no++) {
+      BOOST_REQUIRE_EQUAL(result.size(np, no), expected.size(np, no));
+      BOOST_CHECK(result.prototype(np, no) == expected.prototype(np, no));
+      for(Index ne = 0; ne < expected.size(np, no); ne++) {
+        BOOST_CHECK(result.equiv(np, no, ne) == expected.equiv(np, no, ne));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(OrbitreeTest)
+
+BOOST_AUTO_TEST_CASE(GenerateOrbitreeTest) {
+
+  // FCC, one basis site
+  Structure prim1(fs::path("tests/unit/crystallography/PRIM1"));
+  Array<double> max_length1;
+  max_length1.push_back(0.0);
+  max_length1.push_back(0.0);
+  max_length1.push_back(6.0);
+  max_length1.push_back(4.5);
+  max_length1.push_back(3.0);
+  check_generate_orbitree(prim1, max_length1);
+
+  // FCC, with four basis sites
+  Structure prim2(fs::path("tests/unit/crystallography/PRIM2"));
+  Array<double> max_length2;
+  max_length2.push_back(0.0);
+  max_length2.push_back(0.0);
+  max_length2.push_back(5.0);
+  max_length2.push_back(4.0);
+  check_generate_orbitree(prim2, max_length2);
+
+  // triclinic, with three basis sites, so that only the identity maps clusters onto each other
+  Structure prim3(fs::path("tests/unit/crystallography/PRIM3"));
+  Array<double> max_length3;
+  max_length3.push_back(0.0);
+  max_length3.push_back(0.0);
+  max_length3.push_back(6.0);
+  max_length3.push_back(4.5);
+  max_length3.push_back(3.5);
+  check_generate_orbitree(prim3, max_length3);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
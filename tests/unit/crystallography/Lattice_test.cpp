@@ -0,0 +1,97 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/Lattice.hh"
+
+/// What is being used to test it:
+#include "casm/symmetry/SymGroup.hh"
+
+using namespace CASM;
+
+/// Point group of 'lat', checking all 3^9 matrices with elements equal to -1, 0, or 1,
+/// as Lattice::generate_point_group did before candidates were pruned
+SymGroup exhaustive_point_group(const Lattice &lat, double pg_tol) {
+
+  Lattice tlat_reduced(lat.get_reduced_cell());
+  const Matrix3<double> &L = tlat_reduced.lat_column_mat();
+  const Matrix3<double> &L_inv = tlat_reduced.inv_lat_column_mat();
+
+  SymGroup point_group;
+  Matrix3<double> pg_op;
+  for(int n = 0; n < 19683; n++) {
+    int digits = n;
+    for(int i = 0; i < 9; i++) {
+      pg_op[i] = digits % 3 - 1;
+      digits /= 3;
+    }
+    if(std::abs(std::abs(pg_op.determinant()) - 1.0) > 1e-8) {
+      continue;
+    }
+
+    Matrix3<double> tOp_cart = (L * pg_op) * L_inv;
+    Matrix3<double> tMat = tOp_cart.transpose() * (L * pg_op);
+    tMat = (tMat - L) / 2.0;
+    tMat = tMat * tMat.transpose();
+    if(tMat(0, 0) < pg_tol * pg_tol && tMat(1, 1) < pg_tol * pg_tol && tMat(2, 2) < pg_tol * pg_tol) {
+      double max_diag = std::max(tMat(0, 0), std::max(tMat(1, 1), tMat(2, 2)));
+      point_group.push_back(SymOp(tOp_cart, lat, CART, sqrt(max_diag)));
+    }
+  }
+
+  if(!point_group.is_group(pg_tol)) {
+    point_group.enforce_group(pg_tol);
+  }
+  return point_group;
+}
+
+/// Check that generate_point_group finds the same operations as exhaustive_point_group
+void check_point_group(const Lattice &lat, double pg_tol, Index expected_size) {
+
+  SymGroup check = exhaustive_point_group(lat, pg_tol);
+  SymGroup point_group;
+  lat.generate_point_group(point_group, pg_tol);
+
+  BOOST_CHECK_EQUAL(check.size(), expected_size);
+  BOOST_CHECK_EQUAL(point_group.size(), check.size());
+  for(Index i = 0; i < check.size(); i++) {
+    bool found = false;
+    for(Index j = 0; j < point_group.size() && !found; j++) {
+      found = (point_group[j].get_matrix(CART) - check[i].get_matrix(CART)).is_zero(1e-8);
+    }
+    BOOST_CHECK_MESSAGE(found, "point group operation " << i << " of the exhaustive search was not found");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(LatticeTest)
+
+BOOST_AUTO_TEST_CASE(PointGroupTest) {
+
+  // cubic, fcc, bcc
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.0, 0.0), Vector3<double>(0.0, 0.0, 3.0)), TOL, 48);
+  check_point_group(Lattice(Vector3<double>(0.0, 2.0, 2.0), Vector3<double>(2.0, 0.0, 2.0), Vector3<double>(2.0, 2.0, 0.0)), TOL, 48);
+  check_point_group(Lattice(Vector3<double>(-1.5, 1.5, 1.5), Vector3<double>(1.5, -1.5, 1.5), Vector3<double>(1.5, 1.5, -1.5)), TOL, 48);
+
+  // hexagonal, and hexagonal with c == a, so all lattice vectors have the same length
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(-1.5, 1.5 * sqrt(3.0), 0.0), Vector3<double>(0.0, 0.0, 5.0)), TOL, 24);
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(-1.5, 1.5 * sqrt(3.0), 0.0), Vector3<double>(0.0, 0.0, 3.0)), TOL, 24);
+
+  // tetragonal, orthorhombic, monoclinic, triclinic
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.0, 0.0), Vector3<double>(0.0, 0.0, 4.0)), TOL, 16);
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.5, 0.0), Vector3<double>(0.0, 0.0, 4.0)), TOL, 8);
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.5, 0.0), Vector3<double>(1.0, 0.0, 4.0)), TOL, 4);
+  check_point_group(Lattice(Vector3<double>(3.0, 0.1, 0.2), Vector3<double>(0.3, 3.5, 0.0), Vector3<double>(1.0, 0.4, 4.0)), TOL, 2);
+
+  // a skewed, non-reduced cell of the cubic lattice
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(3.0, 3.0, 0.0), Vector3<double>(-3.0, 3.0, 3.0)), TOL, 48);
+
+  // cubic, distorted by less than the tolerance, and by more than the tolerance
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.0 + 0.2 * TOL, 0.0), Vector3<double>(0.3 * TOL, 0.0, 3.0)), TOL, 48);
+  check_point_group(Lattice(Vector3<double>(3.0, 0.0, 0.0), Vector3<double>(0.0, 3.0, 0.0), Vector3<double>(0.0, 0.0, 3.0 + 3.0 * TOL)), TOL, 16);
+
+  // fcc distorted near the tolerance, with a larger tolerance
+  check_point_group(Lattice(Vector3<double>(0.0, 2.0, 2.0), Vector3<double>(2.0, 0.0, 2.0), Vector3<double>(2.0, 2.0, 0.01)), 0.02, 48);
+  check_point_group(Lattice(Vector3<double>(0.0, 2.0, 2.0), Vector3<double>(2.0, 0.0, 2.0), Vector3<double>(2.0, 2.0, 0.01)), 0.001, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
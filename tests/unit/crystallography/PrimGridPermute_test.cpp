@@ -0,0 +1,72 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/PrimGridPermute.hh"
+
+/// What is being used to test it:
+#include "casm/clex/PrimClex.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(PrimGridPermuteTest)
+
+BOOST_AUTO_TEST_CASE(CompareTest) {
+
+  // FCC with one basis site, and conventional FCC with four
+  Array<std::string> prim_names;
+  prim_names.push_back("PRIM1");
+  prim_names.push_back("PRIM2");
+
+  Array<Matrix3<int> > transf_mats;
+  Matrix3<int> transf_mat(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 2) = 1;
+  transf_mats.push_back(transf_mat);
+
+  // non-diagonal, with Smith normal form U != identity
+  transf_mat = Matrix3<int>(0);
+  transf_mat(0, 0) = 2;
+  transf_mat(1, 0) = 1;
+  transf_mat(1, 1) = 2;
+  transf_mat(2, 0) = -1;
+  transf_mat(2, 2) = 3;
+  transf_mats.push_back(transf_mat);
+
+  for(Index n = 0; n < prim_names.size(); n++) {
+    Structure prim(fs::path("tests/unit/crystallography") / prim_names[n]);
+    PrimClex primclex(prim);
+
+    for(Index m = 0; m < transf_mats.size(); m++) {
+      Supercell scel(&primclex, transf_mats[m]);
+      const PrimGridPermute &grid_permute = scel.grid_permute();
+      BOOST_CHECK_EQUAL(grid_permute.size(), scel.num_sites());
+
+      // same as the stored permutation representation and translation permutations
+      std::vector<Index> block(scel.num_sites());
+      Array<int> before(scel.num_sites()), after(scel.num_sites());
+      for(Index i = 0; i < before.size(); i++) {
+        before[i] = i % 3;
+      }
+
+      for(Index f = 0; f < scel.factor_group().size(); f++) {
+        const Permutation &fg_perm = *(scel.permutation_symrep()->get_permutation(scel.factor_group()[f]));
+        for(Index t = 0; t < scel.volume(); t++) {
+          const Permutation &trans_perm = scel.prim_grid().translation_permutation(t);
+          grid_permute.permute_ind_block(f, t, 0, scel.num_sites(), block.data());
+          grid_permute.permute(f, t, before.begin(), after.begin());
+          for(Index i = 0; i < scel.num_sites(); i++) {
+            Index check = fg_perm[trans_perm[i]];
+            BOOST_CHECK_EQUAL(grid_permute.permute_ind(f, t, i), check);
+            BOOST_CHECK_EQUAL(block[i], check);
+            BOOST_CHECK_EQUAL(after[i], before[check]);
+          }
+        }
+      }
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
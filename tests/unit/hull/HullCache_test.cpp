@@ -0,0 +1,215 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// Dependencies
+#include "casm/CASM_classes.hh"
+
+/// What is being tested:
+#include "casm/hull/HullCache.hh"
+
+/// What is being used to test it:
+#include <ctime>
+#include <random>
+#include "casm/casm_io/jsonParser.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Random points with energy first, and compositions in the simplex x_i >= 0, sum(x_i) <= 1,
+  /// including its corners
+  Eigen::MatrixXd random_points(Index Ncomp, Index N, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    Eigen::MatrixXd points(Ncomp + 1, N);
+    for(Index i = 0; i < N; i++) {
+      Eigen::VectorXd x = Eigen::VectorXd::Zero(Ncomp);
+      if(i > Ncomp) {
+        for(Index j = 0; j < Ncomp; j++) {
+          x(j) = unif(gen);
+        }
+        if(x.sum() > 1.0) {
+          x /= x.sum() + unif(gen);
+        }
+      }
+      else if(i > 0) {
+        x(i - 1) = 1.0;
+      }
+      points(0, i) = -0.5 * unif(gen) + 0.3 * x.squaredNorm();
+      points.col(i).tail(Ncomp) = x;
+    }
+    return points;
+  }
+
+  std::vector<std::string> names(Index begin, Index end) {
+    std::vector<std::string> result;
+    for(Index i = begin; i < end; i++) {
+      result.push_back("config" + std::to_string(i));
+    }
+    return result;
+  }
+
+  /// Check that 'cache' is the same as a hull built from scratch
+  void check_hull(const HullCache &cache) {
+    HullCache full;
+    BOOST_REQUIRE(full.update(cache.names(), cache.points()));
+    BOOST_CHECK(cache.vertices() == full.vertices());
+    BOOST_CHECK_SMALL((cache.dist_to_hull() - full.dist_to_hull()).cwiseAbs().maxCoeff(), 1e-10);
+    BOOST_CHECK_SMALL((cache.dist_to_hull(cache.points()) - full.dist_to_hull()).cwiseAbs().maxCoeff(), 1e-10);
+    BOOST_CHECK_GE(cache.dist_to_hull().minCoeff(), -1e-10);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(HullCacheTest)
+
+BOOST_AUTO_TEST_CASE(CompareGeo) {
+  std::mt19937 gen(1);
+  for(Index Ncomp = 1; Ncomp < 4; Ncomp++) {
+    Eigen::MatrixXd points = random_points(Ncomp, 200, gen);
+    HullCache cache;
+    BOOST_REQUIRE(cache.update(names(0, 200), points));
+
+    BP::Geo geo;
+    geo.set_verbosity(0);
+    geo.reset_points(points, true);
+    BOOST_REQUIRE(geo.calc_CH());
+    Eigen::VectorXd bottom = Eigen::VectorXd::Zero(Ncomp + 1);
+    bottom(0) = -1;
+    geo.CH_bottom(bottom);
+
+    BP::BP_Vec<int> geo_verts = geo.CH_verts_indices();
+    std::vector<Index> verts;
+    for(Index i = 0; i < geo_verts.size(); i++) {
+      verts.push_back(geo_verts[i]);
+    }
+    std::sort(verts.begin(), verts.end());
+    BOOST_CHECK(cache.vertices() == verts);
+
+    for(Index i = 0; i < points.cols(); i++) {
+      BOOST_CHECK_SMALL(cache.dist_to_hull(i) - geo.CH_dist_to_hull(int(i)), 1e-10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Update) {
+  std::mt19937 gen(2);
+  for(Index Ncomp = 1; Ncomp < 4; Ncomp++) {
+    Eigen::MatrixXd points = random_points(Ncomp, 400, gen);
+
+    HullCache cache;
+    BOOST_REQUIRE(cache.update(names(0, 200), points.leftCols(200)));
+    BOOST_CHECK(cache.rebuilt());
+    check_hull(cache);
+
+    // no change
+    BOOST_REQUIRE(cache.update(names(0, 200), points.leftCols(200)));
+    BOOST_CHECK(!cache.changed());
+    BOOST_CHECK(!cache.rebuilt());
+
+    // insert points above the hull
+    Eigen::MatrixXd above = points.leftCols(250);
+    above.row(0).tail(50).array() += 1.0;
+    BOOST_REQUIRE(cache.update(names(0, 250), above));
+    BOOST_CHECK(cache.changed());
+    BOOST_CHECK(!cache.rebuilt());
+    check_hull(cache);
+
+    // insert points that may be below the hull, rebuilt from a subset
+    BOOST_REQUIRE(cache.update(names(0, 400), points));
+    BOOST_CHECK(cache.rebuilt());
+    BOOST_CHECK_LT(cache.rebuild_size(), 400);
+    check_hull(cache);
+
+    // remove points that are not vertices, in a different order
+    std::vector<std::string> keep_names;
+    std::vector<Index> keep;
+    for(Index i = points.cols() - 1; i >= 0; i--) {
+      if(cache.is_vertex(i) || i % 3) {
+        keep_names.push_back(cache.names()[i]);
+        keep.push_back(i);
+      }
+    }
+    Eigen::MatrixXd kept(points.rows(), keep.size());
+    for(Index k = 0; k < keep.size(); k++) {
+      kept.col(k) = points.col(keep[k]);
+    }
+    BOOST_REQUIRE(cache.update(keep_names, kept));
+    BOOST_CHECK(!cache.rebuilt());
+    check_hull(cache);
+
+    // lower a vertex, rebuilt from a subset
+    Index v = cache.vertices()[Ncomp + 1 < cache.vertices().size() ? Ncomp + 1 : 0];
+    kept(0, v) -= 0.05;
+    BOOST_REQUIRE(cache.update(keep_names, kept));
+    BOOST_CHECK(cache.rebuilt());
+    BOOST_CHECK_LT(cache.rebuild_size(), kept.cols());
+    BOOST_CHECK(cache.is_vertex(v));
+    check_hull(cache);
+
+    // raise a vertex, rebuilt from all points
+    kept(0, v) += 0.15;
+    BOOST_REQUIRE(cache.update(keep_names, kept));
+    BOOST_CHECK(cache.rebuilt());
+    BOOST_CHECK_GE(cache.rebuild_size(), kept.cols());
+    check_hull(cache);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(JsonRoundTrip) {
+  std::mt19937 gen(3);
+  Eigen::MatrixXd points = random_points(2, 100, gen);
+
+  HullCache cache;
+  BOOST_REQUIRE(cache.update(names(0, 100), points));
+
+  jsonParser json;
+  std::stringstream ss;
+  cache.to_json(json).print(ss, 0, 17);
+
+  HullCache read_cache;
+  read_cache.from_json(jsonParser(ss));
+  BOOST_CHECK(read_cache.vertices() == cache.vertices());
+  BOOST_CHECK_SMALL((read_cache.dist_to_hull(points) - cache.dist_to_hull(points)).cwiseAbs().maxCoeff(), 1e-12);
+
+  // values are unchanged by the round trip, so nothing needs to be done
+  BOOST_REQUIRE(read_cache.update(names(0, 100), points));
+  BOOST_CHECK(!read_cache.changed());
+  BOOST_CHECK(!read_cache.rebuilt());
+
+  std::vector<Index> index;
+  BP::Geo &geo = read_cache.geo(index);
+  BOOST_CHECK_EQUAL(geo.CH_verts_size(), cache.vertices().size());
+}
+
+BOOST_AUTO_TEST_CASE(Prune) {
+  fs::path dir("tests/unit/hull/HullCache_test_dir");
+  fs::remove_all(dir);
+
+  std::mt19937 gen(4);
+  HullCache cache;
+  BOOST_REQUIRE(cache.update(names(0, 10), random_points(1, 10, gen)));
+
+  // caches written a minute apart, oldest first
+  std::time_t now = std::time(nullptr);
+  for(Index i = 0; i < 6; i++) {
+    fs::path file = dir / ("query." + stable_hash({std::to_string(i)}) + ".json");
+    cache.write(file);
+    fs::last_write_time(file, now - 60 * (6 - i));
+  }
+  fs::ofstream(dir / "other.txt") << "not a cache\n";
+
+  HullCache::prune(dir, 10);
+  BOOST_CHECK_EQUAL(std::distance(fs::directory_iterator(dir), fs::directory_iterator()), 7);
+
+  HullCache::prune(dir, 4);
+  BOOST_CHECK_EQUAL(std::distance(fs::directory_iterator(dir), fs::directory_iterator()), 5);
+  for(Index i = 0; i < 6; i++) {
+    fs::path file = dir / ("query." + stable_hash({std::to_string(i)}) + ".json");
+    BOOST_CHECK_EQUAL(fs::exists(file), i >= 2);
+  }
+  BOOST_CHECK(fs::exists(dir / "other.txt"));
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// Dependencies
+#include "casm/CASM_classes.hh"
+
+/// What is being tested:
+#include "casm/misc/SparseAssignment.hh"
+
+/// What is being used to test it:
+#include <random>
+#include "casm/misc/CASM_math.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Random cost matrix, with 'fill' of the entries set and the rest 'inf', always including the
+  /// diagonal so that an assignment is possible
+  Eigen::MatrixXd random_costs(Index N, double fill, double inf, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    Eigen::MatrixXd cost = Eigen::MatrixXd::Constant(N, N, inf);
+    for(Index i = 0; i < N; i++) {
+      for(Index j = 0; j < N; j++) {
+        if(i == j || unif(gen) < fill) {
+          cost(i, j) = unif(gen);
+        }
+      }
+    }
+    return cost;
+  }
+
+  void set_costs(const Eigen::MatrixXd &cost, double inf, SparseAssignment &assignment) {
+    assignment.reset(cost.rows());
+    for(Index i = 0; i < cost.rows(); i++) {
+      for(Index j = 0; j < cost.cols(); j++) {
+        if(cost(i, j) < inf) {
+          assignment.add(i, j, cost(i, j));
+        }
+      }
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SparseAssignmentTest)
+
+BOOST_AUTO_TEST_CASE(CompareHungarian) {
+
+  std::mt19937 gen(0);
+  double inf = 10E10;
+  SparseAssignment assignment;
+  for(Index n = 0; n < 40; n++) {
+    Index N = 1 + n % 20;
+    Eigen::MatrixXd cost = random_costs(N, n < 20 ? 1.0 : 0.3, inf, gen);
+
+    std::vector<Index> check;
+    double check_cost = hungarian_method(cost, check, 1e-8);
+
+    // solutions are unique for random costs, and warm starts from the last solution do not change them
+    set_costs(cost, inf, assignment);
+    BOOST_CHECK(assignment.solve());
+    BOOST_CHECK_CLOSE(assignment.cost(), check_cost, 1e-8);
+    BOOST_CHECK(assignment.assignment() == check);
+
+    // duals are feasible, and tight for the assigned pairs
+    for(Index i = 0; i < N; i++) {
+      for(const auto &entry : assignment.row(i)) {
+        double r = entry.second - assignment.row_dual()[i] - assignment.col_dual()[entry.first];
+        BOOST_CHECK(r > -1e-10);
+        if(entry.first == assignment.assignment()[i]) {
+          BOOST_CHECK_SMALL(r, 1e-10);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Infeasible) {
+
+  // rows 0 and 1 can only be assigned column 0
+  SparseAssignment assignment;
+  assignment.reset(3);
+  assignment.add(0, 0, 1.0);
+  assignment.add(1, 0, 2.0);
+  assignment.add(2, 1, 1.0);
+  assignment.add(2, 2, 1.0);
+  BOOST_CHECK(!assignment.solve());
+
+  // a row without costs
+  assignment.reset(2);
+  assignment.add(0, 0, 1.0);
+  BOOST_CHECK(!assignment.solve());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,4 +55,33 @@ BOOST_AUTO_TEST_CASE(FunctionTest) {
   
 }
 
+BOOST_AUTO_TEST_CASE(InterfaceVersionTest) {
+
+  std::string cc_file;
+  cc_file = std::string("extern \"C\" int forty_two() {\n") +
+            "   return 42;\n" +
+            "}\n";
+
+  std::string filename_base = "tests/unit/system/runtime_lib_version";
+
+  RuntimeLibrary lib(RuntimeLibrary::default_compile_options(), RuntimeLibrary::default_so_options(), "1");
+  lib.compile(filename_base, cc_file);
+  BOOST_CHECK(!lib.is_stale(filename_base));
+  BOOST_CHECK(!lib.compile_if_stale(filename_base));
+
+  // the same source and options, compiled against another interface, are stale
+  RuntimeLibrary other(RuntimeLibrary::default_compile_options(), RuntimeLibrary::default_so_options(), "2");
+  BOOST_CHECK(other.is_stale(filename_base));
+  BOOST_CHECK(lib.source_hash(filename_base) != other.source_hash(filename_base));
+  BOOST_CHECK(other.compile_if_stale(filename_base));
+  BOOST_CHECK(!other.is_stale(filename_base));
+  BOOST_CHECK(lib.is_stale(filename_base));
+
+  other.load(filename_base);
+  BOOST_CHECK_EQUAL(42, other.get_function<int()>("forty_two")());
+  other.close();
+  other.rm();
+
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/system/TaskScheduler.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <numeric>
+#include <stdexcept>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(TaskSchedulerTest)
+
+BOOST_AUTO_TEST_CASE(SubmitTest) {
+
+  TaskScheduler scheduler(3);
+  BOOST_CHECK_EQUAL(scheduler.size(), 3);
+
+  std::vector<std::future<Index> > result;
+  for(Index i = 0; i < 100; i++) {
+    result.push_back(scheduler.submit([ = ]() {
+      return i * i;
+    }));
+  }
+  for(Index i = 0; i < 100; i++) {
+    BOOST_CHECK_EQUAL(result[i].get(), i * i);
+  }
+
+  auto error = scheduler.submit([]() {
+    throw std::runtime_error("expected");
+  });
+  BOOST_CHECK_THROW(error.get(), std::runtime_error);
+
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForTest) {
+
+  TaskScheduler scheduler(4);
+
+  // each index visited exactly once
+  std::vector<int> count(1000, 0);
+  scheduler.parallel_for(0, count.size(), [&](Index begin, Index end) {
+    for(Index i = begin; i < end; i++) {
+      count[i]++;
+    }
+  }, 7);
+  BOOST_CHECK(std::all_of(count.begin(), count.end(), [](int c) {
+    return c == 1;
+  }));
+
+  // nested parallel_for must not deadlock
+  std::vector<Index> row_sum(20, 0);
+  scheduler.parallel_for(0, row_sum.size(), [&](Index begin, Index end) {
+    for(Index i = begin; i < end; i++) {
+      std::vector<Index> row(100, 0);
+      scheduler.parallel_for(0, row.size(), [&](Index b, Index e) {
+        for(Index j = b; j < e; j++) {
+          row[j] = i * j;
+        }
+      });
+      row_sum[i] = std::accumulate(row.begin(), row.end(), Index(0));
+    }
+  });
+  for(Index i = 0; i < row_sum.size(); i++) {
+    BOOST_CHECK_EQUAL(row_sum[i], i * 4950);
+  }
+
+  BOOST_CHECK_THROW(
+    scheduler.parallel_for(0, 100, [&](Index begin, Index end) {
+    if(begin <= 50 && 50 < end) {
+      throw std::runtime_error("expected");
+    }
+  }), std::runtime_error);
+
+}
+
+BOOST_AUTO_TEST_CASE(ParallelReduceTest) {
+
+  // floating point sums are identical for any number of threads
+  std::vector<double> value(10000);
+  for(Index i = 0; i < value.size(); i++) {
+    value[i] = 1.0 / (i + 1);
+  }
+
+  auto sum = [&](Index begin, Index end) {
+    double s = 0.0;
+    for(Index i = begin; i < end; i++) {
+      s += value[i];
+    }
+    return s;
+  };
+  auto add = [](double a, double b) {
+    return a + b;
+  };
+
+  double serial = 0.0;
+  for(Index b = 0; b < value.size(); b += 64) {
+    serial = add(serial, sum(b, std::min(b + 64, Index(value.size()))));
+  }
+
+  for(Index n = 1; n <= 4; n++) {
+    TaskScheduler scheduler(n);
+    BOOST_CHECK_EQUAL(scheduler.parallel_reduce(0, value.size(), 0.0, sum, add, 64), serial);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()